@@ -0,0 +1,116 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este programa para el ATmega328P compara el costo de formatear las
+* respuestas de la terminal con sprintf_P y con LBRY16/FORMAT. Cada
+* vuelta arma las mismas lneas que main.c ("Pos n: Base=...",
+* "P,b,b1,b2,p" y un valor con signo) con los dos mtodos, cada uno entre
+* marcadores BENCH, y espera a que salga la transmisin antes de la
+* siguiente vuelta para que el buffer lleno no entre en la medicin.
+*
+* Ciclos (simavr, secciones linea_sprintf y linea_FORMAT):
+*   avr-gcc -mmcu=atmega328p -DF_CPU=16000000UL -Os -DBENCH_ENABLE=1 \
+*       -I. -o format_bench.elf HOST/format_bench.c LBRY3/USART.c \
+*       LBRY16/FORMAT.c
+*   ./simavr_bench format_bench.elf formato
+*
+* Memoria de programa: compilar con -DBENCH_METODO=1 (solo sprintf) y
+* con -DBENCH_METODO=2 (solo FORMAT) y comparar con avr-size. La
+* diferencia de .text es lo que cuesta vfprintf en el firmware.
+************************************************************************/
+
+#ifdef HAL_HOST
+#error "format_bench.c es un programa para el AVR, no para la PC"
+#endif
+
+#include "../LBRY11/HAL.h"
+#include <stdio.h>
+#include "../LBRY3/USART.h"
+#include "../LBRY12/BENCH.h"
+#include "../LBRY16/FORMAT.h"
+
+#ifndef BENCH_METODO
+#define BENCH_METODO 0              // 0: ambos (ciclos), 1: solo sprintf, 2: solo FORMAT
+#endif
+
+// Valores que cambian en cada vuelta para que el compilador no los fije
+static volatile uint8_t base = 0;
+static volatile uint8_t brazo1 = 45;
+static volatile uint8_t brazo2 = 90;
+static volatile uint8_t pinza = 180;
+static volatile int16_t distancia = -1234;
+
+#if BENCH_METODO != 2
+static void lineasSprintf(uint8_t n) {
+	char mensaje[64];
+	
+	BENCH_BEGIN(BENCH_FMT_SPRINTF);
+	sprintf_P(mensaje, PSTR("Pos %d: Base=%d, Brazo1=%d, Brazo2=%d, Pinza=%d\r\n"),
+	n, base, brazo1, brazo2, pinza);
+	sendUSARTString(mensaje);
+	sprintf_P(mensaje, PSTR("P,%d,%d,%d,%d\r\n"), base, brazo1, brazo2, pinza);
+	sendUSARTString(mensaje);
+	sprintf_P(mensaje, PSTR("X=%d\r\n"), distancia);
+	sendUSARTString(mensaje);
+	BENCH_END(BENCH_FMT_SPRINTF);
+}
+#endif
+
+#if BENCH_METODO != 1
+static void lineasFormat(uint8_t n) {
+	BENCH_BEGIN(BENCH_FMT_FORMAT);
+	sendUSARTString_P(PSTR("Pos "));
+	FMT_sendUnsigned(n);
+	sendUSARTString_P(PSTR(": Base="));
+	FMT_sendUnsigned(base);
+	sendUSARTString_P(PSTR(", Brazo1="));
+	FMT_sendUnsigned(brazo1);
+	sendUSARTString_P(PSTR(", Brazo2="));
+	FMT_sendUnsigned(brazo2);
+	sendUSARTString_P(PSTR(", Pinza="));
+	FMT_sendUnsigned(pinza);
+	sendUSARTString_P(PSTR("\r\nP,"));
+	FMT_sendUnsigned(base);
+	sendUSARTData(',');
+	FMT_sendUnsigned(brazo1);
+	sendUSARTData(',');
+	FMT_sendUnsigned(brazo2);
+	sendUSARTData(',');
+	FMT_sendUnsigned(pinza);
+	sendUSARTString_P(PSTR("\r\nX="));
+	FMT_sendSigned(distancia);
+	sendUSARTString_P(PSTR("\r\n"));
+	BENCH_END(BENCH_FMT_FORMAT);
+}
+#endif
+
+int main(void) {
+	uint8_t n = 0;
+	
+	initUSART();
+	sei();
+	
+	while (1) {
+#if BENCH_METODO != 2
+		lineasSprintf(n);
+		flushUSART();
+#endif
+#if BENCH_METODO != 1
+		lineasFormat(n);
+		flushUSART();
+#endif
+
+		// Recorrer valores de 1, 2 y 3 dgitos
+		n = (n + 1) & 0x0F;
+		base = (base + 7) % 181;
+		brazo1 = (brazo1 + 11) % 181;
+		brazo2 = (brazo2 + 13) % 181;
+		pinza = (pinza + 17) % 181;
+		distancia += 97;
+	}
+}
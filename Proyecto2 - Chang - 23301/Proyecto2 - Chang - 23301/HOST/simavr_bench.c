@@ -0,0 +1,364 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este programa de PC ejecuta el firmware compilado con BENCH_ENABLE = 1
+* en el simulador simavr (ATmega328P a 16 MHz) y mide, ciclo por ciclo,
+* el costo de cada seccin marcada con BENCH_BEGIN/BENCH_END (ver
+* LBRY12/BENCH.h). Los resultados se imprimen en JSON para compararlos
+* entre versiones del firmware.
+*
+* Mediciones:
+*   - Ciclos por seccin (cuenta, mnimo, mximo y promedio). En las
+*     funciones del lazo principal se descuentan los ciclos de las
+*     interrupciones que ocurren a la mitad (tiempo exclusivo)
+*   - Latencia de cada interrupcin: ciclos desde que se activa la
+*     bandera hasta que entra la rutina
+*   - Peor tiempo de una vuelta del lazo principal (con interrupciones)
+*
+* Escenarios:
+*   - manual: modo 1, los potencimetros siguen una rampa triangular
+*   - usart: modo 2, rfaga de comandos S,base,brazo1,brazo2,pinza
+*   - eeprom: modo 3, guarda posiciones con G,n y las reproduce con E
+*   - formato: sin entrada, para HOST/format_bench.c (sprintf contra
+*     LBRY16/FORMAT)
+*
+* Compilacin (no es parte del firmware):
+*   avr-gcc -mmcu=atmega328p -DF_CPU=16000000UL -Os -DBENCH_ENABLE=1 \
+*       -o firmware.elf main.c <los .c de LBRY1..LBRY20>
+*   gcc -O2 -I/usr/include/simavr -o simavr_bench HOST/simavr_bench.c \
+*       -lsimavr -lelf
+*
+* Uso:
+*   ./simavr_bench firmware.elf [manual|usart|eeprom|todos]
+*   ./simavr_bench format_bench.elf formato
+*
+* Comparar dos versiones del firmware: compilar firmware.elf de cada una
+* con las mismas opciones y correr el mismo escenario. La salida a los
+* servos (writeServoPWM, con las tablas de LBRY9/LUT.h) corre desde el
+* motor de movimiento, as que su costo aparece en "ISR_TIMER1_OVF"
+* ("ISR_TIMER1_CAPT" con SERVO_MUX_ENABLE = 1);
+* "updateServos" solo mide la lectura de las entradas y los objetivos.
+************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sim_avr.h>
+#include <sim_elf.h>
+#include <sim_io.h>
+#include <sim_irq.h>
+#include <sim_cycle_timers.h>
+#include <sim_interrupts.h>
+#include <avr_uart.h>
+#include <avr_adc.h>
+#include "../LBRY12/BENCH.h"
+
+#define FRECUENCIA_CPU 16000000UL
+#define DIRECCION_GPIOR0 0x3E           // GPIOR0 en el espacio de datos (E/S 0x1E + 0x20)
+#define CICLOS_POR_BYTE 16667           // 10 bits a 9600 baudios
+#define CICLOS_RAMPA 16000              // Cambio de los potencimetros cada 1 ms
+#define CICLOS_ESCENARIO (FRECUENCIA_CPU * 2) // 2 s simulados por escenario
+#define MAX_ANIDADO 8
+#define NUM_MARCADORES 0x80
+#define NUM_POTENCIOMETROS 4
+
+// Vectores del ATmega328P que se miden
+typedef struct {
+	uint8_t vector;
+	const char* nombre;
+} VectorMedido;
+
+static const VectorMedido vectores[] = {
+	{ 7, "TIMER2_COMPA" },
+	{ 10, "TIMER1_CAPT" },
+	{ 11, "TIMER1_COMPA" },
+	{ 12, "TIMER1_COMPB" },
+	{ 13, "TIMER1_OVF" },
+	{ 18, "USART_RX" },
+	{ 19, "USART_UDRE" },
+	{ 21, "ADC" },
+	{ 22, "EE_READY" },
+};
+#define NUM_VECTORES (sizeof(vectores) / sizeof(vectores[0]))
+
+typedef struct {
+	uint32_t cuenta;
+	uint64_t minimo;
+	uint64_t maximo;
+	uint64_t total;
+} Estadistica;
+
+typedef struct {
+	uint8_t id;
+	avr_cycle_count_t inicio;
+	avr_cycle_count_t anidados;     // Ciclos de secciones internas (interrupciones)
+} Marco;
+
+typedef struct {
+	const VectorMedido* vector;
+	avr_cycle_count_t pendiente;
+	uint8_t esperando;
+	Estadistica latencia;
+} Latencia;
+
+static avr_t* avr;
+static Estadistica exclusivo[NUM_MARCADORES];
+static Estadistica peorLazo;
+static Marco pila[MAX_ANIDADO];
+static uint8_t profundidad;
+static uint32_t marcadoresPerdidos;
+static Latencia latencias[NUM_VECTORES];
+
+// Guion de entrada por USART del escenario actual
+static const char* guion;
+static size_t posicionGuion;
+static uint32_t faseRampa;
+
+static const char* nombreMarcador(uint8_t id) {
+	switch (id) {
+		case BENCH_LAZO: return "lazo";
+		case BENCH_SERVOS: return "updateServos";
+		case BENCH_COMANDO: return "processCommand";
+		case BENCH_FILTRO: return "ADC_read_Filtr";
+		case BENCH_SECUENCIA: return "PLAY_tarea";
+		case BENCH_BOTONES: return "botones";
+		case BENCH_MUESTREO: return "tareaADC";
+		case BENCH_FMT_SPRINTF: return "linea_sprintf";
+		case BENCH_FMT_FORMAT: return "linea_FORMAT";
+		case BENCH_ISR_RX: return "ISR_USART_RX";
+		case BENCH_ISR_UDRE: return "ISR_USART_UDRE";
+		case BENCH_ISR_ADC: return "ISR_ADC";
+		case BENCH_ISR_TICK: return "ISR_TIMER2_COMPA";
+		case BENCH_ISR_TRAMA: return "ISR_TIMER1_OVF";
+		case BENCH_ISR_EEPROM: return "ISR_EE_READY";
+		case BENCH_ISR_PWM0: return "ISR_TIMER0_OVF";
+		case BENCH_ISR_MUX: return "ISR_TIMER1_CAPT";
+		case BENCH_ISR_MUX_A: return "ISR_TIMER1_COMPA";
+		case BENCH_ISR_MUX_B: return "ISR_TIMER1_COMPB";
+		default: return NULL;
+	}
+}
+
+static void agregar(Estadistica* e, uint64_t ciclos) {
+	if (e->cuenta == 0 || ciclos < e->minimo) e->minimo = ciclos;
+	if (ciclos > e->maximo) e->maximo = ciclos;
+	e->total += ciclos;
+	e->cuenta++;
+}
+
+// Escritura del firmware a GPIOR0: inicio o fin de una seccin
+static void escrituraGPIOR0(struct avr_t* a, avr_io_addr_t direccion, uint8_t valor, void* param) {
+	uint8_t id = valor & ~BENCH_FIN;
+	a->data[direccion] = valor;
+	
+	if (!(valor & BENCH_FIN)) {
+		if (profundidad >= MAX_ANIDADO) {
+			marcadoresPerdidos++;
+			return;
+		}
+		pila[profundidad].id = id;
+		pila[profundidad].inicio = a->cycle;
+		pila[profundidad].anidados = 0;
+		profundidad++;
+		return;
+	}
+	
+	// Buscar el inicio correspondiente (descarta inicios sin fin)
+	while (profundidad > 0 && pila[profundidad - 1].id != id) {
+		profundidad--;
+		marcadoresPerdidos++;
+	}
+	if (profundidad == 0) {
+		marcadoresPerdidos++;
+		return;
+	}
+	
+	profundidad--;
+	avr_cycle_count_t total = a->cycle - pila[profundidad].inicio;
+	agregar(&exclusivo[id], total - pila[profundidad].anidados);
+	if (id == BENCH_LAZO) {
+		agregar(&peorLazo, total);
+	}
+	
+	// El tiempo de esta seccin no cuenta como exclusivo de la seccin que interrumpi
+	if (profundidad > 0) {
+		pila[profundidad - 1].anidados += total;
+	}
+}
+
+// La bandera de la interrupcin se activ
+static void interrupcionPendiente(struct avr_irq_t* irq, uint32_t valor, void* param) {
+	Latencia* l = (Latencia*)param;
+	if (valor && !l->esperando) {
+		l->pendiente = avr->cycle;
+		l->esperando = 1;
+	}
+}
+
+// El CPU entr a la rutina de la interrupcin
+static void interrupcionEjecutando(struct avr_irq_t* irq, uint32_t valor, void* param) {
+	Latencia* l = (Latencia*)param;
+	if (valor && l->esperando) {
+		agregar(&l->latencia, avr->cycle - l->pendiente);
+		l->esperando = 0;
+	}
+}
+
+// Enviar el siguiente byte del guion al ritmo de 9600 baudios
+static avr_cycle_count_t enviarByte(struct avr_t* a, avr_cycle_count_t cuando, void* param) {
+	if (guion[posicionGuion] == '\0') return 0;
+	
+	avr_raise_irq(avr_io_getirq(a, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT), (uint8_t)guion[posicionGuion]);
+	posicionGuion++;
+	
+	return cuando + CICLOS_POR_BYTE;
+}
+
+// Rampa triangular en los potencimetros (0-5000 mV), desfasada por canal
+static avr_cycle_count_t moverPotenciometros(struct avr_t* a, avr_cycle_count_t cuando, void* param) {
+	faseRampa++;
+	for (uint8_t canal = 0; canal < NUM_POTENCIOMETROS; canal++) {
+		uint32_t fase = (faseRampa * 10 + canal * 1250) % 10000;
+		uint32_t mv = (fase < 5000) ? fase : 10000 - fase;
+		avr_raise_irq(avr_io_getirq(a, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0 + canal), mv);
+	}
+	
+	return cuando + CICLOS_RAMPA;
+}
+
+static void descartarSalida(struct avr_irq_t* irq, uint32_t valor, void* param) {
+	// La salida de texto del firmware no se usa en la medicin
+}
+
+static void imprimirEstadistica(const Estadistica* e) {
+	printf("{\"cuenta\": %u, \"min\": %llu, \"max\": %llu, \"promedio\": %.1f}",
+	e->cuenta, (unsigned long long)e->minimo, (unsigned long long)e->maximo,
+	e->cuenta ? (double)e->total / e->cuenta : 0.0);
+}
+
+static int ejecutarEscenario(const char* firmware, const char* nombre, const char* entrada, int primero) {
+	elf_firmware_t f;
+	memset(&f, 0, sizeof(f));
+	if (elf_read_firmware(firmware, &f) != 0) {
+		fprintf(stderr, "No se pudo leer %s\n", firmware);
+		return 1;
+	}
+	
+	avr = avr_make_mcu_by_name("atmega328p");
+	if (!avr) {
+		fprintf(stderr, "simavr no tiene soporte para atmega328p\n");
+		return 1;
+	}
+	avr_init(avr);
+	avr_load_firmware(avr, &f);
+	avr->frequency = FRECUENCIA_CPU;
+	avr->avcc = 5000;
+	avr->aref = 5000;
+	
+	memset(exclusivo, 0, sizeof(exclusivo));
+	memset(&peorLazo, 0, sizeof(peorLazo));
+	memset(latencias, 0, sizeof(latencias));
+	profundidad = 0;
+	marcadoresPerdidos = 0;
+	guion = entrada;
+	posicionGuion = 0;
+	faseRampa = 0;
+	
+	avr_register_io_write(avr, DIRECCION_GPIOR0, escrituraGPIOR0, NULL);
+	
+	for (size_t i = 0; i < NUM_VECTORES; i++) {
+		avr_irq_t* irq = avr_get_interrupt_irq(avr, vectores[i].vector);
+		latencias[i].vector = &vectores[i];
+		if (irq) {
+			avr_irq_register_notify(irq + AVR_INT_IRQ_PENDING, interrupcionPendiente, &latencias[i]);
+			avr_irq_register_notify(irq + AVR_INT_IRQ_RUNNING, interrupcionEjecutando, &latencias[i]);
+		}
+	}
+	
+	// USART sin eco a la consola de simavr
+	uint32_t banderas = 0;
+	avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &banderas);
+	banderas &= ~AVR_UART_FLAG_STDIO;
+	avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &banderas);
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT), descartarSalida, NULL);
+	
+	// Dar tiempo al arranque antes de enviar el guion
+	avr_cycle_timer_register(avr, FRECUENCIA_CPU / 10, enviarByte, NULL);
+	avr_cycle_timer_register(avr, CICLOS_RAMPA, moverPotenciometros, NULL);
+	
+	int estado = cpu_Running;
+	while (avr->cycle < CICLOS_ESCENARIO && estado != cpu_Done && estado != cpu_Crashed) {
+		estado = avr_run(avr);
+	}
+	
+	printf("%s  \"%s\": {\n", primero ? "" : ",\n", nombre);
+	printf("    \"ciclos_simulados\": %llu,\n", (unsigned long long)avr->cycle);
+	printf("    \"marcadores_perdidos\": %u,\n", marcadoresPerdidos);
+	printf("    \"peor_lazo\": ");
+	imprimirEstadistica(&peorLazo);
+	printf(",\n    \"secciones\": {");
+	
+	int separador = 0;
+	for (int id = 0; id < NUM_MARCADORES; id++) {
+		const char* n = nombreMarcador((uint8_t)id);
+		if (!n || exclusivo[id].cuenta == 0) continue;
+		printf("%s\n      \"%s\": ", separador ? "," : "", n);
+		imprimirEstadistica(&exclusivo[id]);
+		separador = 1;
+	}
+	printf("\n    },\n    \"latencia_isr\": {");
+	
+	separador = 0;
+	for (size_t i = 0; i < NUM_VECTORES; i++) {
+		if (latencias[i].latencia.cuenta == 0) continue;
+		printf("%s\n      \"%s\": ", separador ? "," : "", latencias[i].vector->nombre);
+		imprimirEstadistica(&latencias[i].latencia);
+		separador = 1;
+	}
+	printf("\n    }\n  }");
+	
+	avr_terminate(avr);
+	return (estado == cpu_Crashed) ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "Uso: %s firmware.elf [manual|usart|eeprom|formato|todos]\n", argv[0]);
+		return 1;
+	}
+	const char* seleccion = (argc > 2) ? argv[2] : "todos";
+	int todos = (strcmp(seleccion, "todos") == 0);
+	int error = 0;
+	int primero = 1;
+	
+	printf("{\n");
+	if (todos || strcmp(seleccion, "manual") == 0) {
+		error |= ejecutarEscenario(argv[1], "manual", "1\r", primero);
+		primero = 0;
+	}
+	if (todos || strcmp(seleccion, "usart") == 0) {
+		error |= ejecutarEscenario(argv[1], "usart",
+		"2\rS,0,0,0,0\rS,180,90,45,30\rS,90,45,120,30\rS,10,170,20,160\r"
+		"S,45,45,45,45\rS,135,135,135,135\rS,90,90,90,90\r", primero);
+		primero = 0;
+	}
+	if (todos || strcmp(seleccion, "eeprom") == 0) {
+		error |= ejecutarEscenario(argv[1], "eeprom",
+		"3\rG,0\rG,1\rG,2\rG,3\rE\r", primero);
+		primero = 0;
+	}
+	// Solo si se pide: el firmware de la garra no tiene estas secciones
+	if (strcmp(seleccion, "formato") == 0) {
+		error |= ejecutarEscenario(argv[1], "formato", "", primero);
+		primero = 0;
+	}
+	printf("\n}\n");
+	
+	return error;
+}
@@ -0,0 +1,1169 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este programa de PC prueba las libreras y la lgica de comandos de
+* main.c compiladas con HAL_HOST (registros simulados). Cada prueba
+* compara el resultado con el valor esperado y el programa termina con
+* cdigo 1 si alguna falla, as se puede correr en cada cambio.
+*
+* Pruebas:
+*   - Conversin de ngulos: ADC -> ngulo, ngulo -> PWM y calibracin
+*   - Filtro del ADC: promedio de las muestras y zona muerta
+*   - EEPROM: mapa de la imagen, posiciones que sobreviven a un reinicio
+*     y registros con CRC incorrecto
+*   - Secuencias: cuadros codificados por diferencias, lectura desde un
+*     cuadro intermedio y secuencias con CRC incorrecto
+*   - Formato: enteros con y sin signo comparados con snprintf
+*   - Cinemtica inversa: atan2 y raz entera contra math.h, ngulos de
+*     una rejilla de puntos contra la solucin en punto flotante y
+*     puntos fuera de alcance
+*   - Comandos: seleccin de modo, S, G, L y tramas binarias recibidas
+*     por el ISR de la USART
+*
+* Los perifricos se atienden en el acto: cada vez que el firmware lee
+* SREG con interrupciones habilitadas se vaca el buffer de transmisin
+* (se guarda en salidaUSART) y se escriben los bytes pendientes de la
+* EEPROM.
+*
+* Compilacin y ejecucin (desde la carpeta del proyecto):
+*   make test
+************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef HAL_HOST
+#error "unit_tests.c se compila para la PC con -DHAL_HOST"
+#endif
+
+#define HAL_HOST_PROGRAMA
+#include "../LBRY11/HAL.h"
+#include "../LBRY1/ADC.h"
+#include "../LBRY2/TIMER0_PWM.h"
+#include "../LBRY3/USART.h"
+#include "../LBRY4/EEPROM.h"
+#include "../LBRY5/TIMER1_PWM.h"
+#include "../LBRY6/PROTOCOL.h"
+#include "../LBRY7/SCHEDULER.h"
+#include "../LBRY8/MOTION.h"
+#include "../LBRY13/PROFILER.h"
+#include "../LBRY14/BUTTONS.h"
+#include "../LBRY16/FORMAT.h"
+#include "../LBRY17/TELEMETRY.h"
+#include "../LBRY18/KINEMATICS.h"
+#include "../LBRY19/CALIBRATION.h"
+#include "../LBRY20/PLAYBACK.h"
+
+// Estado y funciones de main.c
+#define USART_MODE 2
+#define EEPROM_MODE 3
+#define SIN_CUADRO 0xFF
+extern volatile uint8_t posServoBase;
+extern volatile uint8_t posServoBrazo1;
+extern volatile uint8_t posServoBrazo2;
+extern volatile uint8_t posServoPinza;
+extern volatile uint8_t modoOperacion;
+extern char bufferRx[];
+extern uint8_t secuenciaReproduciendo;
+extern uint8_t siguienteCuadroLector;
+void initSystem(void);
+void tareaComandos(void);
+void playbackPose(const PosicionGarra* pose, uint16_t duracion);
+void playbackEvent(uint8_t evento, uint8_t numero);
+uint8_t readSequenceKeyframe(uint8_t numero, CuadroClave* cuadro);
+void fillTelemetry(EstadoTelemetria* estado);
+void playNextPosition(void);
+
+// Rutinas de interrupcin del firmware
+void USART_RX_vect(void);
+void USART_UDRE_vect(void);
+void ADC_vect(void);
+void EE_READY_vect(void);
+void TIMER2_COMPA_vect(void);
+void PCINT0_vect(void);
+void PCINT2_vect(void);
+
+#define MAX_SALIDA 4096
+
+static int pruebas = 0;
+static int fallas = 0;
+static char salidaUSART[MAX_SALIDA];
+static size_t largoSalida = 0;
+
+#define CHECK(condicion) verificar((condicion), #condicion, __FILE__, __LINE__)
+#define CHECK_EQ(obtenido, esperado) verificarIgual((long)(obtenido), (long)(esperado), #obtenido, __FILE__, __LINE__)
+
+static void verificar(int condicion, const char* texto, const char* archivo, int linea) {
+	pruebas++;
+	if (!condicion) {
+		fallas++;
+		printf("%s:%d: falla: %s\n", archivo, linea, texto);
+	}
+}
+
+static void verificarIgual(long obtenido, long esperado, const char* texto, const char* archivo, int linea) {
+	pruebas++;
+	if (obtenido != esperado) {
+		fallas++;
+		printf("%s:%d: falla: %s = %ld, se esperaba %ld\n", archivo, linea, texto, obtenido, esperado);
+	}
+}
+
+// Perifricos: transmisin y EEPROM terminan en el acto
+static void atenderPerifericos(void) {
+	while (HAL_UCSR0B & (1 << UDRIE0)) {
+		// El ISR apaga UDRIE sin escribir UDR0 cuando el buffer queda vaco
+		USART_UDRE_vect();
+		if ((HAL_UCSR0B & (1 << UDRIE0)) && largoSalida < MAX_SALIDA - 1) {
+			salidaUSART[largoSalida++] = (char)HAL_UDR0;
+			salidaUSART[largoSalida] = '\0';
+		}
+	}
+	while (HAL_EECR & (1 << EERIE)) {
+		EE_READY_vect();
+	}
+}
+
+static void limpiarSalida(void) {
+	atenderPerifericos();
+	largoSalida = 0;
+	salidaUSART[0] = '\0';
+}
+
+static int salidaContiene(const char* texto) {
+	atenderPerifericos();
+	return strstr(salidaUSART, texto) != NULL;
+}
+
+// Recibir una lnea por el ISR de la USART y atenderla como el planificador
+static void recibirLinea(const char* linea) {
+	limpiarSalida();
+	for (; *linea; linea++) {
+		HAL_UDR0 = (uint8_t)*linea;
+		USART_RX_vect();
+	}
+	HAL_UDR0 = '\r';
+	USART_RX_vect();
+	tareaComandos();
+	atenderPerifericos();
+}
+
+static void recibirBytes(const uint8_t* datos, uint8_t largo) {
+	limpiarSalida();
+	for (uint8_t i = 0; i < largo; i++) {
+		HAL_UDR0 = datos[i];
+		USART_RX_vect();
+	}
+	tareaComandos();
+	atenderPerifericos();
+}
+
+// Sistema completo desde un reinicio (la EEPROM se conserva)
+static void arrancarFirmware(void) {
+	uint8_t imagen[sizeof(HAL_eeprom)];
+	memcpy(imagen, HAL_eeprom, sizeof(imagen));
+	HAL_reset();
+	memcpy(HAL_eeprom, imagen, sizeof(imagen));
+	HAL_UCSR0A = (1 << UDRE0);
+	HAL_setInterruptHook(atenderPerifericos);
+	
+	initSystem();
+	PLAY_init(playbackPose, playbackEvent);
+	TELEM_init(fillTelemetry);
+	limpiarSalida();
+}
+
+// Una muestra de cada canal por el ISR del ADC (recorre ADC0 -> ADC3)
+static void muestrasADC(uint16_t c0, uint16_t c1, uint16_t c2, uint16_t c3) {
+	uint16_t valores[ADC_NUM_CANALES] = { c0, c1, c2, c3 };
+	for (uint8_t canal = 0; canal < ADC_NUM_CANALES; canal++) {
+		HAL_ADCW = valores[canal];
+		ADC_vect();
+	}
+}
+
+static void probarAngulos(void) {
+	// ADC (0-1023) -> ngulo (0-180)
+	CHECK_EQ(ADC_Angulo(0), 0);
+	CHECK_EQ(ADC_Angulo(512), 90);
+	CHECK_EQ(ADC_Angulo(1023), 180);
+	CHECK_EQ(ADC_Angulo(2000), 180);
+	int monotona = 1;
+	for (uint16_t v = 1; v < 1024; v++) {
+		if (ADC_Angulo(v) < ADC_Angulo(v - 1)) monotona = 0;
+	}
+	CHECK(monotona);
+	
+	// ngulo -> PWM de cada timer
+	CHECK_EQ(calculate_PWM0(0), SERVO_MIN_T0);
+	CHECK_EQ(calculate_PWM0(180), SERVO_MAX_T0);
+	CHECK_EQ(calculate_PWM0(255), SERVO_MAX_T0);
+	CHECK_EQ(calculate_PWM1(0), 2000);
+	CHECK_EQ(calculate_PWM1(90), 3000);
+	CHECK_EQ(calculate_PWM1(180), 4000);
+	CHECK_EQ(calculate_PWM1_inverted(0), 4000);
+	CHECK_EQ(calculate_PWM1_inverted(180), 2000);
+	CHECK_EQ(calculate_PWM0_ticks(SERVO_MIN_T0 * 128), SERVO_MIN_T0);
+	CHECK_EQ(calculate_PWM0_ticks(0xFFFF), 0xFF);
+	
+	// La calibracin por defecto reproduce los valores de las tablas
+	HAL_reset();
+	initEEPROM();
+	CAL_init();
+	int diferenciaT0 = 0;
+	int diferenciaT1 = 0;
+	for (uint16_t a = 0; a <= 180; a++) {
+		if (calculate_PWM0_ticks(CAL_ticks(0, a)) != calculate_PWM0(a)) diferenciaT0++;
+		if (calculate_PWM0_ticks(CAL_ticks(1, a)) != calculate_PWM0(a)) diferenciaT0++;
+		if (abs((int)CAL_ticks(2, a) - (int)calculate_PWM1(a)) > 1) diferenciaT1++;
+	}
+	CHECK_EQ(diferenciaT0, 0);
+	CHECK_EQ(diferenciaT1, 0);
+	CHECK(CAL_ticks(3, 0) > CAL_ticks(3, 180));
+	
+	// Lmites de software y extremos invlidos
+	CalibracionServo cal;
+	CAL_get(2, &cal);
+	cal.limiteInf = 30;
+	cal.limiteSup = 150;
+	CHECK(CAL_set(2, &cal));
+	CHECK_EQ(CAL_ticks(2, 0), CAL_ticks(2, 30));
+	CHECK_EQ(CAL_ticks(2, 180), CAL_ticks(2, 150));
+	cal.pulsoMax = CAL_PULSO_MAX + 1;
+	CHECK(!CAL_set(2, &cal));
+	CAL_restoreDefaults();
+}
+
+static void probarFiltro(void) {
+	HAL_reset();
+	ADC_init();
+	
+	// Canales independientes
+	for (uint8_t i = 0; i < ADC_MUESTRAS_BUFFER; i++) {
+		muestrasADC(100, 200, 300, 400);
+	}
+	CHECK_EQ(ADC_read(0), 100);
+	CHECK_EQ(ADC_read(3), 400);
+	CHECK_EQ(ADC_read(ADC_NUM_CANALES), 0);
+	CHECK_EQ(ADC_read_Filtr(1, 4), 200);
+	
+	// Promedio de las ltimas muestras
+	muestrasADC(100, 220, 300, 400);
+	muestrasADC(100, 240, 300, 400);
+	CHECK_EQ(ADC_read_Filtr(1, 4), 215);
+	CHECK_EQ(ADC_read_Filtr(1, 2), 230);
+	
+	// Zona muerta: un cambio menor a 5 cuentas conserva el valor anterior
+	CHECK_EQ(ADC_read_Filtr(2, 8), 300);
+	muestrasADC(100, 240, 303, 400);
+	CHECK_EQ(ADC_read_Filtr(2, 1), 300);
+	muestrasADC(100, 240, 310, 400);
+	CHECK_EQ(ADC_read_Filtr(2, 1), 310);
+	
+	// Cantidad de muestras fuera de rango
+	CHECK_EQ(ADC_read_Filtr(3, 0), 400);
+	CHECK_EQ(ADC_read_Filtr(3, 200), 400);
+	CHECK_EQ(ADC_read_Filtr(ADC_NUM_CANALES, 4), 0);
+}
+
+static void probarEEPROM(void) {
+	// Mapa de la imagen: reas contiguas que llenan los 1024 bytes
+	CHECK_EQ(DIRECCION_REGISTROS, BYTES_CABECERA);
+	CHECK_EQ(DIRECCION_SECUENCIAS, DIRECCION_REGISTROS + 2 * REGISTROS_POR_BANCO * BYTES_POR_REGISTRO);
+	CHECK(DIRECCION_SECUENCIAS < FIN_SECUENCIAS);
+	CHECK_EQ(FIN_SECUENCIAS, DIRECCION_CALIBRACION);
+	CHECK_EQ(DIRECCION_CALIBRACION + BYTES_CALIBRACION, EEPROM_TAMANO);
+	CHECK_EQ(CAL_NUM_CANALES * CAL_BYTES_CANAL, DATOS_CALIBRACION);
+	CHECK(MAX_POSICIONES_GUARDADAS < RANURA_CUENTA);
+	
+	// EEPROM nueva: recibe formato, sin posiciones (la cola de las pruebas
+	// anteriores se vaca antes de borrar la imagen)
+	EEPROM_flush();
+	HAL_reset();
+	initEEPROM();
+	EEPROM_flush();
+	CHECK_EQ(EEPROM_imageStatus(), IMAGEN_FORMATEADA);
+	CHECK_EQ(Saved_Pos_Count(), 0);
+	CHECK_EQ(EEPROM_sequenceCount(), 0);
+	
+	// Las posiciones sobreviven a un reinicio, tambin despus de cambiar de banco
+	for (uint8_t vuelta = 0; vuelta < 3; vuelta++) {
+		for (uint8_t i = 0; i < REGISTROS_POR_BANCO; i++) {
+			PosicionGarra pos = { (uint8_t)(i + vuelta), 10, 20, (uint8_t)(i % MAX_POSICIONES_GUARDADAS) };
+			savePosition(i % MAX_POSICIONES_GUARDADAS, pos);
+		}
+	}
+	EEPROM_flush();
+	CHECK_EQ(EEPROM_pending(), 0);
+	CHECK_EQ(Saved_Pos_Count(), MAX_POSICIONES_GUARDADAS);
+	PosicionGarra antes = loadPosition(3);
+	initEEPROM();
+	CHECK_EQ(Saved_Pos_Count(), MAX_POSICIONES_GUARDADAS);
+	PosicionGarra despues = loadPosition(3);
+	CHECK(memcmp(&antes, &despues, sizeof(PosicionGarra)) == 0);
+	
+	// Un registro con CRC incorrecto se ignora y gana el anterior de esa ranura
+	HAL_reset();
+	initEEPROM();
+	PosicionGarra primera = { 1, 2, 3, 4 };
+	PosicionGarra segunda = { 5, 6, 7, 8 };
+	savePosition(0, primera);
+	savePosition(0, segunda);
+	EEPROM_flush();
+	// El formato puede dejar antes un registro de cuenta: buscar el de la segunda
+	uint16_t registro = DIRECCION_REGISTROS;
+	while (HAL_eeprom[registro + 4] != segunda.base) registro += BYTES_POR_REGISTRO;
+	HAL_eeprom[registro + 4] ^= 0x01;
+	initEEPROM();
+	PosicionGarra leida = loadPosition(0);
+	CHECK_EQ(leida.base, 1);
+	CHECK_EQ(leida.pinza, 4);
+	
+	// La lectura ve los bytes que an esperan en la cola
+	writeEEPROMB(DIRECCION_SECUENCIAS + 10, 0x5A);
+	CHECK_EQ(readEEPROM(DIRECCION_SECUENCIAS + 10), 0x5A);
+	EEPROM_flush();
+	CHECK_EQ(HAL_eeprom[DIRECCION_SECUENCIAS + 10], 0x5A);
+	
+	// Una cabecera de otra versin no se borra: se carga en solo lectura
+	HAL_reset();
+	initEEPROM();
+	savePosition(0, primera);
+	EEPROM_flush();
+	HAL_eeprom[DIRECCION_CABECERA + 4] = FORMATO_VERSION + 1;
+	initEEPROM();
+	CHECK_EQ(EEPROM_imageStatus(), IMAGEN_INVALIDA);
+	CHECK_EQ(Saved_Pos_Count(), 1);
+	CHECK(!savePosition(1, segunda));
+	CHECK_EQ(Saved_Pos_Count(), 1);
+	CHECK(!EEPROM_beginSequence("nueva"));
+	CHECK(!CAL_save());
+	CHECK(!CAL_isStored());
+	EEPROM_flush();
+	CHECK_EQ(HAL_eeprom[DIRECCION_CABECERA + 4], FORMATO_VERSION + 1);
+	CHECK_EQ(HAL_eeprom[DIRECCION_CALIBRACION], 0xFF);
+	initEEPROM();
+	CHECK_EQ(Saved_Pos_Count(), 1);
+	
+	// Solo EEPROM_format (a pedido del usuario) le vuelve a dar formato
+	EEPROM_format();
+	EEPROM_flush();
+	initEEPROM();
+	CHECK_EQ(EEPROM_imageStatus(), IMAGEN_VALIDA);
+	CHECK_EQ(Saved_Pos_Count(), 0);
+	
+	// Una imagen que no se reconoce tampoco se formatea
+	EEPROM_flush();
+	HAL_reset();
+	HAL_eeprom[0] = 'X';
+	HAL_eeprom[DIRECCION_SECUENCIAS] = SECUENCIA_DELTA;
+	initEEPROM();
+	EEPROM_flush();
+	CHECK_EQ(EEPROM_imageStatus(), IMAGEN_INVALIDA);
+	CHECK_EQ(HAL_eeprom[0], 'X');
+	
+	// La tabla fija de la versin 0 se migra
+	EEPROM_flush();
+	HAL_reset();
+	HAL_eeprom[DIRECCION_BASE_EEPROM] = 11;
+	HAL_eeprom[DIRECCION_BASE_EEPROM + 3] = 44;
+	HAL_eeprom[DIRECCION_NUM_POSICIONES] = 1;
+	initEEPROM();
+	EEPROM_flush();
+	CHECK_EQ(EEPROM_imageStatus(), IMAGEN_FORMATEADA);
+	initEEPROM();
+	CHECK_EQ(EEPROM_imageStatus(), IMAGEN_VALIDA);
+	CHECK_EQ(Saved_Pos_Count(), 1);
+	leida = loadPosition(0);
+	CHECK_EQ(leida.base, 11);
+	CHECK_EQ(leida.pinza, 44);
+}
+
+// Cuadro de prueba: pasos pequeos con un salto grande y tiempos que cambian
+static CuadroClave cuadroPrueba(uint8_t i) {
+	CuadroClave cuadro;
+	cuadro.pose.base = 10 + i * 3;
+	cuadro.pose.brazo1 = (i == 5) ? 170 : 90 - i;
+	cuadro.pose.brazo2 = 45;
+	cuadro.pose.pinza = (i & 1) ? 0 : 120;
+	cuadro.transicion = (i < 10) ? 25 : 50;
+	cuadro.espera = (i == 7) ? 10 : 0;
+	return cuadro;
+}
+
+static int cuadrosIguales(const CuadroClave* a, const CuadroClave* b) {
+	return memcmp(&a->pose, &b->pose, sizeof(PosicionGarra)) == 0 &&
+	a->transicion == b->transicion && a->espera == b->espera;
+}
+
+// Cambiar la versin de la cabecera (con su CRC) para simular una imagen anterior
+static void cabeceraVersion(uint8_t version) {
+	uint8_t crc = 0;
+	HAL_eeprom[DIRECCION_CABECERA + 4] = version;
+	for (uint8_t i = 0; i < BYTES_CABECERA - 2; i++) {
+		crc = PROTO_crc8(crc, HAL_eeprom[DIRECCION_CABECERA + i]);
+	}
+	HAL_eeprom[DIRECCION_CABECERA + BYTES_CABECERA - 2] = crc;
+}
+
+// Escribir una secuencia de cuadros de prueba a partir del cuadro primero
+static int escribirSecuencia(const char* nombre, uint8_t primero, uint8_t numCuadros) {
+	if (!EEPROM_beginSequence(nombre)) return 0;
+	for (uint8_t i = 0; i < numCuadros; i++) {
+		CuadroClave cuadro = cuadroPrueba(primero + i);
+		if (!EEPROM_addKeyframe(&cuadro)) return 0;
+	}
+	return EEPROM_endSequence() != SIN_SECUENCIA;
+}
+
+static int leerSecuencia(const char* nombre, uint8_t primero, uint8_t numCuadros) {
+	uint8_t indice = EEPROM_findSequence(nombre);
+	if (indice == SIN_SECUENCIA || EEPROM_sequenceLength(indice) != numCuadros) return 0;
+	for (uint8_t i = 0; i < numCuadros; i++) {
+		CuadroClave esperado = cuadroPrueba(primero + i);
+		CuadroClave leido;
+		if (!EEPROM_readKeyframe(indice, i, &leido) || !cuadrosIguales(&leido, &esperado)) return 0;
+	}
+	return 1;
+}
+
+static void probarSecuencias(void) {
+	const uint8_t numCuadros = 20;
+	
+	HAL_reset();
+	initEEPROM();
+	uint16_t libres = EEPROM_freeBytes();
+	CHECK(EEPROM_beginSequence("prueba"));
+	for (uint8_t i = 0; i < numCuadros; i++) {
+		CuadroClave cuadro = cuadroPrueba(i);
+		CHECK(EEPROM_addKeyframe(&cuadro));
+	}
+	uint8_t indice = EEPROM_endSequence();
+	CHECK_EQ(indice, 0);
+	EEPROM_flush();
+	
+	// Ocupa menos que los cuadros de 6 bytes sin comprimir
+	uint16_t usados = libres - EEPROM_freeBytes();
+	CHECK(usados < BYTES_CABECERA_DELTA + 1 + numCuadros * BYTES_POR_CUADRO);
+	
+	// Despus de un reinicio: mismos cuadros por acceso directo y por flujo
+	initEEPROM();
+	CHECK_EQ(EEPROM_sequenceCount(), 1);
+	CHECK_EQ(EEPROM_findSequence("prueba"), 0);
+	CHECK_EQ(EEPROM_findSequence("otra"), SIN_SECUENCIA);
+	CHECK_EQ(EEPROM_sequenceLength(0), numCuadros);
+	int distintos = 0;
+	for (uint8_t i = 0; i < numCuadros; i++) {
+		CuadroClave esperado = cuadroPrueba(i);
+		CuadroClave leido;
+		if (!EEPROM_readKeyframe(0, i, &leido) || !cuadrosIguales(&leido, &esperado)) distintos++;
+	}
+	CHECK_EQ(distintos, 0);
+	
+	// Empezar en un cuadro despus del segundo cuadro absoluto
+	LectorSecuencia lector;
+	CHECK(EEPROM_openSequence(0, INTERVALO_ABSOLUTO + 3, &lector));
+	distintos = 0;
+	uint8_t leidos = 0;
+	CuadroClave cuadro;
+	while (EEPROM_nextKeyframe(&lector, &cuadro)) {
+		CuadroClave esperado = cuadroPrueba(INTERVALO_ABSOLUTO + 3 + leidos);
+		if (!cuadrosIguales(&cuadro, &esperado)) distintos++;
+		leidos++;
+	}
+	CHECK_EQ(distintos, 0);
+	CHECK_EQ(leidos, numCuadros - INTERVALO_ABSOLUTO - 3);
+	CHECK(!EEPROM_openSequence(0, numCuadros, &lector));
+	CHECK(!EEPROM_readKeyframe(0, numCuadros, &cuadro));
+	
+	// Una secuencia incompleta (sin EEPROM_endSequence) no aparece
+	CHECK(EEPROM_beginSequence("cortada"));
+	cuadro = cuadroPrueba(0);
+	EEPROM_addKeyframe(&cuadro);
+	EEPROM_flush();
+	initEEPROM();
+	CHECK_EQ(EEPROM_sequenceCount(), 1);
+	
+	// Un byte alterado hace que la secuencia se descarte al arrancar
+	HAL_eeprom[DIRECCION_SECUENCIAS + BYTES_CABECERA_DELTA + 2] ^= 0x10;
+	initEEPROM();
+	CHECK_EQ(EEPROM_sequenceCount(), 0);
+	CHECK_EQ(EEPROM_sequenceErrors(), 1);
+	
+	// Reemplazar una secuencia muchas veces no llena el rea: al faltar
+	// espacio se recupera el de las borradas sin tocar las vigentes
+	EEPROM_flush();
+	HAL_reset();
+	initEEPROM();
+	CHECK(escribirSecuencia("fija", 0, numCuadros));
+	int fallidas = 0;
+	for (uint8_t vuelta = 1; vuelta <= 40; vuelta++) {
+		uint8_t anterior = EEPROM_findSequence("cambia");
+		if (anterior != SIN_SECUENCIA) EEPROM_deleteSequence(anterior);
+		if (!escribirSecuencia("cambia", vuelta, MAX_POSICIONES_GUARDADAS)) fallidas++;
+	}
+	CHECK_EQ(fallidas, 0);
+	EEPROM_flush();
+	initEEPROM();
+	CHECK_EQ(EEPROM_sequenceCount(), 2);
+	CHECK_EQ(EEPROM_sequenceErrors(), 0);
+	CHECK(leerSecuencia("fija", 0, numCuadros));
+	CHECK(leerSecuencia("cambia", 40, MAX_POSICIONES_GUARDADAS));
+	
+	// Imagen de la versin 3 cuya cadena entra en el bloque de calibracin:
+	// una borrada estirada hasta que "ultima" cruce DIRECCION_CALIBRACION
+	EEPROM_flush();
+	HAL_reset();
+	initEEPROM();
+	CAL_init();
+	CAL_save();
+	libres = EEPROM_freeBytes();
+	CHECK(escribirSecuencia("borrada", 0, numCuadros));
+	uint16_t largoBorrada = libres - EEPROM_freeBytes();
+	CHECK(escribirSecuencia("ultima", 5, numCuadros));
+	uint16_t largoUltima = libres - EEPROM_freeBytes() - largoBorrada;
+	EEPROM_deleteSequence(EEPROM_findSequence("borrada"));
+	EEPROM_flush();
+	CHECK_EQ(HAL_eeprom[DIRECCION_SECUENCIAS], SECUENCIA_BORRADA_DELTA);
+	
+	uint16_t destino = DIRECCION_CALIBRACION + 20 - largoUltima;
+	memmove(&HAL_eeprom[destino], &HAL_eeprom[DIRECCION_SECUENCIAS + largoBorrada], largoUltima);
+	HAL_eeprom[destino + largoUltima] = SECUENCIA_FIN;
+	uint16_t estirada = destino - DIRECCION_SECUENCIAS - 1 - BYTES_CABECERA_DELTA;
+	HAL_eeprom[DIRECCION_SECUENCIAS + BYTES_CABECERA_SECUENCIA] = (uint8_t)estirada;
+	HAL_eeprom[DIRECCION_SECUENCIAS + BYTES_CABECERA_SECUENCIA + 1] = (uint8_t)(estirada >> 8);
+	cabeceraVersion(3);
+	
+	// Al migrar la secuencia baja, la calibracin se descarta y la cabecera pasa a la 4
+	initEEPROM();
+	EEPROM_flush();
+	CHECK_EQ(EEPROM_imageStatus(), IMAGEN_VALIDA);
+	CHECK_EQ(HAL_eeprom[DIRECCION_CABECERA + 4], FORMATO_VERSION);
+	CHECK_EQ(HAL_eeprom[DIRECCION_CALIBRACION], 0xFF);
+	CHECK_EQ(EEPROM_sequenceCount(), 1);
+	CHECK_EQ(EEPROM_sequenceErrors(), 0);
+	CHECK(leerSecuencia("ultima", 5, numCuadros));
+	CAL_init();
+	CHECK(!CAL_isStored());
+	initEEPROM();
+	CHECK(leerSecuencia("ultima", 5, numCuadros));
+	
+	// Sin secuencias en el bloque, la calibracin de una imagen anterior se conserva
+	CAL_save();
+	EEPROM_flush();
+	cabeceraVersion(3);
+	initEEPROM();
+	EEPROM_flush();
+	CHECK_EQ(HAL_eeprom[DIRECCION_CABECERA + 4], FORMATO_VERSION);
+	CAL_init();
+	CHECK(CAL_isStored());
+	CHECK(leerSecuencia("ultima", 5, numCuadros));
+}
+
+// Avanzar el tick de 1 ms del Timer2
+static void esperarMs(uint16_t ms) {
+	for (uint16_t i = 0; i < ms; i++) {
+		TIMER2_COMPA_vect();
+	}
+}
+
+// Presionar un botn (pull-up: 0 es presionado) durante ms y soltarlo
+static void pulsarBoton(volatile uint8_t* pin, uint8_t bit, uint16_t ms) {
+	*pin &= ~(1 << bit);
+	if (pin == &PINB) PCINT0_vect(); else PCINT2_vect();
+	esperarMs(ms);
+	*pin |= (1 << bit);
+	if (pin == &PINB) PCINT0_vect(); else PCINT2_vect();
+	esperarMs(30);
+}
+
+static void probarBotones(void) {
+	uint8_t evento;
+	
+	HAL_reset();
+	PINB = 0xFF;
+	PIND = 0xFF;
+	BUTTONS_init();
+	esperarMs(BOTONES_DOBLE_MS);
+	while (BUTTONS_getEvent(&evento)) {}
+	
+	// Sin pulsacin doble: el evento sale al soltar y dos clics rpidos son dos eventos
+	pulsarBoton(&PINB, PINB3, 60);
+	CHECK(BUTTONS_getEvent(&evento));
+	CHECK_EQ(evento, BOTON_EVENTO(BOTON_GUARDAR, BOTON_CORTO));
+	pulsarBoton(&PINB, PINB3, 60);
+	pulsarBoton(&PINB, PINB0, 60);
+	pulsarBoton(&PINB, PINB0, 60);
+	uint8_t guardar = 0;
+	uint8_t modo = 0;
+	while (BUTTONS_getEvent(&evento)) {
+		if (evento == BOTON_EVENTO(BOTON_GUARDAR, BOTON_CORTO)) guardar++;
+		if (evento == BOTON_EVENTO(BOTON_MODO, BOTON_CORTO)) modo++;
+	}
+	CHECK_EQ(guardar, 1);
+	CHECK_EQ(modo, 2);
+	
+	// PD7: dos clics dentro de la ventana son una pulsacin doble
+	pulsarBoton(&PIND, PIND7, 60);
+	pulsarBoton(&PIND, PIND7, 60);
+	esperarMs(BOTONES_DOBLE_MS);
+	CHECK(BUTTONS_getEvent(&evento));
+	CHECK_EQ(evento, BOTON_EVENTO(BOTON_REPRODUCIR, BOTON_DOBLE));
+	CHECK(!BUTTONS_getEvent(&evento));
+	
+	// Mantenido: pulsacin larga sin esperar a soltar
+	pulsarBoton(&PINB, PINB3, BOTONES_LARGO_MS + 20);
+	CHECK(BUTTONS_getEvent(&evento));
+	CHECK_EQ(evento, BOTON_EVENTO(BOTON_GUARDAR, BOTON_LARGO));
+	CHECK_EQ(BUTTONS_lostEvents(), 0);
+}
+
+static uint8_t salidaEjes[MOTION_NUM_EJES];
+
+static void registrarSalida(uint8_t eje, uint8_t angulo) {
+	salidaEjes[eje] = angulo;
+}
+
+static void probarMovimiento(void) {
+	static const uint8_t destino[MOTION_NUM_EJES] = { 180, 90, 0, 45 };
+	static const uint8_t origen[MOTION_NUM_EJES] = { 0, 0, 0, 0 };
+	
+	HAL_reset();
+	MOTION_init(registrarSalida);
+	MOTION_setLimits(MOTION_TODOS, 180, 720);
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		MOTION_jumpTo(eje, 0);
+	}
+	
+	// Una duracin demasiado corta (M,1,20) no pasa de la velocidad mxima
+	uint16_t tramas = MOTION_moveCoordinated(destino, 20);
+	CHECK(tramas * MOTION_MS_TRAMA >= 1000);
+	
+	// Perfil trapezoidal: arranca y frena suave, sin pasar de los lmites
+	// (3.6 grados por trama y 0.29 por trama^2, ms el redondeo del ngulo)
+	int pasoMaximo = 0;
+	int cambioMaximo = 0;
+	int anterior = 0;
+	int pasoAnterior = 0;
+	int juntos = 1;
+	for (uint16_t t = 1; t <= tramas; t++) {
+		MOTION_update();
+		int paso = salidaEjes[0] - anterior;
+		if (paso > pasoMaximo) pasoMaximo = paso;
+		if (abs(paso - pasoAnterior) > cambioMaximo) cambioMaximo = abs(paso - pasoAnterior);
+		if (abs(2 * salidaEjes[1] - salidaEjes[0]) > 2) juntos = 0;
+		anterior = salidaEjes[0];
+		pasoAnterior = paso;
+	}
+	CHECK(pasoMaximo <= 4);
+	CHECK(cambioMaximo <= 2);
+	CHECK(pasoAnterior <= 1);
+	CHECK(juntos);
+	CHECK(memcmp(salidaEjes, destino, sizeof(destino)) == 0);
+	CHECK(!MOTION_isMoving());
+	
+	// Una duracin mayor que la mnima se respeta
+	CHECK_EQ(MOTION_moveCoordinated(origen, 3000), 3000 / MOTION_MS_TRAMA);
+	for (uint16_t t = 1; t < 3000 / MOTION_MS_TRAMA; t++) {
+		MOTION_update();
+	}
+	CHECK(MOTION_isMoving());
+	MOTION_update();
+	CHECK(memcmp(salidaEjes, origen, sizeof(origen)) == 0);
+	CHECK(!MOTION_isMoving());
+}
+
+// Reproduccin: cuadros de prueba y registro de lo que entrega el motor
+#define MAX_REGISTRO 32
+static CuadroClave cuadrosReproduccion[4];
+static uint8_t numCuadrosReproduccion;
+static uint8_t lecturasFuente;
+static uint8_t posesEnviadas;
+static uint8_t baseEnviada[MAX_REGISTRO];
+static uint16_t duracionEnviada[MAX_REGISTRO];
+static uint16_t msEnviada[MAX_REGISTRO];
+static uint8_t finReproduccion;
+static uint16_t msFin;
+
+static uint8_t fuentePrueba(uint8_t numero, CuadroClave* cuadro) {
+	if (numero >= numCuadrosReproduccion) return 0;
+	*cuadro = cuadrosReproduccion[numero];
+	lecturasFuente++;
+	return 1;
+}
+
+// Salida: registrar la pose y moverla como playbackPose
+static void salidaPrueba(const PosicionGarra* pose, uint16_t duracion) {
+	if (posesEnviadas < MAX_REGISTRO) {
+		baseEnviada[posesEnviadas] = pose->base;
+		duracionEnviada[posesEnviadas] = duracion;
+		msEnviada[posesEnviadas] = SCHED_ticks();
+		posesEnviadas++;
+	}
+	MOTION_moveCoordinated(&pose->base, duracion);
+}
+
+static void eventoPrueba(uint8_t evento, uint8_t numero) {
+	(void)numero;
+	if (evento == PLAY_EVENTO_FIN) {
+		finReproduccion = 1;
+		msFin = SCHED_ticks();
+	}
+}
+
+// Tick de 1 ms, tareas del planificador y una trama del motor cada 20 ms
+static void correrMs(uint16_t ms) {
+	for (uint16_t i = 0; i < ms; i++) {
+		TIMER2_COMPA_vect();
+		if (SCHED_ticks() % MOTION_MS_TRAMA == 0) MOTION_update();
+		SCHED_run();
+	}
+}
+
+// Cuadros con base 10, 20, 30... y tiempos en unidades de UNIDAD_TIEMPO_MS
+static void prepararReproduccion(uint8_t cuadros, uint8_t transicion, uint8_t espera) {
+	numCuadrosReproduccion = cuadros;
+	for (uint8_t i = 0; i < cuadros; i++) {
+		PosicionGarra pose = { (uint8_t)(10 * (i + 1)), 90, 90, 0 };
+		cuadrosReproduccion[i].pose = pose;
+		cuadrosReproduccion[i].transicion = transicion;
+		cuadrosReproduccion[i].espera = espera;
+	}
+	lecturasFuente = 0;
+	posesEnviadas = 0;
+	finReproduccion = 0;
+}
+
+// Orden de las bases enviadas, p. ej. "10,20,30"
+static int ordenEnviado(const char* esperado) {
+	char texto[4 * MAX_REGISTRO] = "";
+	for (uint8_t i = 0; i < posesEnviadas; i++) {
+		sprintf(texto + strlen(texto), i ? ",%u" : "%u", baseEnviada[i]);
+	}
+	return strcmp(texto, esperado) == 0;
+}
+
+static void probarReproduccion(void) {
+	HAL_reset();
+	SCHED_init();
+	MOTION_init(registrarSalida);
+	PLAY_init(salidaPrueba, eventoPrueba);
+	PLAY_setSpeed(100);
+	
+	// Una vez: cada cuadro dura transicin + espera y se lee una sola vez
+	prepararReproduccion(3, 5, 5);
+	PLAY_setRepeat(PLAY_UNA_VEZ, 0);
+	uint16_t inicio = SCHED_ticks();
+	CHECK(PLAY_start(fuentePrueba, 3));
+	correrMs(1000);
+	CHECK(ordenEnviado("10,20,30"));
+	CHECK_EQ(msEnviada[1] - inicio, 200);
+	CHECK_EQ(msEnviada[2] - inicio, 400);
+	CHECK_EQ(duracionEnviada[1], 100);
+	CHECK(finReproduccion);
+	CHECK_EQ(msFin - inicio, 600);
+	CHECK_EQ(lecturasFuente, 3);
+	CHECK_EQ(PLAY_state(), PLAY_DETENIDO);
+	
+	// Bucle dos veces
+	prepararReproduccion(3, 5, 5);
+	PLAY_setRepeat(PLAY_BUCLE, 2);
+	CHECK(PLAY_start(fuentePrueba, 3));
+	correrMs(2000);
+	CHECK(ordenEnviado("10,20,30,10,20,30"));
+	CHECK(finReproduccion);
+	
+	// Ida y vuelta una vez: de regreso la transicin es la del cuadro que se deja
+	prepararReproduccion(3, 5, 5);
+	cuadrosReproduccion[2].transicion = 15;
+	PLAY_setRepeat(PLAY_IDA_VUELTA, 1);
+	CHECK(PLAY_start(fuentePrueba, 3));
+	correrMs(3000);
+	CHECK(ordenEnviado("10,20,30,20,10"));
+	CHECK_EQ(duracionEnviada[2], 300);
+	CHECK_EQ(duracionEnviada[3], 300);
+	CHECK_EQ(duracionEnviada[4], 100);
+	CHECK(finReproduccion);
+	
+	// Velocidad: 25 % alarga transicin y espera 4 veces, 400 % las acorta
+	PLAY_setRepeat(PLAY_UNA_VEZ, 0);
+	prepararReproduccion(2, 10, 10);
+	PLAY_setSpeed(25);
+	CHECK(PLAY_start(fuentePrueba, 2));
+	correrMs(4000);
+	CHECK_EQ(duracionEnviada[0], 800);
+	CHECK_EQ(msEnviada[1] - msEnviada[0], 1600);
+	CHECK(finReproduccion);
+	prepararReproduccion(2, 10, 10);
+	PLAY_setSpeed(400);
+	CHECK(PLAY_start(fuentePrueba, 2));
+	correrMs(500);
+	CHECK_EQ(duracionEnviada[0], 50);
+	CHECK_EQ(msEnviada[1] - msEnviada[0], 100);
+	CHECK(finReproduccion);
+	CHECK(!PLAY_setSpeed(PLAY_VELOCIDAD_MIN - 1));
+	CHECK(!PLAY_setSpeed(PLAY_VELOCIDAD_MAX + 1));
+	
+	// Lo que la tarea se pasa de un cuadro se descuenta del siguiente: a 75 %
+	// cada cuadro de 20 ms dura 26.7 ms aunque la tarea corra cada 20 ms
+	prepararReproduccion(3, 1, 0);
+	PLAY_setSpeed(75);
+	inicio = SCHED_ticks();
+	CHECK(PLAY_start(fuentePrueba, 3));
+	correrMs(500);
+	CHECK_EQ(msEnviada[1] - inicio, 40);
+	CHECK_EQ(msEnviada[2] - inicio, 60);
+	CHECK_EQ(msFin - inicio, 80);
+	PLAY_setSpeed(100);
+	
+	// Pausa: los servos se quedan donde estaban y el tiempo no corre; al
+	// continuar se reenva la pose con la parte de la transicin que faltaba
+	prepararReproduccion(2, 10, 10);
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		MOTION_jumpTo(eje, 90);
+	}
+	inicio = SCHED_ticks();
+	CHECK(PLAY_start(fuentePrueba, 2));
+	correrMs(100);
+	PLAY_pause();
+	CHECK_EQ(PLAY_state(), PLAY_PAUSADO);
+	uint8_t enPausa = MOTION_getPosition(0);
+	CHECK(enPausa < 90 && enPausa > 10);
+	correrMs(1000);
+	CHECK_EQ(MOTION_getPosition(0), enPausa);
+	CHECK_EQ(posesEnviadas, 1);
+	PLAY_resume();
+	CHECK_EQ(posesEnviadas, 2);
+	CHECK_EQ(duracionEnviada[1], 100);
+	correrMs(1000);
+	CHECK_EQ(baseEnviada[2], 20);
+	CHECK_EQ(msEnviada[2] - inicio, 400 + 1000);
+	CHECK_EQ(lecturasFuente, 2);
+	
+	// P,n: ir a un cuadro (tambin en pausa); F: detener
+	prepararReproduccion(4, 5, 5);
+	PLAY_setRepeat(PLAY_BUCLE, 0);
+	CHECK(PLAY_start(fuentePrueba, 4));
+	correrMs(60);
+	CHECK(PLAY_seek(3));
+	CHECK_EQ(PLAY_currentFrame(), 3);
+	CHECK(!PLAY_seek(4));
+	correrMs(200);
+	CHECK(ordenEnviado("10,40,10"));
+	PLAY_pause();
+	CHECK(PLAY_seek(2));
+	correrMs(500);
+	CHECK(ordenEnviado("10,40,10,30"));
+	CHECK_EQ(PLAY_state(), PLAY_PAUSADO);
+	PLAY_stop();
+	CHECK_EQ(PLAY_state(), PLAY_DETENIDO);
+	correrMs(500);
+	CHECK_EQ(posesEnviadas, 4);
+	CHECK(!PLAY_seek(0));
+	CHECK(!finReproduccion);
+	
+	// Secuencia con nombre: ida y vuelta con el lector en flujo (reabre al
+	// regresar) entrega los mismos cuadros que la lectura directa
+	EEPROM_flush();
+	HAL_reset();
+	initEEPROM();
+	CHECK(escribirSecuencia("baile", 0, 12));
+	EEPROM_flush();
+	secuenciaReproduciendo = EEPROM_findSequence("baile");
+	siguienteCuadroLector = SIN_CUADRO;
+	prepararReproduccion(0, 0, 0);
+	PLAY_setRepeat(PLAY_IDA_VUELTA, 1);
+	CHECK(PLAY_start(readSequenceKeyframe, 12));
+	correrMs(30000);
+	CHECK(finReproduccion);
+	CHECK_EQ(posesEnviadas, 23);
+	int distintos = 0;
+	for (uint8_t i = 0; i < posesEnviadas; i++) {
+		uint8_t numero = (i < 12) ? i : (22 - i);
+		if (baseEnviada[i] != cuadroPrueba(numero).pose.base) distintos++;
+	}
+	CHECK_EQ(distintos, 0);
+	PLAY_setRepeat(PLAY_UNA_VEZ, 0);
+	secuenciaReproduciendo = SIN_SECUENCIA;
+}
+
+static void probarFormato(void) {
+	static const uint32_t sinSigno[] = {
+		0, 1, 9, 10, 99, 100, 180, 255, 999, 1000, 1023, 9999, 10000, 65535,
+		65536, 99999, 100000, 999999, 1000000, 9999999, 10000000, 99999999,
+		100000000, 999999999, 1000000000, 2147483647UL, 4294967295UL
+	};
+	static const int32_t conSigno[] = {
+		0, 1, -1, 9, -9, 10, -10, -128, 127, -1234, 32767, -32768,
+		2147483647L, -2147483647L - 1
+	};
+	char texto[FMT_MAX_TEXTO + 1];
+	char esperado[16];
+	
+	int distintos = 0;
+	for (size_t i = 0; i < sizeof(sinSigno) / sizeof(sinSigno[0]); i++) {
+		uint8_t largo = FMT_unsigned(texto, sinSigno[i]);
+		texto[largo] = '\0';
+		snprintf(esperado, sizeof(esperado), "%lu", (unsigned long)sinSigno[i]);
+		if (strcmp(texto, esperado) != 0 || largo != strlen(esperado)) {
+			printf("FMT_unsigned(%lu) = \"%s\"\n", (unsigned long)sinSigno[i], texto);
+			distintos++;
+		}
+	}
+	for (size_t i = 0; i < sizeof(conSigno) / sizeof(conSigno[0]); i++) {
+		uint8_t largo = FMT_signed(texto, conSigno[i]);
+		texto[largo] = '\0';
+		snprintf(esperado, sizeof(esperado), "%ld", (long)conSigno[i]);
+		if (strcmp(texto, esperado) != 0 || largo != strlen(esperado)) {
+			printf("FMT_signed(%ld) = \"%s\"\n", (long)conSigno[i], texto);
+			distintos++;
+		}
+	}
+	CHECK_EQ(distintos, 0);
+	CHECK_EQ(FMT_unsigned(texto, 4294967295UL), FMT_MAX_DIGITOS);
+	CHECK_EQ(FMT_signed(texto, -2147483647L - 1), FMT_MAX_TEXTO);
+	
+	// Lnea armada en un buffer: texto de la flash, columnas y relleno
+	char linea[FMT_MAX_LINEA];
+	uint8_t largo = FMT_text_P(linea, PSTR("Pos "));
+	largo += FMT_unsignedWidth(linea + largo, 42, 5);
+	largo += FMT_spaces(linea + largo, 2);
+	largo += FMT_unsignedWidth(linea + largo, 123456, 3);
+	linea[largo] = '\0';
+	CHECK(strcmp(linea, "Pos    42  123456") == 0);
+}
+
+// ngulos de referencia con punto flotante (mismas convenciones que KINEMATICS.h)
+static void resolverReferencia(double x, double y, double z, double l1, double l2, double altura, double* angulos) {
+	double r = sqrt(x * x + y * y);
+	double h = z - altura;
+	double cosenoCodo = (r * r + h * h - l1 * l1 - l2 * l2) / (2 * l1 * l2);
+	double codo = acos(cosenoCodo);
+	
+	angulos[0] = atan2(y, x) * 180 / M_PI;
+	angulos[1] = (atan2(h, r) + atan2(l2 * sin(codo), l1 + l2 * cos(codo))) * 180 / M_PI;
+	angulos[2] = 180 - codo * 180 / M_PI;
+}
+
+static void probarCinematica(void) {
+	// atan2 en Q16.16 en los cuatro cuadrantes
+	double errorMaximo = 0;
+	for (int32_t y = -1000; y <= 1000; y += 37) {
+		for (int32_t x = -1000; x <= 1000; x += 41) {
+			double error = fabs(KIN_atan2(y, x) / 65536.0 - atan2(y, x) * 180 / M_PI);
+			if (error > 180) error = 360 - error;
+			if (error > errorMaximo) errorMaximo = error;
+		}
+	}
+	CHECK(errorMaximo < 0.01);
+	
+	// Raz cuadrada entera (piso)
+	int distintas = 0;
+	for (uint32_t v = 0; v < 200000; v += 7) {
+		if (KIN_sqrt(v) != (uint16_t)floor(sqrt((double)v))) distintas++;
+	}
+	if (KIN_sqrt(4294967295UL) != 65535) distintas++;
+	CHECK_EQ(distintas, 0);
+	
+	// Rejilla de puntos alcanzables: cada ngulo a 1 o menos de la referencia
+	KIN_init();
+	int resueltos = 0;
+	int fueraTolerancia = 0;
+	for (int16_t z = 0; z <= 200; z += 20) {
+		for (int16_t y = 0; y <= 160; y += 20) {
+			for (int16_t x = -160; x <= 160; x += 20) {
+				// En el hombro mismo (brazo doblado) el ngulo de brazo1 no est definido
+				if (x == 0 && y == 0 && z == KIN_ALTURA_DEFECTO) continue;
+				
+				AngulosArticulacion angulos;
+				if (KIN_solve(x, y, z, &angulos) != KIN_OK) continue;
+				resueltos++;
+				
+				double referencia[3];
+				resolverReferencia(x, y, z, KIN_L1_DEFECTO, KIN_L2_DEFECTO, KIN_ALTURA_DEFECTO, referencia);
+				if (fabs(angulos.base - referencia[0]) > 1 ||
+				fabs(angulos.brazo1 - referencia[1]) > 1 ||
+				fabs(angulos.brazo2 - referencia[2]) > 1) {
+					fueraTolerancia++;
+				}
+			}
+		}
+	}
+	CHECK(resueltos > 100);
+	CHECK_EQ(fueraTolerancia, 0);
+	
+	// Brazo estirado al frente a la altura del hombro
+	AngulosArticulacion angulos;
+	CHECK_EQ(KIN_solve(0, KIN_L1_DEFECTO + KIN_L2_DEFECTO, KIN_ALTURA_DEFECTO, &angulos), KIN_OK);
+	CHECK_EQ(angulos.base, 90);
+	CHECK_EQ(angulos.brazo1, 0);
+	CHECK_EQ(angulos.brazo2, 180);
+	
+	// Puntos rechazados antes de mover los servos
+	CHECK_EQ(KIN_solve(0, -10, 60, &angulos), KIN_DETRAS);
+	CHECK_EQ(KIN_solve(0, 200, 60, &angulos), KIN_FUERA_ALCANCE);
+	
+	// Geometra configurable
+	CHECK(!KIN_setGeometry(0, 80, 60));
+	CHECK(!KIN_setGeometry(80, KIN_LARGO_MAX + 1, 60));
+	CHECK(KIN_setGeometry(120, 60, 40));
+	CHECK_EQ(KIN_solve(0, 180, 40, &angulos), KIN_OK);
+	CHECK_EQ(angulos.brazo2, 180);
+	CHECK_EQ(KIN_solve(0, 50, 40, &angulos), KIN_FUERA_ALCANCE);
+	KIN_init();
+}
+
+static void probarComandos(void) {
+	HAL_reset();
+	arrancarFirmware();
+	CHECK_EQ(modoOperacion, 0);
+	
+	// Seleccin de modo
+	recibirLinea("9");
+	CHECK(salidaContiene("Opcion no valida"));
+	CHECK_EQ(modoOperacion, 0);
+	
+	// STATS solo aparece en el men y se acepta con el perfilador
+	recibirLinea("menu");
+	CHECK_EQ(salidaContiene("STATS"), PROFILER_ENABLE);
+	recibirLinea("STATS");
+	CHECK_EQ(salidaContiene("Opcion no valida"), !PROFILER_ENABLE);
+	CHECK_EQ(modoOperacion, 0);
+	recibirLinea("2");
+	CHECK_EQ(modoOperacion, USART_MODE);
+	
+	// Posicin por USART (el eco de cada carcter tambin sale)
+	recibirLinea("S,10,20,30,40");
+	CHECK(salidaContiene("S,10,20,30,40"));
+	CHECK(salidaContiene("Posicion actualizada"));
+	CHECK_EQ(posServoBase, 10);
+	CHECK_EQ(posServoBrazo1, 20);
+	CHECK_EQ(posServoBrazo2, 30);
+	CHECK_EQ(posServoPinza, 40);
+	
+	// Comando incompleto o desconocido: nada cambia
+	recibirLinea("S,90,90");
+	CHECK(!salidaContiene("Posicion actualizada"));
+	CHECK_EQ(posServoBase, 10);
+	recibirLinea("Z");
+	CHECK(salidaContiene("Comando no valido"));
+	
+	// Guardar y listar en modo EEPROM
+	recibirLinea("menu");
+	CHECK_EQ(modoOperacion, 0);
+	recibirLinea("3");
+	CHECK_EQ(modoOperacion, EEPROM_MODE);
+	recibirLinea("G,0");
+	CHECK(salidaContiene("Posicion guardada en la ranura 0"));
+	recibirLinea("G,10");
+	CHECK(salidaContiene("Numero de posicion invalido"));
+	recibirLinea("L");
+	CHECK(salidaContiene("Posiciones guardadas: 1"));
+	CHECK(salidaContiene("Pos 0: Base=10, Brazo1=20, Brazo2=30, Pinza=40"));
+	
+	// La posicin guardada sigue ah despus de un reinicio
+	arrancarFirmware();
+	CHECK_EQ(Saved_Pos_Count(), 1);
+	CHECK_EQ(loadPosition(0).brazo2, 30);
+	
+	// Trama binaria SET_POSE (solo en modo USART) y trama con CRC incorrecto
+	recibirLinea("2");
+	uint8_t trama[] = { PROTO_SYNC, PROTO_OP_SET_POSE, 4, 45, 90, 135, 180, 0 };
+	uint8_t crc = 0;
+	for (uint8_t i = 1; i < sizeof(trama) - 1; i++) {
+		crc = PROTO_crc8(crc, trama[i]);
+	}
+	trama[sizeof(trama) - 1] = crc;
+	recibirBytes(trama, sizeof(trama));
+	CHECK_EQ(posServoBase, 45);
+	CHECK_EQ(posServoPinza, 180);
+	CHECK_EQ((uint8_t)salidaUSART[0], PROTO_SYNC);
+	CHECK_EQ((uint8_t)salidaUSART[1], PROTO_OP_SET_POSE | PROTO_RESPUESTA);
+	CHECK_EQ((uint8_t)salidaUSART[3], PROTO_OK);
+	
+	trama[3] = 0;
+	recibirBytes(trama, sizeof(trama));
+	CHECK_EQ(posServoBase, 45);
+	CHECK_EQ((uint8_t)salidaUSART[3], PROTO_ERR_CRC);
+	
+	// Una trama cortada a la mitad se abandona despus de PROTO_TIMEOUT_MS
+	// y la siguiente se recibe completa
+	trama[3] = 60;
+	crc = 0;
+	for (uint8_t i = 1; i < sizeof(trama) - 1; i++) {
+		crc = PROTO_crc8(crc, trama[i]);
+	}
+	trama[sizeof(trama) - 1] = crc;
+	recibirBytes(trama, 4);
+	esperarMs(PROTO_TIMEOUT_MS + 1);
+	recibirBytes(trama, sizeof(trama));
+	CHECK_EQ(posServoBase, 60);
+	CHECK_EQ((uint8_t)salidaUSART[3], PROTO_OK);
+	
+	// Con USART_TX_DESCARTAR una respuesta que no cabe se descarta entera,
+	// sin que salgan los nmeros del medio
+	PosicionGarra guardada = { 10, 20, 30, 40 };
+	savePosition(0, guardada);
+	EEPROM_flush();
+	setUSARTTxPolicy(USART_TX_DESCARTAR);
+	limpiarSalida();
+	char relleno[USART_TX_BUFFER];
+	memset(relleno, '.', sizeof(relleno));
+	relleno[USART_TX_BUFFER - 1 - 30] = '\0';
+	cli();
+	sendUSARTString(relleno);
+	uint8_t pendientes = getUSARTTxPending();
+	playNextPosition();
+	CHECK_EQ(getUSARTTxPending(), pendientes);
+	sei();
+	limpiarSalida();
+	playNextPosition();
+	CHECK(salidaContiene("Reproduciendo posicion"));
+	setUSARTTxPolicy(USART_TX_BLOQUEAR);
+	
+	// Con la imagen en solo lectura G, N y CAL,G avisan en lugar de confirmar
+	EEPROM_flush();
+	HAL_eeprom[DIRECCION_CABECERA + 4] = FORMATO_VERSION + 1;
+	arrancarFirmware();
+	recibirLinea("3");
+	limpiarSalida();
+	recibirLinea("G,1");
+	CHECK(salidaContiene("no se guardara nada"));
+	CHECK(!salidaContiene("Posicion guardada"));
+	CHECK_EQ(Saved_Pos_Count(), 1);
+	limpiarSalida();
+	recibirLinea("N,prueba");
+	CHECK(salidaContiene("no se guardara nada"));
+	CHECK(!salidaContiene("Secuencia guardada"));
+	CHECK_EQ(EEPROM_sequenceCount(), 0);
+	limpiarSalida();
+	recibirLinea("CAL,G");
+	CHECK(salidaContiene("no se guardara nada"));
+	CHECK(!salidaContiene("Calibracion guardada"));
+	EEPROM_flush();
+	CHECK_EQ(HAL_eeprom[DIRECCION_CABECERA + 4], FORMATO_VERSION + 1);
+}
+
+int main(void) {
+	probarAngulos();
+	probarFiltro();
+	probarEEPROM();
+	probarSecuencias();
+	probarBotones();
+	probarMovimiento();
+	probarReproduccion();
+	probarFormato();
+	probarCinematica();
+	probarComandos();
+	
+	printf("%d pruebas, %d fallas\n", pruebas, fallas);
+	return fallas ? 1 : 0;
+}
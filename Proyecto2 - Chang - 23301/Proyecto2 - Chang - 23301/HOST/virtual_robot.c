@@ -0,0 +1,567 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este programa de PC ejecuta el firmware completo (main.c y las
+* libreras, compilados con HAL_HOST) como un proceso de Linux. La USART
+* queda expuesta como una pseudo-terminal (PTY), as que cualquier
+* herramienta puede enviar los comandos reales ("S,...", "G,n", "E",
+* "L", tramas binarias) sin la tarjeta conectada.
+*
+* Modelo de perifricos (se ejecuta cada vez que el firmware tiene las
+* interrupciones habilitadas, ver HAL_setInterruptHook):
+*   - Timer2: interrupcin de comparacin con el periodo de OCR2A y su
+*     prescaler (tick del planificador)
+*   - Timer0: desborde cada 256 cuentas (copia de los registros sombra)
+*   - Timer1: trama de ICR1 + 1 cuentas; desborde (PWM por hardware) o
+*     captura y comparaciones encadenadas (SERVO_MUX). Con PWM por
+*     hardware TCNT1 sigue al tiempo dentro de la trama
+*   - ADC: conversin de 13 ciclos del reloj del ADC; los potencimetros
+*     son valores fijos o una rampa triangular
+*   - USART: un byte cada 10 bits a la velocidad de UBRR0, en ambas
+*     direcciones
+*   - EEPROM: EE_READY cada 3.4 ms mientras EERIE est activo; la imagen
+*     se puede cargar y guardar en un archivo
+*   - Servos: en cada trama se registra el valor de comparacin y el
+*     ancho de pulso de cada servo, y el ngulo de un servo modelado que
+*     sigue al pulso con velocidad limitada
+*
+* El tiempo simulado avanza con el reloj de la PC multiplicado por un
+* factor de velocidad (-x), as que los tiempos de las secuencias se
+* pueden medir con la misma escala que en el robot real.
+*
+* Limitaciones:
+*   - Los bytes que el firmware escribe directo a UDR0 con interrupciones
+*     deshabilitadas (vaciado manual del buffer) no llegan a la PTY
+*   - Los botones se leen siempre sueltos (PINx = PORTx, pull-ups)
+*
+* Compilacin (desde la carpeta del proyecto):
+*   gcc -std=gnu99 -O2 -DHAL_HOST -I. -o virtual_robot HOST/virtual_robot.c \
+*       main.c <los .c de LBRY1..LBRY20>
+*
+* Uso:
+*   ./virtual_robot [-l enlace] [-o servos.csv] [-e eeprom.bin]
+*                   [-x velocidad] [-p p0,p1,p2,p3] [-r periodo_ms]
+*   -l: enlace simblico a la PTY (por ejemplo /tmp/garra)
+*   -o: registro CSV de los servos (t_us, comparaciones, pulsos, ngulos)
+*   -e: imagen de la EEPROM (se carga al iniciar y se guarda al salir)
+*   -x: factor de velocidad del tiempo simulado (1 = tiempo real)
+*   -p: lectura ADC de cada potencimetro (0-1023)
+*   -r: los potencimetros siguen una rampa triangular con este periodo
+************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef HAL_HOST
+#error "virtual_robot.c se compila para la PC con -DHAL_HOST"
+#endif
+
+#define HAL_HOST_PROGRAMA
+#include "../LBRY11/HAL.h"
+
+#define NS_POR_CICLO_NUM 125            // 1 ciclo a 16 MHz = 62.5 ns = 125 / 2
+#define NS_POR_CICLO_DEN 2
+#define NS_ESCRITURA_EEPROM 3400000ULL  // 3.4 ms por byte
+#define NUM_SERVOS 4
+#define NUM_POTENCIOMETROS 4
+#define MUX_SIN_MATCH 0xFFFF            // Igual que SERVO_MUX_SIN_MATCH
+#define MAX_COMPARACIONES 16
+#define PULSO_MIN_US 500                // Servo modelado: 0.5 ms = 0 grados
+#define PULSO_MAX_US 2500               // 2.5 ms = 180 grados
+#define GRADOS_POR_SEGUNDO 600          // 0.1 s / 60 grados
+
+// Rutinas de interrupcin del firmware
+void TIMER2_COMPA_vect(void);
+void TIMER0_OVF_vect(void);
+void TIMER1_OVF_vect(void);
+void TIMER1_CAPT_vect(void);
+void TIMER1_COMPA_vect(void);
+void TIMER1_COMPB_vect(void);
+void ADC_vect(void);
+void USART_RX_vect(void);
+void USART_UDRE_vect(void);
+void EE_READY_vect(void);
+
+static const char* nombresServos[NUM_SERVOS] = { "base", "brazo1", "brazo2", "pinza" };
+
+static int pty = -1;
+static FILE* registro = NULL;
+static const char* archivoEEPROM = NULL;
+static const char* enlace = NULL;
+static double velocidad = 1.0;
+static uint16_t potenciometros[NUM_POTENCIOMETROS] = { 512, 512, 512, 512 };
+static uint32_t periodoRampaMs = 0;
+static struct timespec inicio;
+static volatile sig_atomic_t terminar = 0;
+
+// Prximo evento de cada perifrico (ns de tiempo simulado)
+static uint64_t proximoTick;
+static uint64_t proximaTrama;
+static uint64_t proximoDesborde0;
+static uint64_t finConversion;
+static uint64_t proximoRx;
+static uint64_t proximoTx;
+static uint64_t listoEEPROM;
+
+// Servos
+static uint16_t pulsoUs[NUM_SERVOS];
+static double anguloModelado[NUM_SERVOS];
+static uint16_t pulsoRegistrado[NUM_SERVOS];
+static double anguloRegistrado[NUM_SERVOS];
+static uint64_t ultimaTrama;
+
+static uint32_t bytesRx = 0;
+static uint32_t bytesTx = 0;
+static uint32_t descartadosTx = 0;
+
+static uint64_t ahoraNs(void) {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	double real = (double)(t.tv_sec - inicio.tv_sec) * 1e9 + (double)(t.tv_nsec - inicio.tv_nsec);
+	return (uint64_t)(real * velocidad);
+}
+
+static uint64_t ciclosANs(uint64_t ciclos) {
+	return ciclos * NS_POR_CICLO_NUM / NS_POR_CICLO_DEN;
+}
+
+// Prescaler de Timer0/Timer1 segn CSx2:0 (0 = detenido)
+static uint16_t prescalerT01(uint8_t tccrb) {
+	static const uint16_t tabla[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+	return tabla[tccrb & 0x07];
+}
+
+// Prescaler de Timer2 segn CS22:20
+static uint16_t prescalerT2(uint8_t tccrb) {
+	static const uint16_t tabla[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+	return tabla[tccrb & 0x07];
+}
+
+// Tiempo de un byte (10 bits) con la configuracin actual de la USART
+static uint64_t nsPorByte(void) {
+	uint32_t ubrr = ((uint32_t)(HAL_UBRR0H & 0x0F) << 8) | HAL_UBRR0L;
+	uint32_t divisor = (HAL_UCSR0A & (1 << U2X0)) ? 8 : 16;
+	return ciclosANs((uint64_t)10 * divisor * (ubrr + 1));
+}
+
+// Reprogramar un evento peridico sin acumular atraso si la PC se detuvo
+static void avanzar(uint64_t* proximo, uint64_t periodo, uint64_t ahora) {
+	*proximo += periodo;
+	if (*proximo + periodo < ahora) {
+		*proximo = ahora;
+	}
+}
+
+static uint16_t leerPotenciometro(uint8_t canal, uint64_t ahora) {
+	if (canal >= NUM_POTENCIOMETROS) return 0;
+	if (periodoRampaMs == 0) return potenciometros[canal];
+	
+	// Rampa triangular 0-1023, desfasada un cuarto de periodo por canal
+	uint64_t periodo = (uint64_t)periodoRampaMs * 1000000ULL;
+	uint64_t fase = (ahora + periodo * canal / NUM_POTENCIOMETROS) % periodo;
+	uint64_t mitad = periodo / 2;
+	uint64_t valor = (fase < mitad) ? fase : periodo - fase;
+	return (uint16_t)(valor * 1023 / mitad);
+}
+
+// Anchos de pulso de la trama actual (PWM por hardware)
+static void pulsosHardware(void) {
+	uint16_t p0 = prescalerT01(HAL_TCCR0B);
+	uint16_t p1 = prescalerT01(HAL_TCCR1B);
+	
+	// Fast PWM no invertido: el pulso dura OCR + 1 cuentas
+	pulsoUs[0] = (uint16_t)(((uint32_t)HAL_OCR0B + 1) * p0 / 16);  // Base (OC0B)
+	pulsoUs[1] = (uint16_t)(((uint32_t)HAL_OCR0A + 1) * p0 / 16);  // Brazo1 (OC0A)
+	pulsoUs[2] = (uint16_t)(((uint32_t)HAL_OCR1A + 1) * p1 / 16);  // Brazo2 (OC1A)
+	pulsoUs[3] = (uint16_t)(((uint32_t)HAL_OCR1B + 1) * p1 / 16);  // Pinza (OC1B)
+}
+
+// Trama del SERVO_MUX: captura y luego las comparaciones de cada banco en orden
+static void tramaMux(void) {
+	uint16_t p1 = prescalerT01(HAL_TCCR1B);
+	uint8_t canalA = 0;
+	uint8_t canalB = 1;
+	
+	HAL_TCNT1 = 0;
+	TIMER1_CAPT_vect();
+	
+	for (uint8_t i = 0; i < MAX_COMPARACIONES && HAL_OCR1A != MUX_SIN_MATCH; i++) {
+		uint16_t fin = HAL_OCR1A;
+		if (canalA < NUM_SERVOS) pulsoUs[canalA] = (uint16_t)((uint32_t)(fin - HAL_TCNT1) * p1 / 16);
+		canalA += 2;
+		HAL_TCNT1 = fin;
+		if (!(HAL_TIMSK1 & (1 << OCIE1A))) break;
+		TIMER1_COMPA_vect();
+	}
+	
+	HAL_TCNT1 = 0;
+	for (uint8_t i = 0; i < MAX_COMPARACIONES && HAL_OCR1B != MUX_SIN_MATCH; i++) {
+		uint16_t fin = HAL_OCR1B;
+		if (canalB < NUM_SERVOS) pulsoUs[canalB] = (uint16_t)((uint32_t)(fin - HAL_TCNT1) * p1 / 16);
+		canalB += 2;
+		HAL_TCNT1 = fin;
+		if (!(HAL_TIMSK1 & (1 << OCIE1B))) break;
+		TIMER1_COMPB_vect();
+	}
+}
+
+// Servo modelado: sigue al pulso con velocidad mxima GRADOS_POR_SEGUNDO
+static void moverServos(uint64_t ahora) {
+	double dt = (double)(ahora - ultimaTrama) / 1e9;
+	ultimaTrama = ahora;
+	
+	for (uint8_t i = 0; i < NUM_SERVOS; i++) {
+		double objetivo = (double)((int32_t)pulsoUs[i] - PULSO_MIN_US) * 180.0 / (PULSO_MAX_US - PULSO_MIN_US);
+		if (objetivo < 0) objetivo = 0;
+		if (objetivo > 180) objetivo = 180;
+		
+		double paso = GRADOS_POR_SEGUNDO * dt;
+		double error = objetivo - anguloModelado[i];
+		if (error > paso) error = paso;
+		if (error < -paso) error = -paso;
+		anguloModelado[i] += error;
+	}
+}
+
+// Registrar la trama si cambi algn pulso o algn servo sigue en movimiento
+static void registrarServos(uint64_t ahora) {
+	if (!registro) return;
+	
+	uint8_t cambio = 0;
+	for (uint8_t i = 0; i < NUM_SERVOS; i++) {
+		if (pulsoUs[i] != pulsoRegistrado[i] || anguloModelado[i] != anguloRegistrado[i]) {
+			cambio = 1;
+		}
+	}
+	if (!cambio) return;
+	
+	fprintf(registro, "%llu,%u,%u,%u,%u", (unsigned long long)(ahora / 1000),
+	HAL_OCR0B, HAL_OCR0A, HAL_OCR1A, HAL_OCR1B);
+	for (uint8_t i = 0; i < NUM_SERVOS; i++) {
+		fprintf(registro, ",%u", pulsoUs[i]);
+		pulsoRegistrado[i] = pulsoUs[i];
+	}
+	for (uint8_t i = 0; i < NUM_SERVOS; i++) {
+		fprintf(registro, ",%.1f", anguloModelado[i]);
+		anguloRegistrado[i] = anguloModelado[i];
+	}
+	fprintf(registro, "\n");
+}
+
+// Timer1 sin salidas OC1A/OC1B y con captura habilitada: secuenciador SERVO_MUX
+static uint8_t modoMux(void) {
+	return !(HAL_TCCR1A & ((1 << COM1A1) | (1 << COM1B1))) && (HAL_TIMSK1 & (1 << ICIE1));
+}
+
+static void tramaTimer1(uint64_t ahora) {
+	if (modoMux()) {
+		tramaMux();
+		} else {
+		pulsosHardware();
+		if (HAL_TIMSK1 & (1 << TOIE1)) {
+			TIMER1_OVF_vect();
+		}
+	}
+	
+	moverServos(ahora);
+	registrarServos(ahora);
+}
+
+static void atenderADC(uint64_t ahora) {
+	if (!(HAL_ADCSRA & (1 << ADEN)) || !(HAL_ADCSRA & (1 << ADSC))) {
+		finConversion = 0;
+		return;
+	}
+	
+	// 13 ciclos del reloj del ADC por conversin
+	if (finConversion == 0) {
+		uint16_t prescaler = 1 << (HAL_ADCSRA & 0x07);
+		if (prescaler == 1) prescaler = 2;
+		finConversion = ahora + ciclosANs((uint64_t)13 * prescaler);
+		return;
+	}
+	if (ahora < finConversion) return;
+	
+	finConversion = 0;
+	HAL_ADCW = leerPotenciometro(HAL_ADMUX & 0x0F, ahora);
+	HAL_ADCSRA &= ~(1 << ADSC);
+	if (HAL_ADCSRA & (1 << ADIE)) {
+		ADC_vect();
+	}
+}
+
+static void atenderUSART(uint64_t ahora) {
+	uint64_t porByte = nsPorByte();
+	
+	// Recepcin: un byte de la PTY por tiempo de byte
+	if ((HAL_UCSR0B & (1 << RXEN0)) && ahora >= proximoRx) {
+		uint8_t dato;
+		if (read(pty, &dato, 1) == 1) {
+			bytesRx++;
+			HAL_UDR0 = dato;
+			HAL_UCSR0A |= (1 << RXC0);
+			if (HAL_UCSR0B & (1 << RXCIE0)) {
+				USART_RX_vect();
+				HAL_UCSR0A &= ~(1 << RXC0);
+			}
+			avanzar(&proximoRx, porByte, ahora);
+			} else {
+			proximoRx = ahora + porByte;
+		}
+	}
+	
+	// Transmisin: el ISR escribe UDR0 o apaga UDRIE0 si el buffer qued vaco
+	if ((HAL_UCSR0B & (1 << UDRIE0)) && ahora >= proximoTx) {
+		USART_UDRE_vect();
+		if (HAL_UCSR0B & (1 << UDRIE0)) {
+			uint8_t dato = HAL_UDR0;
+			if (write(pty, &dato, 1) == 1) {
+				bytesTx++;
+				} else {
+				descartadosTx++;
+			}
+			avanzar(&proximoTx, porByte, ahora);
+		}
+	}
+	if (!(HAL_UCSR0B & (1 << UDRIE0)) && proximoTx < ahora) {
+		proximoTx = ahora;
+	}
+	
+	// El registro de transmisin siempre est libre para las esperas activas
+	HAL_UCSR0A |= (1 << UDRE0);
+}
+
+// Modelo de perifricos: se ejecuta con el bit I en 0, como una interrupcin
+static void modelo(void) {
+	uint64_t ahora = ahoraNs();
+	
+	// Botones sueltos: entradas con pull-up leen 1, salidas leen PORTx
+	HAL_PINB = HAL_PORTB;
+	HAL_PINC = HAL_PORTC;
+	HAL_PIND = HAL_PORTD;
+	
+	// Tick del planificador
+	uint16_t p2 = prescalerT2(HAL_TCCR2B);
+	if (p2) {
+		uint64_t periodo = ciclosANs((uint64_t)(HAL_OCR2A + 1) * p2);
+		if (ahora >= proximoTick) {
+			avanzar(&proximoTick, periodo, ahora);
+			if (HAL_TIMSK2 & (1 << OCIE2A)) {
+				TIMER2_COMPA_vect();
+			}
+		}
+	}
+	
+	// Periodo del Timer0 (Fast PWM de 8 bits)
+	uint16_t p0 = prescalerT01(HAL_TCCR0B);
+	if (p0) {
+		uint64_t periodo = ciclosANs((uint64_t)256 * p0);
+		if (ahora >= proximoDesborde0) {
+			avanzar(&proximoDesborde0, periodo, ahora);
+			if (HAL_TIMSK0 & (1 << TOIE0)) {
+				TIMER0_OVF_vect();
+			}
+		}
+	}
+	
+	// Trama de servos
+	uint16_t p1 = prescalerT01(HAL_TCCR1B);
+	if (p1 && HAL_ICR1) {
+		uint64_t periodo = ciclosANs((uint64_t)(HAL_ICR1 + 1) * p1);
+		if (ahora >= proximaTrama) {
+			avanzar(&proximaTrama, periodo, ahora);
+			tramaTimer1(ahora);
+		}
+		
+		// TCNT1 avanza con el tiempo dentro de la trama (lo usa el perfilador)
+		if (!modoMux() && proximaTrama <= ahora + periodo) {
+			uint64_t cuentas = (ahora + periodo - proximaTrama) * 16 / ((uint64_t)p1 * 1000);
+			HAL_TCNT1 = (cuentas > HAL_ICR1) ? HAL_ICR1 : (uint16_t)cuentas;
+		}
+	}
+	
+	atenderADC(ahora);
+	atenderUSART(ahora);
+	
+	// EEPROM lista para el siguiente byte de la cola
+	if ((HAL_EECR & (1 << EERIE)) && ahora >= listoEEPROM) {
+		EE_READY_vect();
+		listoEEPROM = ahora + NS_ESCRITURA_EEPROM;
+	}
+}
+
+static void guardarEEPROM(void) {
+	if (!archivoEEPROM) return;
+	
+	FILE* f = fopen(archivoEEPROM, "wb");
+	if (!f) {
+		perror(archivoEEPROM);
+		return;
+	}
+	fwrite(HAL_eeprom, 1, sizeof(HAL_eeprom), f);
+	fclose(f);
+}
+
+static void cargarEEPROM(void) {
+	if (!archivoEEPROM) return;
+	
+	FILE* f = fopen(archivoEEPROM, "rb");
+	if (!f) return;  // Primera ejecucin: EEPROM borrada
+	if (fread(HAL_eeprom, 1, sizeof(HAL_eeprom), f) != sizeof(HAL_eeprom)) {
+		fprintf(stderr, "%s: imagen incompleta\n", archivoEEPROM);
+	}
+	fclose(f);
+}
+
+static void finalizar(void) {
+	// Terminar las escrituras pendientes antes de guardar la imagen
+	while (HAL_EECR & (1 << EERIE)) {
+		EE_READY_vect();
+	}
+	guardarEEPROM();
+	if (registro) fclose(registro);
+	if (enlace) unlink(enlace);
+	
+	fprintf(stderr, "Tiempo simulado: %.3f s, bytes recibidos: %u, enviados: %u, descartados: %u\n",
+	(double)ahoraNs() / 1e9, bytesRx, bytesTx, descartadosTx);
+	exit(0);
+}
+
+// Fin de una vuelta del lazo principal: dormir hasta el siguiente evento
+static void esperar(void) {
+	if (terminar) {
+		finalizar();
+	}
+	
+	uint64_t ahora = ahoraNs();
+	uint64_t siguiente = proximoTick;
+	if (proximaTrama < siguiente) siguiente = proximaTrama;
+	if ((HAL_TIMSK0 & (1 << TOIE0)) && proximoDesborde0 < siguiente) siguiente = proximoDesborde0;
+	if (finConversion && finConversion < siguiente) siguiente = finConversion;
+	if ((HAL_UCSR0B & (1 << UDRIE0)) && proximoTx < siguiente) siguiente = proximoTx;
+	if ((HAL_EECR & (1 << EERIE)) && listoEEPROM < siguiente) siguiente = listoEEPROM;
+	if (siguiente <= ahora) return;
+	
+	// La llegada de un byte por la PTY tambin despierta al firmware
+	uint64_t real = (uint64_t)((double)(siguiente - ahora) / velocidad);
+	struct timespec espera = { (time_t)(real / 1000000000ULL), (long)(real % 1000000000ULL) };
+	struct pollfd pfd = { pty, POLLIN, 0 };
+	if (ahora >= proximoRx) {
+		ppoll(&pfd, 1, &espera, NULL);
+		} else {
+		nanosleep(&espera, NULL);
+	}
+}
+
+static void senal(int numero) {
+	(void)numero;
+	terminar = 1;
+}
+
+static int abrirPTY(void) {
+	int fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+		perror("posix_openpt");
+		return -1;
+	}
+	
+	const char* nombre = ptsname(fd);
+	
+	// Mantener el esclavo abierto: sin cliente conectado la PTY no da EIO.
+	// Modo crudo para que los comandos lleguen byte por byte sin eco
+	int esclavo = open(nombre, O_RDWR | O_NOCTTY);
+	if (esclavo >= 0) {
+		struct termios tio;
+		tcgetattr(esclavo, &tio);
+		cfmakeraw(&tio);
+		tcsetattr(esclavo, TCSANOW, &tio);
+	}
+	
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	
+	fprintf(stderr, "USART en %s\n", nombre);
+	if (enlace) {
+		unlink(enlace);
+		if (symlink(nombre, enlace) != 0) {
+			perror(enlace);
+			} else {
+			fprintf(stderr, "Enlace %s -> %s\n", enlace, nombre);
+		}
+	}
+	return fd;
+}
+
+int main(int argc, char* argv[]) {
+	int opcion;
+	while ((opcion = getopt(argc, argv, "l:o:e:x:p:r:")) != -1) {
+		switch (opcion) {
+			case 'l':
+			enlace = optarg;
+			break;
+			case 'o':
+			registro = fopen(optarg, "w");
+			if (!registro) {
+				perror(optarg);
+				return 1;
+			}
+			break;
+			case 'e':
+			archivoEEPROM = optarg;
+			break;
+			case 'x':
+			velocidad = atof(optarg);
+			if (velocidad <= 0) velocidad = 1.0;
+			break;
+			case 'p':
+			sscanf(optarg, "%hu,%hu,%hu,%hu", &potenciometros[0], &potenciometros[1],
+			&potenciometros[2], &potenciometros[3]);
+			break;
+			case 'r':
+			periodoRampaMs = (uint32_t)atoi(optarg);
+			break;
+			default:
+			fprintf(stderr, "Uso: %s [-l enlace] [-o servos.csv] [-e eeprom.bin] [-x velocidad] "
+			"[-p p0,p1,p2,p3] [-r periodo_ms]\n", argv[0]);
+			return 1;
+		}
+	}
+	
+	pty = abrirPTY();
+	if (pty < 0) return 1;
+	
+	if (registro) {
+		fprintf(registro, "t_us,ocr0b,ocr0a,ocr1a,ocr1b");
+		for (uint8_t i = 0; i < NUM_SERVOS; i++) fprintf(registro, ",pulso_%s_us", nombresServos[i]);
+		for (uint8_t i = 0; i < NUM_SERVOS; i++) fprintf(registro, ",angulo_%s", nombresServos[i]);
+		fprintf(registro, "\n");
+	}
+	
+	HAL_reset();
+	cargarEEPROM();
+	HAL_UCSR0A = (1 << UDRE0);
+	
+	signal(SIGINT, senal);
+	signal(SIGTERM, senal);
+	
+	clock_gettime(CLOCK_MONOTONIC, &inicio);
+	HAL_setInterruptHook(modelo);
+	HAL_setIdleHook(esperar);
+	
+	// El firmware no regresa: el programa termina desde esperar()
+	return HAL_main();
+}
@@ -12,6 +12,11 @@
 * de los potencimetros y conversin directa a valores de ngulo para
 * control de servomotores.
 *
+* Las conversiones se ejecutan de forma continua por interrupcin: cada vez
+* que termina una conversin, ADC_vect guarda el resultado en el buffer
+* circular del canal, selecciona el siguiente canal y arranca una nueva
+* conversin. As el lazo principal nunca espera al convertidor.
+*
 * Conexiones de Hardware:
 *   - ADC0: PC0 (Potencimetro Control Base)
 *   - ADC1: PC1 (Potencimetro Control Brazo1)
@@ -20,7 +25,18 @@
 ************************************************************************/
 
 #include "ADC.h"
-#include <util/delay.h>
+#include <stdlib.h>
+#include "../LBRY9/LUT.h"
+#include "../LBRY12/BENCH.h"
+
+// Tabla lectura ADC (0-1023) -> ngulo (0-180), generada en tiempo de compilacin
+#define ADC_A_ANGULO(v) (uint8_t)((uint32_t)(v) * 180 / 1023)
+static const uint8_t tablaAngulo[1024] PROGMEM = { LUT_1024(ADC_A_ANGULO) };
+
+// Buffers circulares de muestras por canal (llenados por ADC_vect)
+static volatile uint16_t muestrasADC[ADC_NUM_CANALES][ADC_MUESTRAS_BUFFER];
+static volatile uint8_t indiceMuestra[ADC_NUM_CANALES];
+static volatile uint8_t canalActual = 0;
 
 void ADC_init(void) {
 	// Configurar los pines como entradas (PC0-PC3)
@@ -29,57 +45,94 @@ void ADC_init(void) {
 	// Deshabilitar pull-ups internos
 	PORTC &= ~((1 << PORTC0) | (1 << PORTC1) | (1 << PORTC2) | (1 << PORTC3));
 	
-	// Configurar ADC
+	// Configurar ADC, comenzando por el canal 0
+	canalActual = 0;
 	ADMUX = (0 << REFS1) | (1 << REFS0); // Referencia AVCC
 	ADCSRA = (1 << ADEN) |                // Habilitar ADC
-	(0 << ADATE) |              // Deshabilitar auto-trigger
-	(0 << ADIF) |               // Limpiar flag de interrupcin
-	(0 << ADIE) |               // Deshabilitar interrupcin
+	(0 << ADATE) |              // Sin auto-trigger, el ISR arranca cada conversin
+	(1 << ADIF) |               // Limpiar flag de interrupcin
+	(1 << ADIE) |               // Habilitar interrupcin de fin de conversin
 	(1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0); // Prescaler 128
+	
+	// Iniciar la primera conversin, el resto las encadena el ISR
+	ADCSRA |= (1 << ADSC);
 }
 
 uint16_t ADC_read(uint8_t canal) {
-	// Seleccionar canal (0-7)
-	ADMUX = (ADMUX & 0xF0) | (canal & 0x0F);
+	// Solo los canales recorridos por el ISR tienen muestras
+	if (canal >= ADC_NUM_CANALES) return 0;
 	
-	// Iniciar conversin
-	ADCSRA |= (1 << ADSC);
-	
-	// Esperar a que la conversin termine
-	while (ADCSRA & (1 << ADSC));
+	// Leer la ltima muestra con interrupciones deshabilitadas (dato de 16 bits)
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t indice = (indiceMuestra[canal] - 1) & (ADC_MUESTRAS_BUFFER - 1);
+	uint16_t valor = muestrasADC[canal][indice];
+	SREG = sreg;
 	
-	// Leer resultado
-	return ADC;
+	return valor;
 }
 
 uint8_t ADC_Angulo(uint16_t ADC_VALUE) {
-	// Convertir valor ADC (0-1023) a ngulo (0-180)
-	return (uint8_t)((uint32_t)ADC_VALUE * 180 / 1023);
+	// Convertir valor ADC (0-1023) a ngulo (0-180) con la tabla en flash
+	if (ADC_VALUE > 1023) ADC_VALUE = 1023;
+	return pgm_read_byte(&tablaAngulo[ADC_VALUE]);
 }
 
 uint16_t ADC_read_Filtr(uint8_t canal, uint8_t numMuestras) {
-	uint32_t suma = 0;
+	if (canal >= ADC_NUM_CANALES) return 0;
+	BENCH_BEGIN(BENCH_FILTRO);
+	
+	// No se pueden promediar ms muestras de las que guarda el buffer
+	if (numMuestras == 0) numMuestras = 1;
+	if (numMuestras > ADC_MUESTRAS_BUFFER) numMuestras = ADC_MUESTRAS_BUFFER;
+	
+	uint16_t suma = 0;
 	
-	// Tomar varias muestras y promediar
+	// Promediar las ltimas muestras del buffer circular (sin esperar al ADC)
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t indice = indiceMuestra[canal];
 	for (uint8_t i = 0; i < numMuestras; i++) {
-		suma += ADC_read(canal);
-		_delay_ms(10); // Pequea pausa entre lecturas
+		indice = (indice - 1) & (ADC_MUESTRAS_BUFFER - 1);
+		suma += muestrasADC[canal][indice];
 	}
+	SREG = sreg;
 	
 	// Calcular el promedio
-	uint16_t valorFiltrado = (uint16_t)(suma / numMuestras);
+	uint16_t valorFiltrado = suma / numMuestras;
 	
 	// Tambin podemos aplicar un filtro de zona muerta para evitar pequeas fluctuaciones
-	static uint16_t valorAnterior[4] = {0, 0, 0, 0}; // Para 4 canales (0-3)
+	static uint16_t valorAnterior[ADC_NUM_CANALES] = {0, 0, 0, 0};
 	
 	// Si la diferencia es pequea, mantener el valor anterior
-	if (canal < 4) { // Asegurarse de que el canal est en rango
-		if (abs(valorFiltrado - valorAnterior[canal]) < 5) {
-			valorFiltrado = valorAnterior[canal];
-			} else {
-			valorAnterior[canal] = valorFiltrado;
-		}
+	if (abs((int16_t)(valorFiltrado - valorAnterior[canal])) < 5) {
+		valorFiltrado = valorAnterior[canal];
+		} else {
+		valorAnterior[canal] = valorFiltrado;
 	}
 	
+	BENCH_END(BENCH_FILTRO);
 	return valorFiltrado;
-}
\ No newline at end of file
+}
+
+// INTERRUPCIONES
+ISR(ADC_vect) {
+	BENCH_BEGIN(BENCH_ISR_ADC);
+	
+	// Guardar la muestra del canal que acaba de convertirse
+	uint8_t canal = canalActual;
+	uint8_t indice = indiceMuestra[canal];
+	muestrasADC[canal][indice] = ADC;
+	indiceMuestra[canal] = (indice + 1) & (ADC_MUESTRAS_BUFFER - 1);
+	
+	// Pasar al siguiente canal (ADC0 -> ADC3 -> ADC0)
+	canal++;
+	if (canal >= ADC_NUM_CANALES) canal = 0;
+	canalActual = canal;
+	
+	// Seleccionar canal e iniciar la siguiente conversin
+	ADMUX = (ADMUX & 0xF0) | canal;
+	ADCSRA |= (1 << ADSC);
+	
+	BENCH_END(BENCH_ISR_ADC);
+}
@@ -11,6 +11,10 @@
 * analgico-digital, lectura de canales, filtrado de seales y conversin
 * de valores digitales a ngulos para control de servomotores.
 *
+* Las conversiones se realizan en segundo plano mediante la interrupcin
+* ADC_vect, recorriendo los canales ADC0-ADC3 en forma circular. Las
+* funciones de lectura no bloquean: devuelven el ltimo valor disponible.
+*
 
 * Conexiones de Hardware Soportadas: 
 *   - ADC0: PC0 (Potencimetro Control Base)
@@ -21,7 +25,10 @@
 
 #ifndef ADC_H
 #define ADC_H
-#include <avr/io.h>
+#include "../LBRY11/HAL.h"
+
+#define ADC_NUM_CANALES 4          // Canales recorridos por el motor de conversin (ADC0-ADC3)
+#define ADC_MUESTRAS_BUFFER 8      // Muestras guardadas por canal (potencia de 2)
 
 // PROTOTIPOS DE FUNCIONES
 void ADC_init(void);
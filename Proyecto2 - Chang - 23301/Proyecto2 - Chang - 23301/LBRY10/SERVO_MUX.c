@@ -0,0 +1,203 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa un secuenciador de servos por software sobre
+* el Timer1. Los servos se reparten en dos bancos: los canales pares usan
+* la comparacin A y los impares la comparacin B. Al inicio de cada trama
+* de 20 ms se levanta el pulso del primer servo de cada banco; cada
+* interrupcin de comparacin baja el pulso actual, levanta el del
+* siguiente servo del banco y programa su fin. As un solo temporizador
+* genera hasta 12 servos en pines arbitrarios con resolucin de 0.5 us.
+*
+* Funcionamiento por trama (banco A, banco B igual con OCR1B):
+*   t=0      : pin0 = 1, OCR1A = t + ancho0
+*   COMPA    : pin0 = 0, pin2 = 1, OCR1A = t + ancho2
+*   ...      : ltimo servo del banco -> OCR1A fuera de rango (sin ms
+*              interrupciones hasta la siguiente trama)
+*
+* Notas:
+* - Se usa modo CTC (WGM 12) porque en Fast PWM los registros OCR1x solo
+*   se actualizan al final de la trama y no permiten encadenar pulsos.
+* - Los anchos nuevos se copian al inicio de la trama (doble buffer), as
+*   un cambio nunca corta un pulso a la mitad.
+* - Los pines se manejan desde interrupciones: el resto del programa no
+*   debe escribir esos puertos con lectura-modificacin-escritura sin
+*   deshabilitar interrupciones.
+************************************************************************/
+
+#include "SERVO_MUX.h"
+#include "../LBRY2/TIMER0_PWM.h"
+#include "../LBRY9/LUT.h"
+#include "../LBRY12/BENCH.h"
+
+#define SERVO_MUX_TOP 39999         // 16MHz / 8 / 50Hz - 1
+#define SERVO_MUX_SIN_MATCH 0xFFFF  // Valor de comparacin que nunca se alcanza (TOP < 0xFFFF)
+
+typedef struct {
+	volatile uint8_t* puerto;
+	uint8_t mascara;
+	uint16_t ancho;                 // Ancho activo en la trama actual
+} CanalServo;
+
+static CanalServo canales[SERVO_MUX_MAX_CANALES];
+static volatile uint16_t anchoPendiente[SERVO_MUX_MAX_CANALES];
+static uint8_t numCanales = 0;
+static volatile uint8_t actualA = SERVO_MUX_SIN_CANAL;   // Canal con pulso activo en el banco A
+static volatile uint8_t actualB = SERVO_MUX_SIN_CANAL;   // Canal con pulso activo en el banco B
+static volatile ServoMuxCallback funcionTrama = 0;
+
+// Tabla ngulo (0-180) -> ticks con el mismo rango de pulso que los servos del Timer0
+// (SERVO_MIN_T0..SERVO_MAX_T0 en ticks de 64 us = 128 ticks de 0.5 us)
+#define MUX_T0_ANGULO(a) (uint16_t)((uint16_t)SERVO_MIN_T0 * 128 + (uint32_t)(SERVO_MAX_T0 - SERVO_MIN_T0) * 128 * (a) / 180)
+static const uint16_t tablaMuxT0[181] PROGMEM = { LUT_181(MUX_T0_ANGULO) };
+
+void SERVO_MUX_init(void) {
+	numCanales = 0;
+	actualA = SERVO_MUX_SIN_CANAL;
+	actualB = SERVO_MUX_SIN_CANAL;
+	
+	// Timer1 en modo CTC con TOP = ICR1 (WGM13:10 = 1100), prescaler 8, sin salidas OC1A/OC1B
+	TCCR1A = 0;
+	TCCR1B = (1 << WGM13) | (1 << WGM12) | (1 << CS11);
+	ICR1 = SERVO_MUX_TOP;
+	OCR1A = SERVO_MUX_SIN_MATCH;
+	OCR1B = SERVO_MUX_SIN_MATCH;
+	
+	// Inicio de trama (ICF1 se activa en TOP) y comparaciones A/B
+	TIFR1 = (1 << ICF1) | (1 << OCF1A) | (1 << OCF1B);
+	TIMSK1 = (1 << ICIE1) | (1 << OCIE1A) | (1 << OCIE1B);
+}
+
+uint8_t SERVO_MUX_attach(volatile uint8_t* ddr, volatile uint8_t* puerto, uint8_t pin) {
+	if (numCanales >= SERVO_MUX_MAX_CANALES) {
+		return SERVO_MUX_SIN_CANAL;
+	}
+	
+	uint8_t canal = numCanales;
+	uint8_t mascara = (1 << pin);
+	
+	// Salida en bajo
+	*puerto &= ~mascara;
+	*ddr |= mascara;
+	
+	canales[canal].puerto = puerto;
+	canales[canal].mascara = mascara;
+	canales[canal].ancho = SERVO_MUX_ANCHO_INICIAL;
+	anchoPendiente[canal] = SERVO_MUX_ANCHO_INICIAL;
+	
+	// Publicar el canal al final para que el ISR lo vea completo
+	uint8_t sreg = SREG;
+	cli();
+	numCanales = canal + 1;
+	SREG = sreg;
+	
+	return canal;
+}
+
+void SERVO_MUX_write(uint8_t canal, uint16_t ancho) {
+	if (canal >= numCanales) return;
+	
+	if (ancho < SERVO_MUX_ANCHO_MIN) ancho = SERVO_MUX_ANCHO_MIN;
+	if (ancho > SERVO_MUX_ANCHO_MAX) ancho = SERVO_MUX_ANCHO_MAX;
+	
+	// Se aplica al inicio de la siguiente trama
+	uint8_t sreg = SREG;
+	cli();
+	anchoPendiente[canal] = ancho;
+	SREG = sreg;
+}
+
+uint16_t SERVO_MUX_ticksT0(uint8_t angle) {
+	if (angle > 180) angle = 180;
+	
+	return pgm_read_word(&tablaMuxT0[angle]);
+}
+
+void SERVO_MUX_setFrameCallback(ServoMuxCallback funcion) {
+	funcionTrama = funcion;
+}
+
+// Levantar el pulso de un canal y programar su fin en el registro de comparacin
+static uint16_t iniciarPulso(uint8_t canal) {
+	*canales[canal].puerto |= canales[canal].mascara;
+	return TCNT1 + canales[canal].ancho;
+}
+
+// INTERRUPCIONES
+ISR(TIMER1_CAPT_vect) {
+	BENCH_BEGIN(BENCH_ISR_MUX);
+	
+	// Inicio de trama: arrancar el primer servo de cada banco
+	if (numCanales > 0) {
+		canales[0].ancho = anchoPendiente[0];
+		actualA = 0;
+		OCR1A = iniciarPulso(0);
+	}
+	if (numCanales > 1) {
+		canales[1].ancho = anchoPendiente[1];
+		actualB = 1;
+		OCR1B = iniciarPulso(1);
+	}
+	
+	// Copiar el resto de anchos nuevos (doble buffer)
+	for (uint8_t canal = 2; canal < numCanales; canal++) {
+		canales[canal].ancho = anchoPendiente[canal];
+	}
+	
+	// La funcin de trama corre con interrupciones habilitadas para que las
+	// comparaciones A/B terminen los pulsos a tiempo mientras se ejecuta
+	if (funcionTrama) {
+		sei();
+		funcionTrama();
+	}
+	BENCH_END(BENCH_ISR_MUX);
+}
+
+ISR(TIMER1_COMPA_vect) {
+	BENCH_BEGIN(BENCH_ISR_MUX_A);
+	uint8_t canal = actualA;
+	if (canal == SERVO_MUX_SIN_CANAL) {
+		BENCH_END(BENCH_ISR_MUX_A);
+		return;
+	}
+	
+	// Terminar el pulso actual y pasar al siguiente servo del banco A (canales pares)
+	*canales[canal].puerto &= ~canales[canal].mascara;
+	canal += 2;
+	
+	if (canal < numCanales) {
+		actualA = canal;
+		OCR1A = iniciarPulso(canal);
+		} else {
+		actualA = SERVO_MUX_SIN_CANAL;
+		OCR1A = SERVO_MUX_SIN_MATCH;
+	}
+	BENCH_END(BENCH_ISR_MUX_A);
+}
+
+ISR(TIMER1_COMPB_vect) {
+	BENCH_BEGIN(BENCH_ISR_MUX_B);
+	uint8_t canal = actualB;
+	if (canal == SERVO_MUX_SIN_CANAL) {
+		BENCH_END(BENCH_ISR_MUX_B);
+		return;
+	}
+	
+	// Terminar el pulso actual y pasar al siguiente servo del banco B (canales impares)
+	*canales[canal].puerto &= ~canales[canal].mascara;
+	canal += 2;
+	
+	if (canal < numCanales) {
+		actualB = canal;
+		OCR1B = iniciarPulso(canal);
+		} else {
+		actualB = SERVO_MUX_SIN_CANAL;
+		OCR1B = SERVO_MUX_SIN_MATCH;
+	}
+	BENCH_END(BENCH_ISR_MUX_B);
+}
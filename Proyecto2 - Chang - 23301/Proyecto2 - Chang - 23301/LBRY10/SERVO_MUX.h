@@ -0,0 +1,49 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica para el multiplexor de servos
+* por software. Proporciona funciones para asignar servos a cualquier pin
+* de salida y fijar el ancho de pulso de cada uno con resolucin de 0.5 us
+* usando un solo temporizador (Timer1), sin salidas de comparacin
+* dedicadas por servo.
+*
+* Se habilita en tiempo de compilacin con SERVO_MUX_ENABLE = 1. En ese
+* caso el Timer1 deja de generar PWM por hardware en OC1A/OC1B y el Timer0
+* queda libre; todos los servos se generan desde las interrupciones.
+*
+* Recursos de Hardware:
+*   - Timer1 en modo CTC con TOP = ICR1 (trama de 20 ms)
+*   - Interrupciones TIMER1_CAPT (inicio de trama), TIMER1_COMPA (banco A)
+*     y TIMER1_COMPB (banco B)
+************************************************************************/
+
+#ifndef SERVO_MUX_H
+#define SERVO_MUX_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+#ifndef SERVO_MUX_ENABLE
+#define SERVO_MUX_ENABLE 0          // 1: servos por multiplexor, 0: PWM por hardware
+#endif
+
+#define SERVO_MUX_POR_BANCO 6       // Servos por canal de comparacin (6 x 2.5 ms < 20 ms)
+#define SERVO_MUX_MAX_CANALES (2 * SERVO_MUX_POR_BANCO)
+#define SERVO_MUX_SIN_CANAL 0xFF
+#define SERVO_MUX_ANCHO_MIN 400     // 0.2 ms (ticks de 0.5 us)
+#define SERVO_MUX_ANCHO_MAX 5000    // 2.5 ms
+#define SERVO_MUX_ANCHO_INICIAL 3000 // 1.5 ms (centro)
+
+typedef void (*ServoMuxCallback)(void);
+
+void SERVO_MUX_init(void);                                          // Initialize Timer1 as servo sequencer
+uint8_t SERVO_MUX_attach(volatile uint8_t* ddr, volatile uint8_t* puerto, uint8_t pin); // Assign a servo to a pin, returns channel
+void SERVO_MUX_write(uint8_t canal, uint16_t ancho);                // Set pulse width in 0.5 us ticks
+uint16_t SERVO_MUX_ticksT0(uint8_t angle);                          // Angle to ticks with the Timer0 servo range
+void SERVO_MUX_setFrameCallback(ServoMuxCallback funcion);          // Call funcion at every 20 ms frame
+
+#endif // SERVO_MUX_H
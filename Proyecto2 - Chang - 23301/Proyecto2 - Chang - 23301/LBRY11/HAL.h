@@ -0,0 +1,38 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo es la capa de acceso al hardware que usan todas las
+* libreras y main.c en lugar de incluir directamente los encabezados de
+* avr-libc. En el microcontrolador solo incluye <avr/io.h>,
+* <avr/interrupt.h> y <avr/pgmspace.h>, as que el cdigo generado no
+* cambia.
+*
+* Compilando con HAL_HOST definido, los mismos nombres de registros,
+* bits, ISR(), sei()/cli() y PROGMEM se resuelven con HAL_HOST.h: los
+* registros son variables en memoria y las interrupciones son funciones
+* normales. As la lgica de las libreras se puede compilar y ejecutar
+* en una PC (por ejemplo con gcc -DHAL_HOST) sin modificarla.
+*
+* HAL_IDLE() marca el final de una vuelta del lazo principal. En el
+* microcontrolador no genera cdigo; en la PC permite que el modelo de
+* perifricos espere al siguiente evento en lugar de girar sin descanso.
+************************************************************************/
+
+#ifndef HAL_H
+#define HAL_H
+
+#ifdef HAL_HOST
+#include "HAL_HOST.h"
+#else
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#define HAL_IDLE() ((void)0)
+#endif
+
+#endif // HAL_H
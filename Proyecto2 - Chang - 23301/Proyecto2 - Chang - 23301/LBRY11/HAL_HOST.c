@@ -0,0 +1,165 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera contiene las variables que simulan los registros del
+* ATmega328P cuando el programa se compila para una PC (HAL_HOST). En el
+* microcontrolador este archivo queda vaco.
+************************************************************************/
+
+#ifdef HAL_HOST
+
+#include "HAL.h"
+
+volatile uint8_t HAL_DDRB;
+volatile uint8_t HAL_PORTB;
+volatile uint8_t HAL_PINB;
+volatile uint8_t HAL_DDRC;
+volatile uint8_t HAL_PORTC;
+volatile uint8_t HAL_PINC;
+volatile uint8_t HAL_DDRD;
+volatile uint8_t HAL_PORTD;
+volatile uint8_t HAL_PIND;
+volatile uint8_t HAL_ADMUX;
+volatile uint8_t HAL_ADCSRA;
+volatile uint8_t HAL_ADCSRB;
+volatile uint8_t HAL_DIDR0;
+volatile uint8_t HAL_TCCR0A;
+volatile uint8_t HAL_TCCR0B;
+volatile uint8_t HAL_OCR0A;
+volatile uint8_t HAL_OCR0B;
+volatile uint8_t HAL_TIMSK0;
+volatile uint8_t HAL_TIFR0;
+volatile uint8_t HAL_TCNT0;
+volatile uint8_t HAL_TCCR1A;
+volatile uint8_t HAL_TCCR1B;
+volatile uint8_t HAL_TCCR1C;
+volatile uint16_t HAL_ICR1;
+volatile uint16_t HAL_OCR1A;
+volatile uint16_t HAL_OCR1B;
+volatile uint16_t HAL_TCNT1;
+volatile uint8_t HAL_TIMSK1;
+volatile uint8_t HAL_TIFR1;
+volatile uint8_t HAL_TCCR2A;
+volatile uint8_t HAL_TCCR2B;
+volatile uint8_t HAL_OCR2A;
+volatile uint8_t HAL_OCR2B;
+volatile uint8_t HAL_TIMSK2;
+volatile uint8_t HAL_TIFR2;
+volatile uint8_t HAL_TCNT2;
+volatile uint8_t HAL_UBRR0H;
+volatile uint8_t HAL_UBRR0L;
+volatile uint8_t HAL_UCSR0A;
+volatile uint8_t HAL_UCSR0B;
+volatile uint8_t HAL_UCSR0C;
+volatile uint8_t HAL_UDR0;
+volatile uint8_t HAL_EECR;
+volatile uint16_t HAL_EEAR;
+volatile uint8_t HAL_PCICR;
+volatile uint8_t HAL_PCMSK0;
+volatile uint8_t HAL_PCMSK1;
+volatile uint8_t HAL_PCMSK2;
+volatile uint8_t HAL_PCIFR;
+volatile uint8_t HAL_SREG;
+volatile uint8_t HAL_GPIOR0;
+volatile uint16_t HAL_ADCW;
+uint8_t HAL_eeprom[1024];
+
+static HalHook funcionInterrupciones = 0;
+static HalHook funcionEspera = 0;
+static uint8_t atendiendo = 0;
+
+// EECR: una escritura iniciada con EEPE termina de inmediato
+volatile uint8_t* HAL_eecr(void) {
+	HAL_EECR &= ~(1 << EEPE);
+	return &HAL_EECR;
+}
+
+// SREG: con interrupciones habilitadas, dejar que el modelo de perifricos
+// ejecute las rutinas pendientes antes de la lectura
+volatile uint8_t* HAL_sreg(void) {
+	if ((HAL_SREG & (1 << SREG_I)) && funcionInterrupciones && !atendiendo) {
+		atendiendo = 1;
+		HAL_SREG &= ~(1 << SREG_I);
+		funcionInterrupciones();
+		HAL_SREG |= (1 << SREG_I);
+		atendiendo = 0;
+	}
+	return &HAL_SREG;
+}
+
+void HAL_setInterruptHook(HalHook funcion) {
+	funcionInterrupciones = funcion;
+}
+
+void HAL_setIdleHook(HalHook funcion) {
+	funcionEspera = funcion;
+}
+
+void HAL_idle(void) {
+	if (funcionEspera) {
+		funcionEspera();
+	}
+}
+
+void HAL_reset(void) {
+	HAL_DDRB = 0;
+	HAL_PORTB = 0;
+	HAL_PINB = 0;
+	HAL_DDRC = 0;
+	HAL_PORTC = 0;
+	HAL_PINC = 0;
+	HAL_DDRD = 0;
+	HAL_PORTD = 0;
+	HAL_PIND = 0;
+	HAL_ADMUX = 0;
+	HAL_ADCSRA = 0;
+	HAL_ADCSRB = 0;
+	HAL_DIDR0 = 0;
+	HAL_TCCR0A = 0;
+	HAL_TCCR0B = 0;
+	HAL_OCR0A = 0;
+	HAL_OCR0B = 0;
+	HAL_TIMSK0 = 0;
+	HAL_TIFR0 = 0;
+	HAL_TCNT0 = 0;
+	HAL_TCCR1A = 0;
+	HAL_TCCR1B = 0;
+	HAL_TCCR1C = 0;
+	HAL_ICR1 = 0;
+	HAL_OCR1A = 0;
+	HAL_OCR1B = 0;
+	HAL_TCNT1 = 0;
+	HAL_TIMSK1 = 0;
+	HAL_TIFR1 = 0;
+	HAL_TCCR2A = 0;
+	HAL_TCCR2B = 0;
+	HAL_OCR2A = 0;
+	HAL_OCR2B = 0;
+	HAL_TIMSK2 = 0;
+	HAL_TIFR2 = 0;
+	HAL_TCNT2 = 0;
+	HAL_UBRR0H = 0;
+	HAL_UBRR0L = 0;
+	HAL_UCSR0A = 0;
+	HAL_UCSR0B = 0;
+	HAL_UCSR0C = 0;
+	HAL_UDR0 = 0;
+	HAL_EECR = 0;
+	HAL_EEAR = 0;
+	HAL_PCICR = 0;
+	HAL_PCMSK0 = 0;
+	HAL_PCMSK1 = 0;
+	HAL_PCMSK2 = 0;
+	HAL_PCIFR = 0;
+	HAL_SREG = 0;
+	HAL_GPIOR0 = 0;
+	HAL_ADCW = 0;
+	memset(HAL_eeprom, 0xFF, sizeof(HAL_eeprom));
+}
+
+#endif // HAL_HOST
@@ -0,0 +1,415 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define el modelo de registros del ATmega328P que usa la
+* capa HAL.h cuando se compila para una PC (HAL_HOST definido). Cada
+* registro es una variable; el programa de prueba las escribe (por
+* ejemplo ADC o PIND) y llama directamente a las rutinas de interrupcin,
+* que con ISR() quedan declaradas como funciones normales.
+*
+* Comportamiento simulado:
+*   - sei()/cli() cambian el bit I de SREG, as las secciones atmicas
+*     (sreg = SREG; cli(); ... SREG = sreg;) funcionan igual que en el AVR
+*   - La EEPROM es el arreglo HAL_eeprom: EEDR lee y escribe la celda
+*     EEAR y las escrituras terminan al instante (EEPE se lee en 0)
+*   - PROGMEM, pgm_read_*() y las funciones _P acceden a memoria normal
+*   - Un programa de PC puede registrar un modelo de perifricos con
+*     HAL_setInterruptHook(). Se llama cada vez que el firmware lee SREG
+*     con el bit I en 1 (con I en 0 durante la llamada, como en el AVR) y
+*     ah decide qu rutinas de interrupcin ejecutar. As las esperas
+*     activas del firmware (por ejemplo la cola de transmisin llena)
+*     avanzan igual que en el microcontrolador
+*   - El main() del firmware se renombra HAL_main() para que el programa
+*     de PC tenga el suyo (definir HAL_HOST_PROGRAMA en ese archivo)
+************************************************************************/
+
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+#include <stdint.h>
+#include <string.h>
+
+// Registros (definidos en HAL_HOST.c)
+extern volatile uint8_t HAL_DDRB;
+extern volatile uint8_t HAL_PORTB;
+extern volatile uint8_t HAL_PINB;
+extern volatile uint8_t HAL_DDRC;
+extern volatile uint8_t HAL_PORTC;
+extern volatile uint8_t HAL_PINC;
+extern volatile uint8_t HAL_DDRD;
+extern volatile uint8_t HAL_PORTD;
+extern volatile uint8_t HAL_PIND;
+extern volatile uint8_t HAL_ADMUX;
+extern volatile uint8_t HAL_ADCSRA;
+extern volatile uint8_t HAL_ADCSRB;
+extern volatile uint8_t HAL_DIDR0;
+extern volatile uint8_t HAL_TCCR0A;
+extern volatile uint8_t HAL_TCCR0B;
+extern volatile uint8_t HAL_OCR0A;
+extern volatile uint8_t HAL_OCR0B;
+extern volatile uint8_t HAL_TIMSK0;
+extern volatile uint8_t HAL_TIFR0;
+extern volatile uint8_t HAL_TCNT0;
+extern volatile uint8_t HAL_TCCR1A;
+extern volatile uint8_t HAL_TCCR1B;
+extern volatile uint8_t HAL_TCCR1C;
+extern volatile uint16_t HAL_ICR1;
+extern volatile uint16_t HAL_OCR1A;
+extern volatile uint16_t HAL_OCR1B;
+extern volatile uint16_t HAL_TCNT1;
+extern volatile uint8_t HAL_TIMSK1;
+extern volatile uint8_t HAL_TIFR1;
+extern volatile uint8_t HAL_TCCR2A;
+extern volatile uint8_t HAL_TCCR2B;
+extern volatile uint8_t HAL_OCR2A;
+extern volatile uint8_t HAL_OCR2B;
+extern volatile uint8_t HAL_TIMSK2;
+extern volatile uint8_t HAL_TIFR2;
+extern volatile uint8_t HAL_TCNT2;
+extern volatile uint8_t HAL_UBRR0H;
+extern volatile uint8_t HAL_UBRR0L;
+extern volatile uint8_t HAL_UCSR0A;
+extern volatile uint8_t HAL_UCSR0B;
+extern volatile uint8_t HAL_UCSR0C;
+extern volatile uint8_t HAL_UDR0;
+extern volatile uint8_t HAL_EECR;
+extern volatile uint16_t HAL_EEAR;
+extern volatile uint8_t HAL_PCICR;
+extern volatile uint8_t HAL_PCMSK0;
+extern volatile uint8_t HAL_PCMSK1;
+extern volatile uint8_t HAL_PCMSK2;
+extern volatile uint8_t HAL_PCIFR;
+extern volatile uint8_t HAL_SREG;
+extern volatile uint8_t HAL_GPIOR0;
+extern volatile uint16_t HAL_ADCW;
+extern uint8_t HAL_eeprom[1024];
+
+volatile uint8_t* HAL_eecr(void);
+volatile uint8_t* HAL_sreg(void);
+
+#define DDRB     HAL_DDRB
+#define PORTB    HAL_PORTB
+#define PINB     HAL_PINB
+#define DDRC     HAL_DDRC
+#define PORTC    HAL_PORTC
+#define PINC     HAL_PINC
+#define DDRD     HAL_DDRD
+#define PORTD    HAL_PORTD
+#define PIND     HAL_PIND
+#define ADMUX    HAL_ADMUX
+#define ADCSRA   HAL_ADCSRA
+#define ADCSRB   HAL_ADCSRB
+#define DIDR0    HAL_DIDR0
+#define TCCR0A   HAL_TCCR0A
+#define TCCR0B   HAL_TCCR0B
+#define OCR0A    HAL_OCR0A
+#define OCR0B    HAL_OCR0B
+#define TIMSK0   HAL_TIMSK0
+#define TIFR0    HAL_TIFR0
+#define TCNT0    HAL_TCNT0
+#define TCCR1A   HAL_TCCR1A
+#define TCCR1B   HAL_TCCR1B
+#define TCCR1C   HAL_TCCR1C
+#define ICR1     HAL_ICR1
+#define OCR1A    HAL_OCR1A
+#define OCR1B    HAL_OCR1B
+#define TCNT1    HAL_TCNT1
+#define TIMSK1   HAL_TIMSK1
+#define TIFR1    HAL_TIFR1
+#define TCCR2A   HAL_TCCR2A
+#define TCCR2B   HAL_TCCR2B
+#define OCR2A    HAL_OCR2A
+#define OCR2B    HAL_OCR2B
+#define TIMSK2   HAL_TIMSK2
+#define TIFR2    HAL_TIFR2
+#define TCNT2    HAL_TCNT2
+#define UBRR0H   HAL_UBRR0H
+#define UBRR0L   HAL_UBRR0L
+#define UCSR0A   HAL_UCSR0A
+#define UCSR0B   HAL_UCSR0B
+#define UCSR0C   HAL_UCSR0C
+#define UDR0     HAL_UDR0
+#define EEAR     HAL_EEAR
+#define PCICR    HAL_PCICR
+#define PCMSK0   HAL_PCMSK0
+#define PCMSK1   HAL_PCMSK1
+#define PCMSK2   HAL_PCMSK2
+#define PCIFR    HAL_PCIFR
+#define SREG     (*HAL_sreg())
+#define GPIOR0   HAL_GPIOR0
+#define ADC      HAL_ADCW
+#define ADCW     HAL_ADCW
+#define EECR     (*HAL_eecr())
+#define EEDR     HAL_eeprom[HAL_EEAR & 0x3FF]
+
+#define SREG_I   7
+#define E2END    0x3FF
+#define RAMEND   0x8FF
+#define _BV(b)   (1 << (b))
+
+// Bits de los puertos
+#define PB0      0
+#define PB1      1
+#define PB2      2
+#define PB3      3
+#define PB4      4
+#define PB5      5
+#define PB6      6
+#define PB7      7
+#define PINB0    0
+#define PINB1    1
+#define PINB2    2
+#define PINB3    3
+#define PINB4    4
+#define PINB5    5
+#define PINB6    6
+#define PINB7    7
+#define DDB0     0
+#define DDB1     1
+#define DDB2     2
+#define DDB3     3
+#define DDB4     4
+#define DDB5     5
+#define DDB6     6
+#define DDB7     7
+#define PORTB0   0
+#define PORTB1   1
+#define PORTB2   2
+#define PORTB3   3
+#define PORTB4   4
+#define PORTB5   5
+#define PORTB6   6
+#define PORTB7   7
+#define PC0      0
+#define PC1      1
+#define PC2      2
+#define PC3      3
+#define PC4      4
+#define PC5      5
+#define PC6      6
+#define PINC0    0
+#define PINC1    1
+#define PINC2    2
+#define PINC3    3
+#define PINC4    4
+#define PINC5    5
+#define PINC6    6
+#define DDC0     0
+#define DDC1     1
+#define DDC2     2
+#define DDC3     3
+#define DDC4     4
+#define DDC5     5
+#define DDC6     6
+#define PORTC0   0
+#define PORTC1   1
+#define PORTC2   2
+#define PORTC3   3
+#define PORTC4   4
+#define PORTC5   5
+#define PORTC6   6
+#define PD0      0
+#define PD1      1
+#define PD2      2
+#define PD3      3
+#define PD4      4
+#define PD5      5
+#define PD6      6
+#define PD7      7
+#define PIND0    0
+#define PIND1    1
+#define PIND2    2
+#define PIND3    3
+#define PIND4    4
+#define PIND5    5
+#define PIND6    6
+#define PIND7    7
+#define DDD0     0
+#define DDD1     1
+#define DDD2     2
+#define DDD3     3
+#define DDD4     4
+#define DDD5     5
+#define DDD6     6
+#define DDD7     7
+#define PORTD0   0
+#define PORTD1   1
+#define PORTD2   2
+#define PORTD3   3
+#define PORTD4   4
+#define PORTD5   5
+#define PORTD6   6
+#define PORTD7   7
+
+// ADC
+#define REFS1    7
+#define REFS0    6
+#define ADLAR    5
+#define MUX3     3
+#define MUX2     2
+#define MUX1     1
+#define MUX0     0
+#define ADEN     7
+#define ADSC     6
+#define ADATE    5
+#define ADIF     4
+#define ADIE     3
+#define ADPS2    2
+#define ADPS1    1
+#define ADPS0    0
+#define ADTS2    2
+#define ADTS1    1
+#define ADTS0    0
+#define ADC0D    0
+#define ADC1D    1
+#define ADC2D    2
+#define ADC3D    3
+
+// Timer0
+#define COM0A1   7
+#define COM0A0   6
+#define COM0B1   5
+#define COM0B0   4
+#define WGM01    1
+#define WGM00    0
+#define WGM02    3
+#define CS02     2
+#define CS01     1
+#define CS00     0
+#define TOIE0    0
+#define OCIE0A   1
+#define OCIE0B   2
+#define TOV0     0
+
+// Timer1
+#define COM1A1   7
+#define COM1A0   6
+#define COM1B1   5
+#define COM1B0   4
+#define WGM11    1
+#define WGM10    0
+#define WGM13    4
+#define WGM12    3
+#define CS12     2
+#define CS11     1
+#define CS10     0
+#define TOIE1    0
+#define OCIE1A   1
+#define OCIE1B   2
+#define ICIE1    5
+#define TOV1     0
+#define OCF1A    1
+#define OCF1B    2
+#define ICF1     5
+
+// Timer2
+#define COM2A1   7
+#define COM2A0   6
+#define WGM21    1
+#define WGM20    0
+#define WGM22    3
+#define CS22     2
+#define CS21     1
+#define CS20     0
+#define OCIE2A   1
+#define OCIE2B   2
+#define TOIE2    0
+#define OCF2A    1
+
+// USART0
+#define RXC0     7
+#define TXC0     6
+#define UDRE0    5
+#define FE0      4
+#define DOR0     3
+#define UPE0     2
+#define U2X0     1
+#define RXCIE0   7
+#define TXCIE0   6
+#define UDRIE0   5
+#define RXEN0    4
+#define TXEN0    3
+#define UCSZ02   2
+#define USBS0    3
+#define UCSZ01   2
+#define UCSZ00   1
+
+// EEPROM
+#define EERIE    3
+#define EEMPE    2
+#define EEPE     1
+#define EERE     0
+#define EEPM1    5
+#define EEPM0    4
+
+// Interrupciones por cambio de pin
+#define PCIE0    0
+#define PCIE1    1
+#define PCIE2    2
+#define PCIF0    0
+#define PCIF1    1
+#define PCIF2    2
+#define PCINT0   0
+#define PCINT1   1
+#define PCINT2   2
+#define PCINT3   3
+#define PCINT4   4
+#define PCINT5   5
+#define PCINT6   6
+#define PCINT7   7
+#define PCINT8   0
+#define PCINT9   1
+#define PCINT10  2
+#define PCINT11  3
+#define PCINT12  4
+#define PCINT13  5
+#define PCINT14  6
+#define PCINT15  7
+#define PCINT16  0
+#define PCINT17  1
+#define PCINT18  2
+#define PCINT19  3
+#define PCINT20  4
+#define PCINT21  5
+#define PCINT22  6
+#define PCINT23  7
+
+// Interrupciones: funciones normales que el programa de prueba puede llamar
+#define ISR(vector, ...) void vector(void); void vector(void)
+#define sei() (HAL_SREG |= (1 << SREG_I))
+#define cli() (HAL_SREG &= ~(1 << SREG_I))
+
+// Memoria de programa
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(direccion) (*(const uint8_t*)(direccion))
+#define pgm_read_word(direccion) (*(const uint16_t*)(direccion))
+#define pgm_read_dword(direccion) (*(const uint32_t*)(direccion))
+#define pgm_read_ptr(direccion) (*(void* const*)(direccion))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define sprintf_P sprintf
+
+// Punto de espera del lazo principal
+#define HAL_IDLE() HAL_idle()
+
+// main() del firmware
+#ifndef HAL_HOST_PROGRAMA
+#define main HAL_main
+#endif
+
+typedef void (*HalHook)(void);
+
+void HAL_reset(void);                       // Clear all registers and erase the EEPROM (0xFF)
+void HAL_setInterruptHook(HalHook funcion); // Peripheral model run when interrupts are enabled
+void HAL_setIdleHook(HalHook funcion);      // Called from HAL_IDLE() in the main loop
+void HAL_idle(void);                        // Run the idle hook
+int HAL_main(void);                         // Firmware main()
+
+#endif // HAL_HOST_H
@@ -0,0 +1,87 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define los marcadores de medicin de rendimiento. Cada
+* seccin medida escribe su identificador en GPIOR0 al entrar y el mismo
+* identificador con BENCH_FIN al salir. Un simulador del AVR (ver
+* HOST/simavr_bench.c) observa las escrituras a GPIOR0 y calcula los
+* ciclos de cada operacin, la latencia de las interrupciones y el peor
+* tiempo de una vuelta del lazo principal.
+*
+* Se habilita en tiempo de compilacin con BENCH_ENABLE = 1. Cada
+* marcador es una sola instruccin OUT (1 ciclo); con BENCH_ENABLE = 0
+* los marcadores desaparecen y el programa no cambia. Los identificadores
+* no dependen del hardware, as que el programa de PC usa este mismo
+* archivo.
+*
+* Con PROFILER_ENABLE = 1 los mismos marcadores alimentan al perfilador
+* en el microcontrolador (LBRY13/PROFILER.h, comando "STATS"). Se puede
+* usar junto con BENCH_ENABLE o por separado.
+*
+* Identificadores:
+*   - 0x01-0x3F: Funciones del lazo principal
+*   - 0x40-0x7F: Rutinas de interrupcin (BENCH_ISR)
+*   - Bit 7 (BENCH_FIN): Fin de la seccin
+************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE 0              // 1: marcadores en GPIOR0, 0: sin medicin
+#endif
+
+#ifndef PROFILER_ENABLE
+#define PROFILER_ENABLE 0           // 1: perfilador en RAM (ver PROFILER.h)
+#endif
+
+#define BENCH_FIN 0x80
+#define BENCH_ISR 0x40
+
+// Funciones del lazo principal
+#define BENCH_LAZO 0x01             // Una vuelta completa de SCHED_run
+#define BENCH_SERVOS 0x02           // updateServos
+#define BENCH_COMANDO 0x03          // processCommand
+#define BENCH_FILTRO 0x04           // ADC_read_Filtr
+#define BENCH_SECUENCIA 0x05        // Tarea de LBRY20/PLAYBACK
+#define BENCH_BOTONES 0x06          // tareaBotones (cola de eventos)
+#define BENCH_MUESTREO 0x07         // Lectura de potencimetros (tareaADC)
+
+// Programas de prueba (HOST/format_bench.c), fuera del perfilador
+#define BENCH_FMT_SPRINTF 0x08      // Lnea con sprintf_P + sendUSARTString
+#define BENCH_FMT_FORMAT 0x09       // Misma lnea con LBRY16/FORMAT
+
+// Rutinas de interrupcin
+#define BENCH_ISR_RX (BENCH_ISR | 0x01)        // USART_RX_vect
+#define BENCH_ISR_UDRE (BENCH_ISR | 0x02)      // USART_UDRE_vect
+#define BENCH_ISR_ADC (BENCH_ISR | 0x03)       // ADC_vect
+#define BENCH_ISR_TICK (BENCH_ISR | 0x04)      // TIMER2_COMPA_vect
+#define BENCH_ISR_TRAMA (BENCH_ISR | 0x05)     // TIMER1_OVF_vect (motor de movimiento)
+#define BENCH_ISR_EEPROM (BENCH_ISR | 0x06)    // EE_READY_vect
+#define BENCH_ISR_PWM0 (BENCH_ISR | 0x07)      // TIMER0_OVF_vect (registros sombra del Timer0)
+#define BENCH_ISR_MUX (BENCH_ISR | 0x08)       // TIMER1_CAPT_vect (trama de LBRY10/SERVO_MUX)
+#define BENCH_ISR_MUX_A (BENCH_ISR | 0x09)     // TIMER1_COMPA_vect (servos pares)
+#define BENCH_ISR_MUX_B (BENCH_ISR | 0x0A)     // TIMER1_COMPB_vect (servos impares)
+
+#if BENCH_ENABLE
+#include "../LBRY11/HAL.h"
+#define BENCH_MARCA(valor) (GPIOR0 = (valor))
+#else
+#define BENCH_MARCA(valor) ((void)0)
+#endif
+
+#if PROFILER_ENABLE
+#include "../LBRY13/PROFILER.h"
+#define BENCH_BEGIN(id) do { BENCH_MARCA(id); PROF_begin(id); } while (0)
+#define BENCH_END(id) do { PROF_end(id); BENCH_MARCA((id) | BENCH_FIN); } while (0)
+#else
+#define BENCH_BEGIN(id) BENCH_MARCA(id)
+#define BENCH_END(id) BENCH_MARCA((id) | BENCH_FIN)
+#endif
+
+#endif // BENCH_H
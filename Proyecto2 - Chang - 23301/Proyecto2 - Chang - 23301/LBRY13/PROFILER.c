@@ -0,0 +1,179 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa el perfilador en el microcontrolador. Cada
+* etapa guarda el tiempo de entrada (TCNT1 y el tick del planificador) y
+* al salir acumula la duracin en cuentas del Timer1 (0.5 us). Los ciclos
+* se calculan solo al reportar.
+*
+* Clculo de la duracin:
+*   fino   = (TCNT1 salida - TCNT1 entrada) mdulo 40000
+*   tramas = tramas completas de 20 ms, redondeando con los ms del tick
+*   total  = tramas * 40000 + fino
+*
+* El promedio usa una suma de 32 bits; cuando est por desbordarse, la
+* suma y el nmero de muestras se dividen entre 2, as el promedio sigue
+* siendo vlido (con ms peso en las muestras recientes).
+************************************************************************/
+
+#include "PROFILER.h"
+
+#if PROFILER_ENABLE
+
+#include "../LBRY3/USART.h"
+#include "../LBRY7/SCHEDULER.h"
+#include "../LBRY12/BENCH.h"
+#include "../LBRY16/FORMAT.h"
+#include <string.h>
+
+typedef struct {
+	uint16_t inicioCuenta;          // TCNT1 al entrar
+	uint16_t inicioMs;              // Tick del planificador al entrar
+	uint32_t inicioISR;             // Tiempo de interrupciones acumulado al entrar
+	uint16_t cuenta;                // Ejecuciones (se satura en 65535)
+	uint16_t muestras;              // Muestras incluidas en total
+	uint32_t minimo;                // Cuentas del Timer1
+	uint32_t maximo;
+	uint32_t total;
+} Etapa;
+
+static Etapa etapas[PROF_NUM_ETAPAS];
+static uint32_t tiempoISR = 0;      // Cuentas del Timer1 dentro de interrupciones medidas
+
+// Nombres para el reporte (mismo orden que los ndices), en flash
+#define PROF_LARGO_NOMBRE 13
+static const char nombres[PROF_NUM_ETAPAS][PROF_LARGO_NOMBRE] PROGMEM = {
+	"lazo", "updateServos", "processCmd", "ADC_filtro", "reproduccion", "botones", "muestreoADC",
+	"ISR_RX", "ISR_UDRE", "ISR_ADC", "ISR_TICK", "ISR_TRAMA", "ISR_EEPROM", "ISR_PWM0",
+	"ISR_MUX", "ISR_MUX_A", "ISR_MUX_B"
+};
+
+// ndice de la etapa: lazo principal 0-6 (id 1-7), interrupciones 7-16 (id 1-10)
+static uint8_t indiceEtapa(uint8_t id) {
+	uint8_t n = id & ~(BENCH_ISR | BENCH_FIN);
+	if (n == 0) return PROF_NUM_ETAPAS;
+	if (id & BENCH_ISR) return (n <= PROF_NUM_ETAPAS - 7) ? (6 + n) : PROF_NUM_ETAPAS;
+	
+	return (n <= 7) ? (n - 1) : PROF_NUM_ETAPAS;
+}
+
+void PROF_begin(uint8_t id) {
+	uint8_t i = indiceEtapa(id);
+	if (i >= PROF_NUM_ETAPAS) return;
+	
+	uint8_t sreg = SREG;
+	cli();
+	etapas[i].inicioCuenta = TCNT1;
+	etapas[i].inicioMs = SCHED_ticks();
+	etapas[i].inicioISR = tiempoISR;
+	SREG = sreg;
+}
+
+void PROF_end(uint8_t id) {
+	uint8_t i = indiceEtapa(id);
+	if (i >= PROF_NUM_ETAPAS) return;
+	
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t finCuenta = TCNT1;
+	uint16_t ms = SCHED_ticks() - etapas[i].inicioMs;
+	Etapa* e = &etapas[i];
+	
+	uint16_t fino = (finCuenta >= e->inicioCuenta) ?
+	(finCuenta - e->inicioCuenta) :
+	(uint16_t)(finCuenta + PROF_CUENTAS_TRAMA - e->inicioCuenta);
+	uint32_t duracion = fino;
+	
+	// Con menos de 10 ms no cabe una trama completa: evitar la divisin
+	if (ms >= 10) {
+		uint32_t aproximado = (uint32_t)ms * PROF_CUENTAS_MS + PROF_CUENTAS_TRAMA / 2;
+		if (aproximado > fino) {
+			duracion += ((aproximado - fino) / PROF_CUENTAS_TRAMA) * PROF_CUENTAS_TRAMA;
+		}
+	}
+	
+	if (id & BENCH_ISR) {
+		// ISR_MUX corre la trama con interrupciones habilitadas: las
+		// anidadas ya estn sumadas y tambin dentro de duracion
+		if (e->inicioISR + duracion > tiempoISR) tiempoISR = e->inicioISR + duracion;
+		} else {
+		// Descontar las interrupciones que ocurrieron dentro de la etapa
+		uint32_t interrupciones = tiempoISR - e->inicioISR;
+		duracion = (duracion > interrupciones) ? (duracion - interrupciones) : 0;
+	}
+	
+	if (e->cuenta == 0 || duracion < e->minimo) e->minimo = duracion;
+	if (duracion > e->maximo) e->maximo = duracion;
+	if (e->cuenta < 0xFFFF) e->cuenta++;
+	
+	if (e->total + duracion < e->total || e->muestras == 0xFFFF) {
+		e->total >>= 1;
+		e->muestras >>= 1;
+	}
+	e->total += duracion;
+	e->muestras++;
+	
+	SREG = sreg;
+}
+
+uint8_t PROF_getStats(uint8_t id, ProfEstadistica* datos) {
+	uint8_t i = indiceEtapa(id);
+	if (i >= PROF_NUM_ETAPAS) return 0;
+	
+	uint8_t sreg = SREG;
+	cli();
+	Etapa e = etapas[i];
+	SREG = sreg;
+	
+	if (e.cuenta == 0) return 0;
+	
+	datos->cuenta = e.cuenta;
+	datos->minimo = e.minimo * PROF_CICLOS_POR_CUENTA;
+	datos->maximo = e.maximo * PROF_CICLOS_POR_CUENTA;
+	datos->promedio = (e.total / e.muestras) * PROF_CICLOS_POR_CUENTA;
+	return 1;
+}
+
+void PROF_reset(void) {
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t i = 0; i < PROF_NUM_ETAPAS; i++) {
+		etapas[i].cuenta = 0;
+		etapas[i].muestras = 0;
+		etapas[i].minimo = 0;
+		etapas[i].maximo = 0;
+		etapas[i].total = 0;
+	}
+	tiempoISR = 0;
+	SREG = sreg;
+}
+
+void PROF_report(void) {
+	char linea[FMT_MAX_LINEA];
+	
+	sendUSARTString_P(PSTR("\r\nEtapa            n        min        max       prom (ciclos)\r\n"));
+	for (uint8_t i = 0; i < PROF_NUM_ETAPAS; i++) {
+		// Reconstruir el id BENCH del ndice
+		uint8_t id = (i < 7) ? (i + 1) : (BENCH_ISR | (i - 6));
+		ProfEstadistica datos;
+		if (!PROF_getStats(id, &datos)) continue;
+		
+		// Misma tabla que "%-12s %5u %10lu %10lu %10lu", una fila por envo
+		memcpy_P(linea, nombres[i], PROF_LARGO_NOMBRE);
+		uint8_t largo = strlen(linea);
+		largo += FMT_spaces(linea + largo, 12 - largo);
+		largo += FMT_unsignedWidth(linea + largo, datos.cuenta, 6);
+		largo += FMT_unsignedWidth(linea + largo, datos.minimo, 11);
+		largo += FMT_unsignedWidth(linea + largo, datos.maximo, 11);
+		largo += FMT_unsignedWidth(linea + largo, datos.promedio, 11);
+		largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+		FMT_sendLine(linea, largo);
+	}
+}
+
+#endif // PROFILER_ENABLE
@@ -0,0 +1,55 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica del perfilador en el
+* microcontrolador. Usa los mismos puntos de medicin que BENCH.h
+* (BENCH_BEGIN/BENCH_END): con PROFILER_ENABLE = 1 cada marcador toma el
+* tiempo del Timer1 y el perfilador acumula en RAM la cuenta y los ciclos
+* mnimos, mximos y promedio de cada etapa. El comando "STATS" los
+* enva por USART.
+*
+* Con PROFILER_ENABLE = 0 (valor por defecto) los marcadores no generan
+* cdigo y este mdulo no ocupa RAM.
+*
+* Medicin del tiempo:
+*   - TCNT1 cuenta a 2 MHz (0.5 us = 8 ciclos) y se reinicia cada trama
+*     de 20 ms, en modo PWM y en modo SERVO_MUX
+*   - Las tramas completas se cuentan con el tick de 1 ms del
+*     planificador, as que se miden etapas de ms de 20 ms
+*   - A las etapas del lazo principal se les descuenta el tiempo de las
+*     interrupciones que ocurren a la mitad
+************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+#ifndef PROFILER_ENABLE
+#define PROFILER_ENABLE 0           // 1: estadsticas por etapa en RAM, 0: sin perfilador
+#endif
+
+#define PROF_CICLOS_POR_CUENTA 8    // Prescaler del Timer1
+#define PROF_CUENTAS_TRAMA 40000U   // ICR1 + 1 (trama de 20 ms)
+#define PROF_CUENTAS_MS 2000U       // Cuentas del Timer1 por tick del planificador
+#define PROF_NUM_ETAPAS 17          // 0-6: lazo principal (id 1-7), 7-16: interrupciones (id 1-10)
+
+typedef struct {
+	uint16_t cuenta;
+	uint32_t minimo;                // Ciclos
+	uint32_t maximo;
+	uint32_t promedio;
+} ProfEstadistica;
+
+void PROF_begin(uint8_t id);                                   // Stage entry (BENCH id)
+void PROF_end(uint8_t id);                                     // Stage exit (BENCH id)
+uint8_t PROF_getStats(uint8_t id, ProfEstadistica* datos);     // Copy stats of a stage, returns 0 if never run
+void PROF_reset(void);                                         // Clear all statistics
+void PROF_report(void);                                        // Send the statistics table over USART
+
+#endif // PROFILER_H
@@ -0,0 +1,216 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa la lectura de los botones por interrupciones.
+* Un flanco en cualquier botn (PCINT) activa el antirrebote, que corre
+* desde el tick de 1 ms del planificador mientras haya actividad; con los
+* botones sueltos el tick no hace nada ms que revisar una bandera.
+*
+* Antirrebote (registro de desplazamiento):
+*   Cada BOTONES_MUESTRA_MS se desplaza la lectura del pin en un byte por
+*   botn. 0xFF (8 muestras presionado) confirma la pulsacin y 0x00 la
+*   liberacin; cualquier valor intermedio es rebote y no cambia el estado.
+*
+* Mquina de estados por botn:
+*   SUELTO -> PRESIONADO      : 8 muestras seguidas presionado
+*   PRESIONADO -> SUELTO      : soltado antes de BOTONES_LARGO_MS, cuenta
+*                               un clic (el segundo clic genera BOTON_DOBLE);
+*                               sin pulsacin doble genera BOTON_CORTO
+*   PRESIONADO -> LARGO       : mantenido BOTONES_LARGO_MS (BOTON_LARGO)
+*   LARGO -> SUELTO           : soltado, sin evento
+*   SUELTO con un clic        : pasan BOTONES_DOBLE_MS sin otro -> BOTON_CORTO
+************************************************************************/
+
+#include "BUTTONS.h"
+#include "../LBRY7/SCHEDULER.h"
+
+#define ESTADO_SUELTO 0
+#define ESTADO_PRESIONADO 1
+#define ESTADO_LARGO 2
+
+#define COLA_MASCARA (BOTONES_COLA - 1)
+
+typedef struct {
+	uint8_t historia;               // ltimas 8 muestras (1 = presionado)
+	uint8_t estado;
+	uint8_t clic;                   // Clic corto esperando la ventana de doble pulsacin
+	uint16_t tiempo;                // ms en el estado actual
+} Boton;
+
+static Boton botones[BOTONES_NUM];
+static volatile uint8_t actividad = 0;   // 1: hay botones presionados o rebotando
+static uint8_t divisor = 0;
+
+static volatile uint8_t cola[BOTONES_COLA];
+static volatile uint8_t cabezaCola = 0;
+static volatile uint8_t finCola = 0;
+static volatile uint8_t perdidos = 0;
+
+// Estado actual de los pines: bit n = botn n presionado
+static uint8_t leerPines(void) {
+	uint8_t presionados = 0;
+	if (!(PINB & (1 << PINB0))) presionados |= (1 << BOTON_MODO);
+	if (!(PINB & (1 << PINB3))) presionados |= (1 << BOTON_GUARDAR);
+	if (!(PIND & (1 << PIND7))) presionados |= (1 << BOTON_REPRODUCIR);
+	return presionados;
+}
+
+// Encolar un evento (se llama desde el tick, con interrupciones deshabilitadas)
+static void encolar(uint8_t evento) {
+	uint8_t siguiente = (cabezaCola + 1) & COLA_MASCARA;
+	if (siguiente == finCola) {
+		if (perdidos < 0xFF) perdidos++;
+		return;
+	}
+	cola[cabezaCola] = evento;
+	cabezaCola = siguiente;
+}
+
+static void actualizarBoton(uint8_t n, uint8_t presionado) {
+	Boton* b = &botones[n];
+	b->historia = (b->historia << 1) | presionado;
+	if (b->tiempo < 0xFFFF - BOTONES_MUESTRA_MS) {
+		b->tiempo += BOTONES_MUESTRA_MS;
+	}
+	
+	switch (b->estado) {
+		case ESTADO_SUELTO:
+		if (b->historia == 0xFF) {
+			b->estado = ESTADO_PRESIONADO;
+			b->tiempo = 0;
+			} else if (b->clic && b->tiempo >= BOTONES_DOBLE_MS) {
+			// No lleg la segunda pulsacin
+			encolar(BOTON_EVENTO(n, BOTON_CORTO));
+			b->clic = 0;
+		}
+		break;
+		
+		case ESTADO_PRESIONADO:
+		if (b->historia == 0x00) {
+			b->estado = ESTADO_SUELTO;
+			b->tiempo = 0;
+			if (!(BOTONES_CON_DOBLE & (1 << n))) {
+				// Sin pulsacin doble: cada clic es un evento, sin esperar la ventana
+				encolar(BOTON_EVENTO(n, BOTON_CORTO));
+				} else if (b->clic) {
+				encolar(BOTON_EVENTO(n, BOTON_DOBLE));
+				b->clic = 0;
+				} else {
+				b->clic = 1;
+			}
+			} else if (b->tiempo >= BOTONES_LARGO_MS) {
+			// Un clic anterior pendiente queda como pulsacin corta
+			if (b->clic) {
+				encolar(BOTON_EVENTO(n, BOTON_CORTO));
+				b->clic = 0;
+			}
+			encolar(BOTON_EVENTO(n, BOTON_LARGO));
+			b->estado = ESTADO_LARGO;
+		}
+		break;
+		
+		case ESTADO_LARGO:
+		if (b->historia == 0x00) {
+			b->estado = ESTADO_SUELTO;
+			b->tiempo = 0;
+		}
+		break;
+		
+		default:
+		b->estado = ESTADO_SUELTO;
+		break;
+	}
+}
+
+// Antirrebote: llamado desde el ISR del tick de 1 ms
+static void tickBotones(void) {
+	if (!actividad) return;
+	
+	if (++divisor < BOTONES_MUESTRA_MS) return;
+	divisor = 0;
+	
+	uint8_t presionados = leerPines();
+	uint8_t ocupado = 0;
+	for (uint8_t n = 0; n < BOTONES_NUM; n++) {
+		actualizarBoton(n, (presionados >> n) & 1);
+		
+		Boton* b = &botones[n];
+		if (b->estado != ESTADO_SUELTO || b->clic || b->historia != 0) {
+			ocupado = 1;
+		}
+	}
+	
+	// Todo suelto y estable: esperar el siguiente flanco
+	if (!ocupado) {
+		actividad = 0;
+	}
+}
+
+void BUTTONS_init(void) {
+	// Entradas con pull-up interno
+	DDRB &= ~((1 << DDB0) | (1 << DDB3));
+	PORTB |= (1 << PORTB0) | (1 << PORTB3);
+	DDRD &= ~(1 << DDD7);
+	PORTD |= (1 << PORTD7);
+	
+	for (uint8_t n = 0; n < BOTONES_NUM; n++) {
+		botones[n].historia = 0;
+		botones[n].estado = ESTADO_SUELTO;
+		botones[n].clic = 0;
+		botones[n].tiempo = 0;
+	}
+	cabezaCola = 0;
+	finCola = 0;
+	perdidos = 0;
+	
+	// Interrupcin por cambio de pin en PB0, PB3 (PCINT0) y PD7 (PCINT2)
+	PCMSK0 |= (1 << PCINT0) | (1 << PCINT3);
+	PCMSK2 |= (1 << PCINT23);
+	PCIFR = (1 << PCIF0) | (1 << PCIF2);
+	PCICR |= (1 << PCIE0) | (1 << PCIE2);
+	
+	// Muestrear al arrancar por si un botn ya est presionado
+	actividad = 1;
+	SCHED_setTickCallback(tickBotones);
+}
+
+uint8_t BUTTONS_getEvent(uint8_t* evento) {
+	uint8_t sreg = SREG;
+	cli();
+	
+	if (finCola == cabezaCola) {
+		SREG = sreg;
+		return 0;
+	}
+	
+	*evento = cola[finCola];
+	finCola = (finCola + 1) & COLA_MASCARA;
+	SREG = sreg;
+	return 1;
+}
+
+uint8_t BUTTONS_isPressed(uint8_t boton) {
+	if (boton >= BOTONES_NUM) return 0;
+	
+	return botones[boton].estado != ESTADO_SUELTO;
+}
+
+uint8_t BUTTONS_lostEvents(void) {
+	return perdidos;
+}
+
+// INTERRUPCIONES
+ISR(PCINT0_vect) {
+	// Flanco en PB0 o PB3: arrancar el antirrebote
+	actividad = 1;
+}
+
+ISR(PCINT2_vect) {
+	// Flanco en PD7
+	actividad = 1;
+}
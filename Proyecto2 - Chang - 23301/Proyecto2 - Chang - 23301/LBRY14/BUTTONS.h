@@ -0,0 +1,60 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica para los botones de la garra.
+* Las interrupciones por cambio de pin detectan cada flanco aunque el
+* lazo principal est ocupado; el antirrebote corre en el tick de 1 ms
+* del planificador con un registro de desplazamiento por botn, y cada
+* pulsacin se guarda como evento en una cola.
+*
+* Eventos:
+*   - BOTON_CORTO: pulsacin corta (sin segunda pulsacin a tiempo en los
+*     botones de BOTONES_CON_DOBLE; en los dems, al soltar)
+*   - BOTON_DOBLE: dos pulsaciones cortas en menos de BOTONES_DOBLE_MS,
+*     solo en los botones de BOTONES_CON_DOBLE
+*   - BOTON_LARGO: botn mantenido BOTONES_LARGO_MS (se genera sin soltar)
+*
+* Recursos de Hardware:
+*   - PB0 (modo) y PB3 (guardar): PCINT0 y PCINT3, interrupcin PCINT0
+*   - PD7 (reproducir): PCINT23, interrupcin PCINT2
+*   - Tick de 1 ms del Timer2 (SCHED_setTickCallback)
+************************************************************************/
+
+#ifndef BUTTONS_H
+#define BUTTONS_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+// Botones (pull-up interno: 0 es presionado)
+#define BOTON_MODO 0                // PB0
+#define BOTON_GUARDAR 1             // PB3
+#define BOTON_REPRODUCIR 2          // PD7
+#define BOTONES_NUM 3
+
+// Tipos de evento
+#define BOTON_CORTO 1
+#define BOTON_DOBLE 2
+#define BOTON_LARGO 3
+
+// Evento empaquetado: botn en el nibble alto, tipo en el bajo
+#define BOTON_EVENTO(boton, tipo) (uint8_t)(((boton) << 4) | (tipo))
+#define BOTON_DE(evento) ((evento) >> 4)
+#define TIPO_DE(evento) ((evento) & 0x0F)
+
+#define BOTONES_MUESTRA_MS 2        // Periodo de muestreo del antirrebote
+#define BOTONES_DOBLE_MS 300        // Ventana para la segunda pulsacin
+#define BOTONES_CON_DOBLE (1 << BOTON_REPRODUCIR) // Botones con pulsacin doble
+#define BOTONES_LARGO_MS 800        // Tiempo mantenido para pulsacin larga
+#define BOTONES_COLA 8              // Eventos en cola (potencia de 2)
+
+void BUTTONS_init(void);                                     // Configure pins, PCINT and debounce tick
+uint8_t BUTTONS_getEvent(uint8_t* evento);                   // Pop next event, returns 0 if queue is empty
+uint8_t BUTTONS_isPressed(uint8_t boton);                    // Debounced state of one button
+uint8_t BUTTONS_lostEvents(void);                            // Events dropped because the queue was full
+
+#endif // BUTTONS_H
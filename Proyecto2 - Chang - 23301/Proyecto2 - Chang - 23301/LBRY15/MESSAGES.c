@@ -0,0 +1,104 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera contiene los textos del men y de la ayuda de cada modo.
+* Tanto las cadenas como la tabla de punteros estn en PROGMEM: la tabla
+* se lee con pgm_read_ptr y la cadena se enva byte a byte desde la flash.
+*
+* Cada bloque de ayuda existe una sola vez; el cambio de modo por botn,
+* la seleccin desde el men y los comandos invlidos usan los mismos
+* bloques.
+************************************************************************/
+
+#include "MESSAGES.h"
+#include "../LBRY3/USART.h"
+#include "../LBRY13/PROFILER.h"
+#include <stddef.h>
+
+static const char msgMenu[] PROGMEM =
+"\r\n--- PROYECTO #2 IE2023 - GARRA ROBOTICA ---\r\n"
+"Presione el numero de la opcion que quiere realizar:\r\n"
+"1. Controlar garra con Pots (Modo Manual)\r\n"
+"2. Establecer una nueva posicion por USART\r\n"
+"3. Modo EEPROM (guardar/cargar posiciones)\r\n"
+"Tambin puede presionar el botn conectado a PB0 para cambiar de modo\r\n"
+"(mantenido vuelve al menu; PD7 doble reproduce todo, PB3 mantenido borra todo)\r\n"
+#if PROFILER_ENABLE
+"STATS - Tiempos por etapa (STATS,0 los reinicia)\r\n"
+#endif
+"T,ms,campos,formato - Telemetria periodica (T,0 la detiene)\r\n"
+"M,modo,ms - Movimiento coordinado (M,1: los ejes llegan juntos; M,0: independiente)\r\n"
+"CAL - Calibracion de servos (CAL,n,min,max,centro,inv,inf,sup; CAL,G guarda; CAL,D por defecto)\r\n"
+"Ingrese opcion: ";
+
+static const char msgPrefijoBoton[] PROGMEM = "\r\n[BOTON] ";
+
+static const char msgModoManual[] PROGMEM = "Modo de control por potenciometros activado\r\n";
+static const char msgModoUSART[] PROGMEM = "Modo de control por USART activado\r\n";
+static const char msgModoEEPROM[] PROGMEM = "Modo EEPROM activado\r\n";
+
+static const char msgAyudaUSART[] PROGMEM =
+"Formato: S,base,brazo1,brazo2,pinza\r\n"
+"Ejemplo: S,90,45,120,30\r\n"
+"Perfil: V,velocidad,aceleracion (grados/s, grados/s2)\r\n"
+"Cartesiano: X,x,y,z,pinza (mm; y hacia el frente, z desde la mesa)\r\n"
+"Geometria: K,brazo1,brazo2,altura del hombro (mm)\r\n";
+
+static const char msgAyudaEEPROM[] PROGMEM =
+"Comandos disponibles:\r\n"
+"G,n - Guardar posicion actual en la posicion n\r\n"
+"C,n - Cargar posicion n\r\n"
+"E - Ejecutar secuencia de posiciones guardadas\r\n"
+"B - Borrar todas las posiciones guardadas\r\n"
+"L - Listar posiciones guardadas\r\n"
+"N,nombre - Guardar las posiciones como secuencia\r\n"
+"R,nombre - Reproducir secuencia\r\n"
+"P - Pausar/continuar, P,n - Ir al cuadro n, F - Detener\r\n"
+"O,modo,veces,porcentaje - Repeticion (0 una vez, 1 bucle, 2 ida y vuelta; 0 veces = sin fin)\r\n"
+"  y velocidad de reproduccion (25-400 %, opcional)\r\n"
+"D,nombre - Borrar secuencia\r\n"
+"Q - Listar secuencias\r\n"
+"FORMATEAR - Borrar posiciones y secuencias y dar formato a la EEPROM\r\n";
+
+static const char msgAyudaGuardar[] PROGMEM = "Presiona el boton en PB3 para guardar la posicion actual en EEPROM\r\n";
+static const char msgAyudaReproducir[] PROGMEM = "Presiona el boton en PD7 para reproducir las posiciones guardadas una por una\r\n"
+"(O,modo,veces,porcentaje: repeticion y velocidad de la reproduccion)\r\n";
+static const char msgAyudaVolver[] PROGMEM = "Escribe 'menu' para volver al menu principal\r\n";
+static const char msgComandoInvalido[] PROGMEM = "\r\nComando no valido\r\n";
+static const char msgEEPROMInvalida[] PROGMEM =
+"\r\nEEPROM con formato desconocido o cabecera danada: no se guardara nada\r\n"
+"hasta usar FORMATEAR en el modo EEPROM (borra posiciones y secuencias)\r\n";
+
+// Mismo orden que los identificadores MSG_*
+static const char* const tablaMensajes[MSG_NUM] PROGMEM = {
+	msgMenu,
+	msgPrefijoBoton,
+	msgModoManual,
+	msgModoUSART,
+	msgModoEEPROM,
+	msgAyudaUSART,
+	msgAyudaEEPROM,
+	msgAyudaGuardar,
+	msgAyudaReproducir,
+	msgAyudaVolver,
+	msgComandoInvalido,
+	msgEEPROMInvalida
+};
+
+const char* MSG_get(uint8_t id) {
+	if (id >= MSG_NUM) return NULL;
+	
+	return (const char*)pgm_read_ptr(&tablaMensajes[id]);
+}
+
+void MSG_send(uint8_t id) {
+	const char* mensaje = MSG_get(id);
+	if (mensaje != NULL) {
+		sendUSARTString_P(mensaje);
+	}
+}
@@ -0,0 +1,41 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica de la tabla de mensajes de la
+* terminal. El men y los bloques de ayuda de cada modo se guardan una
+* sola vez en memoria de programa (PROGMEM) y se envan directo desde la
+* flash con sendUSARTString_P, as que no ocupan SRAM.
+*
+* Los mensajes cortos que se usan en un solo lugar se escriben con
+* PSTR("...") en el mismo cdigo que los enva.
+************************************************************************/
+
+#ifndef MESSAGES_H
+#define MESSAGES_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+// Identificadores de los mensajes
+#define MSG_MENU 0                  // Men principal completo
+#define MSG_PREFIJO_BOTON 1         // "\r\n[BOTON] " (cambio de modo con el botn)
+#define MSG_MODO_MANUAL 2           // Ttulo de cada modo
+#define MSG_MODO_USART 3
+#define MSG_MODO_EEPROM 4
+#define MSG_AYUDA_USART 5           // Formato de los comandos S y V
+#define MSG_AYUDA_EEPROM 6          // Lista de comandos del modo EEPROM
+#define MSG_AYUDA_GUARDAR 7         // Botn PB3
+#define MSG_AYUDA_REPRODUCIR 8      // Botn PD7
+#define MSG_AYUDA_VOLVER 9          // Cmo volver al men
+#define MSG_COMANDO_INVALIDO 10
+#define MSG_EEPROM_INVALIDA 11      // Imagen en solo lectura hasta FORMATEAR
+#define MSG_NUM 12
+
+void MSG_send(uint8_t id);                                     // Send a message of the table over USART
+const char* MSG_get(uint8_t id);                               // Flash address of a message (NULL if invalid)
+
+#endif // MESSAGES_H
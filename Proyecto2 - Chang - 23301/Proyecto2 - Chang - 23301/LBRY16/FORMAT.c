@@ -0,0 +1,107 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera convierte enteros a texto decimal sin usar sprintf. El
+* AVR no tiene instruccin de divisin, as que cada dgito se obtiene
+* restando la potencia de 10 correspondiente (a lo ms 9 restas por
+* dgito). Las potencias estn en PROGMEM y la conversin empieza en la
+* primera potencia que cabe en el valor, de modo que los nmeros pequeos
+* (ngulos, ndices) solo recorren 2 o 3 potencias.
+************************************************************************/
+
+#include "FORMAT.h"
+#include "../LBRY3/USART.h"
+
+static const uint32_t potencias[FMT_MAX_DIGITOS - 1] PROGMEM = {
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL,
+	10000UL, 1000UL, 100UL, 10UL
+};
+
+uint8_t FMT_unsigned(char* destino, uint32_t valor) {
+	uint8_t largo = 0;
+	uint8_t i = 0;
+	
+	// Saltar las potencias mayores que el valor (sin ceros a la izquierda)
+	while (i < FMT_MAX_DIGITOS - 1 && valor < pgm_read_dword(&potencias[i])) {
+		i++;
+	}
+	
+	for (; i < FMT_MAX_DIGITOS - 1; i++) {
+		uint32_t potencia = pgm_read_dword(&potencias[i]);
+		char digito = '0';
+		while (valor >= potencia) {
+			valor -= potencia;
+			digito++;
+		}
+		destino[largo++] = digito;
+	}
+	
+	// Unidades
+	destino[largo++] = '0' + (uint8_t)valor;
+	return largo;
+}
+
+uint8_t FMT_signed(char* destino, int32_t valor) {
+	if (valor < 0) {
+		destino[0] = '-';
+		// Convertir en uint32_t para que el mnimo de int32_t no se desborde
+		return 1 + FMT_unsigned(destino + 1, (uint32_t)0 - (uint32_t)valor);
+	}
+	
+	return FMT_unsigned(destino, (uint32_t)valor);
+}
+
+static void enviarTexto(const char* texto, uint8_t largo) {
+	for (uint8_t i = 0; i < largo; i++) {
+		sendUSARTData(texto[i]);
+	}
+}
+
+void FMT_sendUnsigned(uint32_t valor) {
+	char texto[FMT_MAX_TEXTO];
+	enviarTexto(texto, FMT_unsigned(texto, valor));
+}
+
+void FMT_sendSigned(int32_t valor) {
+	char texto[FMT_MAX_TEXTO];
+	enviarTexto(texto, FMT_signed(texto, valor));
+}
+
+uint8_t FMT_unsignedWidth(char* destino, uint32_t valor, uint8_t ancho) {
+	char texto[FMT_MAX_TEXTO];
+	uint8_t largo = FMT_unsigned(texto, valor);
+	uint8_t relleno = (ancho > largo) ? FMT_spaces(destino, ancho - largo) : 0;
+	
+	for (uint8_t i = 0; i < largo; i++) {
+		destino[relleno + i] = texto[i];
+	}
+	return relleno + largo;
+}
+
+uint8_t FMT_spaces(char* destino, uint8_t cantidad) {
+	for (uint8_t i = 0; i < cantidad; i++) {
+		destino[i] = ' ';
+	}
+	return cantidad;
+}
+
+uint8_t FMT_text_P(char* destino, const char* texto) {
+	uint8_t largo = 0;
+	char dato;
+	
+	while ((dato = pgm_read_byte(texto++)) != 0) {
+		destino[largo++] = dato;
+	}
+	return largo;
+}
+
+void FMT_sendLine(char* linea, uint8_t largo) {
+	// Una sola llamada: con USART_TX_DESCARTAR la lnea sale o se descarta entera
+	linea[largo] = '\0';
+	sendUSARTString(linea);
+}
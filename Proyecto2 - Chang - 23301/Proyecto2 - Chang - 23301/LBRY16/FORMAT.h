@@ -0,0 +1,44 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica del formateo de enteros para la
+* terminal. Reemplaza a sprintf en las respuestas: los nmeros se
+* convierten a decimal con restas de potencias de 10 (sin divisiones ni
+* vfprintf).
+*
+* Cada lnea de respuesta se arma completa en un buffer local y se enva
+* con una sola llamada, as la poltica USART_TX_DESCARTAR la enva o la
+* descarta entera (nunca un fragmento del medio).
+*
+* Uso tpico (equivale a sprintf con "Posicion %d cargada\r\n"):
+*   char linea[FMT_MAX_LINEA];
+*   uint8_t largo = FMT_text_P(linea, PSTR("Posicion "));
+*   largo += FMT_unsigned(linea + largo, n);
+*   largo += FMT_text_P(linea + largo, PSTR(" cargada\r\n"));
+*   FMT_sendLine(linea, largo);
+************************************************************************/
+
+#ifndef FORMAT_H
+#define FORMAT_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+#define FMT_MAX_DIGITOS 10          // Dgitos de un uint32_t (4294967295)
+#define FMT_MAX_TEXTO 11            // Dgitos ms el signo de un int32_t
+#define FMT_MAX_LINEA 64            // Lnea de respuesta ms larga, con el terminador
+
+uint8_t FMT_unsigned(char* destino, uint32_t valor);           // Write digits (no terminator), returns length
+uint8_t FMT_signed(char* destino, int32_t valor);              // Same with leading '-' when negative
+uint8_t FMT_unsignedWidth(char* destino, uint32_t valor, uint8_t ancho); // Right-aligned in ancho columns, returns length
+uint8_t FMT_spaces(char* destino, uint8_t cantidad);          // Write padding spaces, returns cantidad
+uint8_t FMT_text_P(char* destino, const char* texto);         // Copy a flash string (no terminator), returns length
+void FMT_sendLine(char* linea, uint8_t largo);                 // Terminate and send a whole line in one USART call
+void FMT_sendUnsigned(uint32_t valor);                         // Send unsigned value over USART
+void FMT_sendSigned(int32_t valor);                            // Send signed value over USART
+
+#endif // FORMAT_H
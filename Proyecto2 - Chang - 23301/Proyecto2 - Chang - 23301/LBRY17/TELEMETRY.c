@@ -0,0 +1,221 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa la telemetra peridica. La tarea corre en el
+* planificador con el periodo pedido; arma la muestra completa en RAM
+* (texto con LBRY16/FORMAT o trama con LBRY6/PROTOCOL) y la encola solo
+* si hay espacio para toda la muestra en el buffer de transmisin.
+*
+* Tiempo del lazo:
+*   TELEM_loopMark mide el tiempo entre dos vueltas del lazo principal
+*   con TCNT1 (0.5 us, se reinicia cada trama de 20 ms) y guarda la ms
+*   larga del periodo. Las vueltas de 20 ms o ms se miden con el tick
+*   de 1 ms del planificador.
+************************************************************************/
+
+#include "TELEMETRY.h"
+#include "../LBRY1/ADC.h"
+#include "../LBRY3/USART.h"
+#include "../LBRY6/PROTOCOL.h"
+#include "../LBRY7/SCHEDULER.h"
+#include "../LBRY16/FORMAT.h"
+
+#define TELEM_MAX_VALORES 13        // 4 ngulos + 4 ADC + modo + lazo + 2 del buffer (+ holgura)
+#define TELEM_MAX_DATOS 24          // Secuencia, campos y valores en binario
+#define TELEM_MAX_LINEA 88          // "T,255" y 13 valores de hasta 5 dgitos con coma
+
+static FuenteTelemetria fuenteEstado = 0;
+static uint8_t idTarea = SCHED_SIN_TAREA;
+static uint8_t activa = 0;
+static uint8_t camposActivos = TELEM_TODOS;
+static uint8_t formatoActivo = TELEM_TEXTO;
+static uint8_t secuencia = 0;
+static uint16_t descartadas = 0;
+
+// Medicin de la vuelta del lazo
+static uint8_t primeraMarca = 1;
+static uint16_t cuentaAnterior = 0;
+static uint16_t msAnterior = 0;
+static uint16_t lazoMaximo = 0;     // us
+
+// Valores de una muestra y su tamao en la trama binaria (1 o 2 bytes)
+typedef struct {
+	uint16_t valor[TELEM_MAX_VALORES];
+	uint8_t ancho[TELEM_MAX_VALORES];
+	uint8_t cantidad;
+} Muestra;
+
+static void agregarValor(Muestra* m, uint16_t valor, uint8_t ancho) {
+	if (m->cantidad >= TELEM_MAX_VALORES) return;
+	
+	m->valor[m->cantidad] = valor;
+	m->ancho[m->cantidad] = ancho;
+	m->cantidad++;
+}
+
+static void tomarMuestra(Muestra* m) {
+	EstadoTelemetria estado = { { 0 }, 0 };
+	m->cantidad = 0;
+	
+	if (fuenteEstado) {
+		fuenteEstado(&estado);
+	}
+	
+	if (camposActivos & TELEM_ANGULOS) {
+		for (uint8_t i = 0; i < TELEM_NUM_EJES; i++) {
+			agregarValor(m, estado.angulos[i], 1);
+		}
+	}
+	if (camposActivos & TELEM_ADC) {
+		for (uint8_t canal = 0; canal < ADC_NUM_CANALES; canal++) {
+			agregarValor(m, ADC_read(canal), 2);
+		}
+	}
+	if (camposActivos & TELEM_MODO) {
+		agregarValor(m, estado.modo, 1);
+	}
+	if (camposActivos & TELEM_LAZO) {
+		agregarValor(m, lazoMaximo, 2);
+	}
+	if (camposActivos & TELEM_BUFFER) {
+		agregarValor(m, getUSARTTxPending(), 1);
+		agregarValor(m, getUSARTTxHighWater(), 1);
+	}
+}
+
+static uint8_t espacioLibre(void) {
+	return (USART_TX_BUFFER - 1) - getUSARTTxPending();
+}
+
+static void enviarTexto(const Muestra* m) {
+	char linea[TELEM_MAX_LINEA];
+	uint8_t largo = 0;
+	
+	linea[largo++] = 'T';
+	linea[largo++] = ',';
+	largo += FMT_unsigned(linea + largo, secuencia);
+	for (uint8_t i = 0; i < m->cantidad; i++) {
+		linea[largo++] = ',';
+		largo += FMT_unsigned(linea + largo, m->valor[i]);
+	}
+	linea[largo++] = '\r';
+	linea[largo++] = '\n';
+	
+	if (largo > espacioLibre()) {
+		descartadas++;
+		return;
+	}
+	for (uint8_t i = 0; i < largo; i++) {
+		sendUSARTData(linea[i]);
+	}
+}
+
+static void enviarBinario(const Muestra* m) {
+	uint8_t datos[TELEM_MAX_DATOS];
+	uint8_t largo = 0;
+	
+	datos[largo++] = secuencia;
+	datos[largo++] = camposActivos;
+	for (uint8_t i = 0; i < m->cantidad; i++) {
+		datos[largo++] = (uint8_t)m->valor[i];
+		if (m->ancho[i] == 2) {
+			datos[largo++] = (uint8_t)(m->valor[i] >> 8);
+		}
+	}
+	
+	// SYNC, opcode, longitud y CRC adems de los datos
+	if (largo + 4 > espacioLibre()) {
+		descartadas++;
+		return;
+	}
+	PROTO_sendFrame(PROTO_OP_STREAM, datos, largo);
+}
+
+// Tarea: una muestra por periodo
+static void tareaTelemetria(void) {
+	Muestra muestra;
+	tomarMuestra(&muestra);
+	
+	if (formatoActivo == TELEM_BINARIO) {
+		enviarBinario(&muestra);
+		} else {
+		enviarTexto(&muestra);
+	}
+	
+	secuencia++;
+	lazoMaximo = 0;
+}
+
+void TELEM_init(FuenteTelemetria fuente) {
+	fuenteEstado = fuente;
+	activa = 0;
+	descartadas = 0;
+	
+	// Registrada detenida: TELEM_start le asigna el periodo
+	idTarea = SCHED_addTask(tareaTelemetria, 0, 0);
+	SCHED_stopTask(idTarea);
+}
+
+uint8_t TELEM_start(uint16_t periodo, uint8_t campos, uint8_t formato) {
+	if (periodo < TELEM_PERIODO_MIN || campos == 0 || (campos & ~TELEM_TODOS) || formato > TELEM_BINARIO) {
+		return 0;
+	}
+	if (idTarea == SCHED_SIN_TAREA) return 0;
+	
+	camposActivos = campos;
+	formatoActivo = formato;
+	secuencia = 0;
+	lazoMaximo = 0;
+	primeraMarca = 1;
+	activa = 1;
+	SCHED_setPeriod(idTarea, periodo);
+	return 1;
+}
+
+void TELEM_stop(void) {
+	activa = 0;
+	SCHED_stopTask(idTarea);
+}
+
+uint8_t TELEM_isActive(void) {
+	return activa;
+}
+
+void TELEM_loopMark(void) {
+	if (!activa) return;
+	
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t cuenta = TCNT1;
+	uint16_t ms = SCHED_ticks();
+	SREG = sreg;
+	
+	if (primeraMarca) {
+		primeraMarca = 0;
+		} else {
+		uint16_t transcurrido = ms - msAnterior;
+		uint16_t us;
+		if (transcurrido >= TELEM_MS_TRAMA) {
+			// Vuelta de una trama o ms: basta la resolucin de 1 ms
+			us = (transcurrido >= 65) ? 0xFFFF : transcurrido * 1000;
+			} else {
+			uint16_t fino = (cuenta >= cuentaAnterior) ?
+			(cuenta - cuentaAnterior) :
+			(uint16_t)(cuenta + TELEM_CUENTAS_TRAMA - cuentaAnterior);
+			us = fino / 2;
+		}
+		if (us > lazoMaximo) lazoMaximo = us;
+	}
+	
+	cuentaAnterior = cuenta;
+	msAnterior = ms;
+}
+
+uint16_t TELEM_dropped(void) {
+	return descartadas;
+}
@@ -0,0 +1,70 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica de la telemetra peridica. Una
+* tarea del planificador toma una muestra del estado de la garra cada
+* periodo y la enva por USART en texto o en trama binaria. La muestra
+* solo se encola si cabe completa en el buffer de transmisin; si no
+* cabe se descarta y se cuenta, as el envo nunca detiene el lazo.
+*
+* Campos (mscara, se envan en este orden):
+*   - TELEM_ANGULOS: ngulos comandados base, brazo1, brazo2, pinza
+*   - TELEM_ADC: lectura cruda de los 4 potencimetros (0-1023)
+*   - TELEM_MODO: modo de operacin
+*   - TELEM_LAZO: vuelta ms larga del lazo principal en el periodo (us)
+*   - TELEM_BUFFER: bytes pendientes y nivel mximo del buffer de TX
+*
+* Formato texto (una lnea por muestra):
+*   T,secuencia,<valores de los campos separados por coma>\r\n
+*
+* Formato binario (trama de LBRY6/PROTOCOL.h, enviada por el robot):
+*   [0xA5] [PROTO_OP_STREAM] [LONGITUD] [secuencia] [campos] [valores] [CRC]
+*   Los valores de 16 bits van en little-endian.
+*
+* La secuencia aumenta en cada periodo, tambin cuando la muestra se
+* descarta, as que los saltos en la secuencia indican muestras perdidas.
+************************************************************************/
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+// Campos
+#define TELEM_ANGULOS 0x01
+#define TELEM_ADC 0x02
+#define TELEM_MODO 0x04
+#define TELEM_LAZO 0x08
+#define TELEM_BUFFER 0x10
+#define TELEM_TODOS 0x1F
+
+// Formatos
+#define TELEM_TEXTO 0
+#define TELEM_BINARIO 1
+
+#define TELEM_NUM_EJES 4
+#define TELEM_PERIODO_MIN 10        // ms
+#define TELEM_CUENTAS_TRAMA 40000U  // TCNT1 se reinicia cada trama de 20 ms (0.5 us por cuenta)
+#define TELEM_MS_TRAMA 20
+
+// Estado que aporta el programa principal
+typedef struct {
+	uint8_t angulos[TELEM_NUM_EJES];
+	uint8_t modo;
+} EstadoTelemetria;
+
+typedef void (*FuenteTelemetria)(EstadoTelemetria* estado);
+
+void TELEM_init(FuenteTelemetria fuente);                                   // Register task (stopped) and state source
+uint8_t TELEM_start(uint16_t periodo, uint8_t campos, uint8_t formato);     // Start stream, returns 0 if arguments are invalid
+void TELEM_stop(void);                                                      // Stop stream
+uint8_t TELEM_isActive(void);                                               // 1 while streaming
+void TELEM_loopMark(void);                                                  // Call once per main loop pass (loop time)
+uint16_t TELEM_dropped(void);                                               // Samples dropped because TX buffer was full
+
+#endif // TELEMETRY_H
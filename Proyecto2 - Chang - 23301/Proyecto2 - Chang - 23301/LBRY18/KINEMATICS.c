@@ -0,0 +1,173 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera resuelve la cinemtica inversa de la garra con enteros.
+*
+* atan2 (CORDIC en modo vectorizacin):
+*   El vector se lleva al semiplano x > 0 con un giro de 90 y se rota
+*   16 veces por atan(2^-i) hasta dejar y en 0; la suma de los giros es
+*   el ngulo. Solo usa sumas y desplazamientos, con la tabla de atan en
+*   PROGMEM en grados Q16.16. Antes de rotar, el vector se escala para
+*   usar ~22 bits y no perder precisin con distancias pequeas.
+*
+* Brazo de dos eslabones (ley de cosenos sin divisin ni acos):
+*   num = d^2 - L1^2 - L2^2,  den = 2*L1*L2  (cos codo = num/den)
+*   sen = sqrt(den^2 - num^2)               (escalado a 16 bits)
+*   codo   = atan2(sen, num)
+*   hombro = atan2(h, r) + atan2(L2*sen, L1*den + L2*num)
+************************************************************************/
+
+#include "KINEMATICS.h"
+
+#define KIN_ITERACIONES 16
+#define KIN_GRADO (1L << 16)         // 1 en Q16.16
+#define KIN_ESCALA_CORDIC (1L << 22) // Magnitud mnima de entrada al CORDIC
+
+// atan(2^-i) en grados Q16.16
+static const int32_t tablaAtan[KIN_ITERACIONES] PROGMEM = {
+	2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+	14668, 7334, 3667, 1833, 917, 458, 229, 115
+};
+
+static uint16_t largo1 = KIN_L1_DEFECTO;
+static uint16_t largo2 = KIN_L2_DEFECTO;
+static uint16_t alturaHombro = KIN_ALTURA_DEFECTO;
+
+void KIN_init(void) {
+	largo1 = KIN_L1_DEFECTO;
+	largo2 = KIN_L2_DEFECTO;
+	alturaHombro = KIN_ALTURA_DEFECTO;
+}
+
+uint8_t KIN_setGeometry(uint16_t l1, uint16_t l2, uint16_t altura) {
+	if (l1 == 0 || l2 == 0 || l1 > KIN_LARGO_MAX || l2 > KIN_LARGO_MAX || altura > KIN_LARGO_MAX) {
+		return 0;
+	}
+	
+	largo1 = l1;
+	largo2 = l2;
+	alturaHombro = altura;
+	return 1;
+}
+
+int32_t KIN_atan2(int32_t y, int32_t x) {
+	if (x == 0 && y == 0) return 0;
+	
+	// Escalar para que el CORDIC trabaje con ~22 bits
+	while (x < KIN_ESCALA_CORDIC && x > -KIN_ESCALA_CORDIC && y < KIN_ESCALA_CORDIC && y > -KIN_ESCALA_CORDIC) {
+		x *= 2;
+		y *= 2;
+	}
+	
+	// Llevar el vector al semiplano x >= 0
+	int32_t angulo = 0;
+	if (x < 0) {
+		int32_t temporal = x;
+		if (y >= 0) {
+			x = y;
+			y = -temporal;
+			angulo = 90 * KIN_GRADO;
+			} else {
+			x = -y;
+			y = temporal;
+			angulo = -90 * KIN_GRADO;
+		}
+	}
+	
+	for (uint8_t i = 0; i < KIN_ITERACIONES; i++) {
+		int32_t xDesplazado = x >> i;
+		int32_t yDesplazado = y >> i;
+		int32_t paso = pgm_read_dword(&tablaAtan[i]);
+		
+		if (y > 0) {
+			x += yDesplazado;
+			y -= xDesplazado;
+			angulo += paso;
+			} else {
+			x -= yDesplazado;
+			y += xDesplazado;
+			angulo -= paso;
+		}
+	}
+	
+	return angulo;
+}
+
+uint16_t KIN_sqrt(uint32_t valor) {
+	uint32_t resultado = 0;
+	uint32_t bit = 1UL << 30;
+	
+	while (bit > valor) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (valor >= resultado + bit) {
+			valor -= resultado + bit;
+			resultado = (resultado >> 1) + bit;
+			} else {
+			resultado >>= 1;
+		}
+		bit >>= 2;
+	}
+	
+	return (uint16_t)resultado;
+}
+
+// Grados Q16.16 a ngulo de servo, 0xFF si queda fuera de 0-180
+static uint8_t aServo(int32_t angulo) {
+	int32_t redondeado = (angulo + KIN_GRADO / 2) >> 16;
+	if (redondeado < 0 || redondeado > 180) return 0xFF;
+	
+	return (uint8_t)redondeado;
+}
+
+uint8_t KIN_solve(int16_t x, int16_t y, int16_t z, AngulosArticulacion* angulos) {
+	if (y < 0) return KIN_DETRAS;
+	
+	// Distancia horizontal y altura relativa al hombro (d2 exacto, sin redondear r)
+	uint32_t r2 = (uint32_t)((int32_t)x * x) + (uint32_t)((int32_t)y * y);
+	int32_t h = (int32_t)z - alturaHombro;
+	uint32_t d2 = r2 + (uint32_t)(h * h);
+	
+	// Alcance: |L1 - L2| <= d <= L1 + L2
+	uint32_t suma = (uint32_t)largo1 + largo2;
+	uint32_t diferencia = (largo1 > largo2) ? (largo1 - largo2) : (largo2 - largo1);
+	if (d2 > suma * suma || d2 < diferencia * diferencia) {
+		return KIN_FUERA_ALCANCE;
+	}
+	
+	// r en 1/16 mm: la raz entera de r2 pierde hasta 1 mm (ms de 1 cerca del hombro).
+	// Dentro del alcance r2 <= (2 x KIN_LARGO_MAX)^2, as que r2 x 256 cabe en 32 bits
+	uint16_t r16 = KIN_sqrt(r2 << 8);
+	
+	// Ley de cosenos en enteros, reducida a 16 bits para el producto
+	int32_t num = (int32_t)d2 - (int32_t)largo1 * largo1 - (int32_t)largo2 * largo2;
+	int32_t den = 2L * largo1 * largo2;
+	while (den > 0x7FFF) {
+		den /= 2;
+		num /= 2;
+	}
+	if (num > den) num = den;
+	if (num < -den) num = -den;
+	int32_t seno = KIN_sqrt((uint32_t)(den - num) * (uint32_t)(den + num));
+	
+	int32_t codo = KIN_atan2(seno, num);
+	int32_t hombro = KIN_atan2(h * 16, r16) + KIN_atan2((int32_t)largo2 * seno, (int32_t)largo1 * den + (int32_t)largo2 * num);
+	
+	uint8_t base = aServo(KIN_atan2(y, x));
+	uint8_t brazo1 = aServo(hombro);
+	uint8_t brazo2 = aServo(180 * KIN_GRADO - codo);
+	if (base == 0xFF || brazo1 == 0xFF || brazo2 == 0xFF) {
+		return KIN_ANGULO_INVALIDO;
+	}
+	
+	angulos->base = base;
+	angulos->brazo1 = brazo1;
+	angulos->brazo2 = brazo2;
+	return KIN_OK;
+}
@@ -0,0 +1,57 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica de la cinemtica inversa de la
+* garra. A partir de un punto (x, y, z) en milmetros calcula los ngulos
+* de la base, brazo1 y brazo2 con aritmtica entera (CORDIC para atan2 y
+* raz cuadrada entera), sin punto flotante. Una solucin completa toma
+* del orden de 10^4 ciclos (< 1 ms a 16 MHz), menos que una trama de
+* servo de 20 ms.
+*
+* Sistema de coordenadas (origen en el eje de la base, al nivel de la mesa):
+*   - x: hacia la derecha, y: hacia el frente, z: hacia arriba
+*   - El hombro (eje de brazo1) est a KIN_ALTURA_DEFECTO mm sobre la mesa
+*
+* ngulos de los servos (0-180):
+*   - Base: atan2(y, x); 0 = derecha, 90 = frente, 180 = izquierda
+*   - Brazo1: elevacin del primer eslabn; 0 = horizontal hacia el
+*     frente, 90 = vertical
+*   - Brazo2: ngulo interior entre los eslabones; 180 = brazo estirado
+*   - Se usa la solucin con el codo hacia arriba
+************************************************************************/
+
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+// Geometra por defecto (mm)
+#define KIN_L1_DEFECTO 80           // Hombro a codo
+#define KIN_L2_DEFECTO 80           // Codo a la punta de la pinza
+#define KIN_ALTURA_DEFECTO 60       // Mesa al eje del hombro
+#define KIN_LARGO_MAX 1000          // Lmite de cada eslabn configurable
+
+// Resultado de KIN_solve
+#define KIN_OK 0
+#define KIN_FUERA_ALCANCE 1         // Ms lejos que L1 + L2 o ms cerca que |L1 - L2|
+#define KIN_DETRAS 2                // y < 0: la base no gira ms de 180
+#define KIN_ANGULO_INVALIDO 3       // Alguna articulacin queda fuera de 0-180
+
+typedef struct {
+	uint8_t base;
+	uint8_t brazo1;
+	uint8_t brazo2;
+} AngulosArticulacion;
+
+void KIN_init(void);                                                        // Load default geometry
+uint8_t KIN_setGeometry(uint16_t l1, uint16_t l2, uint16_t altura);         // Set link lengths (mm), returns 0 if invalid
+uint8_t KIN_solve(int16_t x, int16_t y, int16_t z, AngulosArticulacion* angulos); // Solve a point, KIN_OK or error code
+int32_t KIN_atan2(int32_t y, int32_t x);                                    // atan2 in degrees Q16.16 (-180..180)
+uint16_t KIN_sqrt(uint32_t valor);                                          // Integer square root (floor)
+
+#endif // KINEMATICS_H
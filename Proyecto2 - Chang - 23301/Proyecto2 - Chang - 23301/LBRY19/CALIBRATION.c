@@ -0,0 +1,171 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera mantiene la calibracin de los servos y la convierte en
+* coeficientes de punto fijo por canal. Los coeficientes se calculan una
+* sola vez al cargar o cambiar la calibracin (con la divisin), as que
+* cada actualizacin de un servo, que corre en el ISR de la trama, solo
+* limita el ngulo y hace una multiplicacin:
+*   ticks = origen + (pendiente * ngulo + 0x8000) >> 16
+* con origen en ticks de 0.5 us y pendiente en ticks por grado Q16.16
+* (negativa si el canal est invertido).
+*
+* Una tabla de 181 valores por canal costara ~1 KB de los 2 KB de RAM;
+* la pendiente da el mismo resultado (0.5 tick) con 6 bytes por canal.
+************************************************************************/
+
+#include "CALIBRATION.h"
+#include "../LBRY2/TIMER0_PWM.h"
+#include "../LBRY4/EEPROM.h"
+
+// Rangos anteriores en us nominales: Timer0 a 64 us por cuenta, Timer1 a
+// 0.5 us por cuenta (2000-4000) y la pinza invertida dividida entre 3
+#define CAL_T0_MIN_US ((uint16_t)SERVO_MIN_T0 * 64)
+#define CAL_T0_MAX_US ((uint16_t)SERVO_MAX_T0 * 64)
+
+static const CalibracionServo calibracionDefecto[CAL_NUM_CANALES] PROGMEM = {
+	{ CAL_T0_MIN_US, CAL_T0_MAX_US, 0, 0, 0, 180 },   // Base (Timer0)
+	{ CAL_T0_MIN_US, CAL_T0_MAX_US, 0, 0, 0, 180 },   // Brazo1 (Timer0)
+	{ 1000, 2000, 0, 0, 0, 180 },                     // Brazo2 (Timer1)
+	{ 333, 667, 0, 1, 0, 180 }                        // Pinza (Timer1, invertida)
+};
+
+static CalibracionServo calibracion[CAL_NUM_CANALES];
+static uint8_t guardada = 0;
+
+// Coeficientes usados en cada actualizacin (los lee el ISR de la trama)
+typedef struct {
+	uint16_t origen;        // Ticks a 0 grados
+	int32_t pendiente;      // Ticks por grado, Q16.16
+	uint8_t limiteInf;
+	uint8_t limiteSup;
+} MapeoServo;
+
+static volatile MapeoServo mapeo[CAL_NUM_CANALES];
+
+static uint8_t calibracionValida(const CalibracionServo* cal) {
+	int32_t minimo = (int32_t)cal->pulsoMin + cal->centro;
+	int32_t maximo = (int32_t)cal->pulsoMax + cal->centro;
+	
+	if (cal->pulsoMin >= cal->pulsoMax) return 0;
+	if (minimo < CAL_PULSO_MIN || maximo > CAL_PULSO_MAX) return 0;
+	if (cal->invertido > 1) return 0;
+	if (cal->limiteInf > cal->limiteSup || cal->limiteSup > 180) return 0;
+	
+	return 1;
+}
+
+// Calcular los coeficientes de un canal (fuera del ISR)
+static void construirMapeo(uint8_t canal) {
+	const CalibracionServo* cal = &calibracion[canal];
+	int32_t inicio = 2 * ((int32_t)(cal->invertido ? cal->pulsoMax : cal->pulsoMin) + cal->centro);
+	int32_t fin = 2 * ((int32_t)(cal->invertido ? cal->pulsoMin : cal->pulsoMax) + cal->centro);
+	
+	// Pendiente redondeada al entero Q16.16 ms cercano
+	int32_t rango = (fin - inicio) * 65536L;
+	int32_t pendiente = (rango >= 0) ? ((rango + 90) / 180) : -((-rango + 90) / 180);
+	
+	uint8_t sreg = SREG;
+	cli();
+	mapeo[canal].origen = (uint16_t)inicio;
+	mapeo[canal].pendiente = pendiente;
+	mapeo[canal].limiteInf = cal->limiteInf;
+	mapeo[canal].limiteSup = cal->limiteSup;
+	SREG = sreg;
+}
+
+static void cargarDefecto(uint8_t canal) {
+	memcpy_P(&calibracion[canal], &calibracionDefecto[canal], sizeof(CalibracionServo));
+}
+
+// Registro de un canal <-> bytes de la EEPROM (little-endian)
+static void empaquetar(const CalibracionServo* cal, uint8_t* bytes) {
+	bytes[0] = (uint8_t)cal->pulsoMin;
+	bytes[1] = (uint8_t)(cal->pulsoMin >> 8);
+	bytes[2] = (uint8_t)cal->pulsoMax;
+	bytes[3] = (uint8_t)(cal->pulsoMax >> 8);
+	bytes[4] = (uint8_t)cal->centro;
+	bytes[5] = cal->invertido;
+	bytes[6] = cal->limiteInf;
+	bytes[7] = cal->limiteSup;
+}
+
+static void desempaquetar(const uint8_t* bytes, CalibracionServo* cal) {
+	cal->pulsoMin = bytes[0] | ((uint16_t)bytes[1] << 8);
+	cal->pulsoMax = bytes[2] | ((uint16_t)bytes[3] << 8);
+	cal->centro = (int8_t)bytes[4];
+	cal->invertido = bytes[5];
+	cal->limiteInf = bytes[6];
+	cal->limiteSup = bytes[7];
+}
+
+void CAL_init(void) {
+	uint8_t datos[CAL_NUM_CANALES * CAL_BYTES_CANAL];
+	guardada = EEPROM_loadCalibration(datos, sizeof(datos));
+	
+	for (uint8_t canal = 0; canal < CAL_NUM_CANALES; canal++) {
+		// Un canal invlido (bloque de otra versin) vuelve a su valor por defecto
+		if (guardada) {
+			desempaquetar(&datos[canal * CAL_BYTES_CANAL], &calibracion[canal]);
+		}
+		if (!guardada || !calibracionValida(&calibracion[canal])) {
+			cargarDefecto(canal);
+		}
+		construirMapeo(canal);
+	}
+}
+
+uint8_t CAL_set(uint8_t canal, const CalibracionServo* cal) {
+	if (canal >= CAL_NUM_CANALES || !calibracionValida(cal)) return 0;
+	
+	calibracion[canal] = *cal;
+	construirMapeo(canal);
+	guardada = 0;
+	return 1;
+}
+
+void CAL_get(uint8_t canal, CalibracionServo* cal) {
+	if (canal >= CAL_NUM_CANALES) return;
+	
+	*cal = calibracion[canal];
+}
+
+void CAL_restoreDefaults(void) {
+	for (uint8_t canal = 0; canal < CAL_NUM_CANALES; canal++) {
+		cargarDefecto(canal);
+		construirMapeo(canal);
+	}
+	guardada = 0;
+}
+
+uint8_t CAL_save(void) {
+	uint8_t datos[CAL_NUM_CANALES * CAL_BYTES_CANAL];
+	
+	for (uint8_t canal = 0; canal < CAL_NUM_CANALES; canal++) {
+		empaquetar(&calibracion[canal], &datos[canal * CAL_BYTES_CANAL]);
+	}
+	if (!EEPROM_saveCalibration(datos, sizeof(datos))) {
+		return 0;
+	}
+	guardada = 1;
+	return 1;
+}
+
+uint8_t CAL_isStored(void) {
+	return guardada;
+}
+
+uint16_t CAL_ticks(uint8_t canal, uint8_t angulo) {
+	if (canal >= CAL_NUM_CANALES) return 0;
+	
+	volatile MapeoServo* m = &mapeo[canal];
+	if (angulo < m->limiteInf) angulo = m->limiteInf;
+	if (angulo > m->limiteSup) angulo = m->limiteSup;
+	
+	return (uint16_t)(m->origen + ((m->pendiente * angulo + 0x8000L) >> 16));
+}
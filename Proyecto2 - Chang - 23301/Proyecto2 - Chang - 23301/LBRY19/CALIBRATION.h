@@ -0,0 +1,55 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica de la calibracin de los
+* servos. Cada canal tiene un registro con los pulsos de los extremos, un
+* ajuste de centro, la inversin y lmites de software; los registros se
+* guardan en el bloque de calibracin de la EEPROM (LBRY4/EEPROM.h) y se
+* editan por USART sin volver a programar el microcontrolador.
+*
+* Pulsos (us nominales = valor de comparacin x resolucin del timer):
+*   ngulo efectivo = ngulo limitado a [limiteInf, limiteSup], reflejado
+*                     (180 - ngulo) si el canal est invertido
+*   pulso = pulsoMin + centro + (pulsoMax - pulsoMin) * ngulo / 180
+*
+* CAL_ticks devuelve el pulso en ticks de 0.5 us, la unidad del Timer1 y
+* del SERVO_MUX; calculate_PWM0_ticks lo convierte al Timer0.
+*
+* Canales: 0 base, 1 brazo1, 2 brazo2, 3 pinza. Los valores por defecto
+* reproducen los rangos fijos anteriores (SERVO_MIN_T0/SERVO_MAX_T0,
+* 2000-4000 del Timer1 y la pinza invertida a un tercio).
+************************************************************************/
+
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+#define CAL_NUM_CANALES 4
+#define CAL_BYTES_CANAL 8           // Tamao de un registro en la EEPROM
+#define CAL_PULSO_MIN 250           // Lmites aceptados para los extremos (us)
+#define CAL_PULSO_MAX 2750
+
+typedef struct {
+	uint16_t pulsoMin;      // Pulso a 0 grados (us)
+	uint16_t pulsoMax;      // Pulso a 180 grados (us)
+	int8_t centro;          // Ajuste sumado a todo el rango (us)
+	uint8_t invertido;      // 1: 0 grados corresponde a pulsoMax
+	uint8_t limiteInf;      // Lmites de software (grados)
+	uint8_t limiteSup;
+} CalibracionServo;
+
+void CAL_init(void);                                                // Load calibration from EEPROM (defaults if missing)
+uint8_t CAL_set(uint8_t canal, const CalibracionServo* cal);        // Validate and apply a channel, returns 0 if invalid
+void CAL_get(uint8_t canal, CalibracionServo* cal);                 // Copy a channel's calibration
+void CAL_restoreDefaults(void);                                     // Apply the built-in calibration (not saved)
+uint8_t CAL_save(void);                                             // Write all channels to EEPROM, returns 0 if read-only
+uint8_t CAL_isStored(void);                                         // 1 if the active calibration came from or went to EEPROM
+uint16_t CAL_ticks(uint8_t canal, uint8_t angulo);                  // Angle to pulse width in 0.5 us ticks
+
+#endif // CALIBRATION_H
@@ -17,6 +17,14 @@
 * - Canal B (OC0B): Control de Servo Base
 * - Rango de movimiento: 0-180 grados
 * - Resolucin: ~1.4 grados por paso (8-bit PWM)
+* - La conversin ngulo -> valor de comparacin usa una tabla en memoria
+*   de programa generada en tiempo de compilacin (sin divisiones)
+*
+* Registros sombra:
+*   En Fast PWM el hardware ya aplica OCR0x al final del periodo, pero
+*   dos escrituras desde el programa pueden caer en periodos distintos.
+*   Los valores nuevos se guardan en la sombra con una mscara de canales
+*   pendientes y TIMER0_OVF los copia juntos, solo si cambiaron.
 *
 * Conexiones de Hardware:
 *   - PWM Timer0 Canal A: PD6 (OC0A) - Servo Brazo1
@@ -24,6 +32,20 @@
 ************************************************************************/
 
 #include "TIMER0_PWM.h"
+#include "../LBRY9/LUT.h"
+#include "../LBRY12/BENCH.h"
+
+// Tabla ngulo (0-180) -> valor de OCR0x, misma frmula que el clculo original
+#define PWM0_ANGULO(a) (uint8_t)(SERVO_MIN_T0 + (((SERVO_MAX_T0 - SERVO_MIN_T0) * (uint16_t)(a)) / 180))
+static const uint8_t tablaPWM0[181] PROGMEM = { LUT_181(PWM0_ANGULO) };
+
+#define PENDIENTE_0A 0x01
+#define PENDIENTE_0B 0x02
+
+static volatile uint8_t sombra0A = SERVO_MIN_T0;
+static volatile uint8_t sombra0B = SERVO_MIN_T0;
+static volatile uint8_t pendientes0 = 0;
+static volatile uint16_t periodos0 = 0;
 
 void Timer0_init(void) {
 	// Configurar pines como salida
@@ -41,44 +63,88 @@ void Timer0_init(void) {
 	// Valor inicial para los servos en Timer0 (posicin 0 grados)
 	OCR0A = SERVO_MIN_T0;
 	OCR0B = SERVO_MIN_T0;
+	sombra0A = SERVO_MIN_T0;
+	sombra0B = SERVO_MIN_T0;
+	pendientes0 = 0;
+	periodos0 = 0;
+	
+	// Desborde: copiar los registros sombra una vez por periodo
+	TIFR0 = (1 << TOV0);
+	TIMSK0 |= (1 << TOIE0);
 }
 
 void set_pos0A(uint8_t pos) {
 	// Limitamos pos a 0-180
 	if (pos > 180) pos = 180;
 	
-	// Mapear 0-180
-	uint8_t duty = SERVO_MIN_T0 + (((SERVO_MAX_T0 - SERVO_MIN_T0) * (uint16_t)pos) / 80);
+	// Mapear 0-180 con la tabla
+	uint8_t duty = pgm_read_byte(&tablaPWM0[pos]);
 	
 	// Establecer el valor de comparacin
-	OCR0A = duty;
+	setPWM0A(duty);
 }
 
 void set_pos0B(uint8_t pos) {
 	// Limitamos pos a 0-180
 	if (pos > 180) pos = 180;
 	
-	// Mapear 0-180
-	uint8_t duty = SERVO_MIN_T0 + (((SERVO_MAX_T0 - SERVO_MIN_T0) * (uint16_t)pos) / 180);
+	// Mapear 0-180 con la tabla
+	uint8_t duty = pgm_read_byte(&tablaPWM0[pos]);
 	
 	// Establecer el valor de comparacin
-	OCR0B = duty;
+	setPWM0B(duty);
 }
 
 void setPWM0A(uint8_t pwmValue) {
-	OCR0A = pwmValue;
+	uint8_t sreg = SREG;
+	cli();
+	if (pwmValue != sombra0A) {
+		sombra0A = pwmValue;
+		pendientes0 |= PENDIENTE_0A;
+	}
+	SREG = sreg;
 }
 
 void setPWM0B(uint8_t pwmValue) {
-	OCR0B = pwmValue;
+	uint8_t sreg = SREG;
+	cli();
+	if (pwmValue != sombra0B) {
+		sombra0B = pwmValue;
+		pendientes0 |= PENDIENTE_0B;
+	}
+	SREG = sreg;
 }
 
 uint8_t calculate_PWM0(uint8_t angle) {
 	// Limitamos angulo a 0-180
 	if (angle > 180) angle = 180;
 	
-	// Mapear 0-180 a SERVO_MIN_T0-SERVO_MAX_T0
-	uint8_t pwmValue = SERVO_MIN_T0 + (((SERVO_MAX_T0 - SERVO_MIN_T0) * (uint16_t)angle) / 180);
+	// Mapear 0-180 a SERVO_MIN_T0-SERVO_MAX_T0 (lectura de tabla en flash)
+	return pgm_read_byte(&tablaPWM0[angle]);
+}
+
+uint8_t calculate_PWM0_ticks(uint16_t ticks) {
+	// Una cuenta del Timer0 (prescaler 1024) son 64 us = 128 ticks de 0.5 us
+	uint16_t valor = ticks >> 7;
+	return (valor > 0xFF) ? 0xFF : (uint8_t)valor;
+}
+
+uint16_t Timer0_frameCount(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t periodos = periodos0;
+	SREG = sreg;
 	
-	return pwmValue;
+	return periodos;
+}
+
+// INTERRUPCIONES
+ISR(TIMER0_OVF_vect) {
+	BENCH_BEGIN(BENCH_ISR_PWM0);
+	// Los dos canales cambian en el mismo periodo
+	if (pendientes0 & PENDIENTE_0A) OCR0A = sombra0A;
+	if (pendientes0 & PENDIENTE_0B) OCR0B = sombra0B;
+	pendientes0 = 0;
+	periodos0++;
+	BENCH_END(BENCH_ISR_PWM0);
 }
\ No newline at end of file
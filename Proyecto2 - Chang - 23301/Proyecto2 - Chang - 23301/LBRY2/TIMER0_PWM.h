@@ -11,6 +11,11 @@
 * definiciones de pines y declaraciones de funciones para el manejo
 * de dos canales independientes de control servo.
 *
+* Salida con registros sombra: setPWM0A/setPWM0B solo guardan el valor
+* nuevo y el desborde del Timer0 (~61 Hz) lo copia a OCR0A/OCR0B, los
+* dos canales en el mismo periodo. Un valor igual al pendiente no se
+* vuelve a escribir. Timer0_frameCount cuenta los periodos de salida.
+*
 * Conexiones de Hardware: 
 *   - PWM Timer0 Canal A: PD6 (OC0A) - Control Servo Brazo1
 *   - PWM Timer0 Canal B: PD5 (OC0B) - Control Servo Base
@@ -18,7 +23,7 @@
 
 #ifndef TIMER0_PWM_H
 #define TIMER0_PWM_H
-#include <avr/io.h>
+#include "../LBRY11/HAL.h"
 #include <stdint.h>
 
 #define SERVO_PIN_OC0A PIND6  // Pin 6 del puerto D
@@ -26,6 +31,7 @@
 
 #define SERVO_MIN_T0 15   // Posicion 0 grados
 #define SERVO_MAX_T0 37   // Posicion 180 grados
+#define TIMER0_FRECUENCIA 61  // Periodos de PWM por segundo (16MHz / 1024 / 256)
 
 void Timer0_init(void);
 
@@ -34,5 +40,7 @@ void set_pos0B(uint8_t pos);           // Set servo position on OC0B (0-180)
 void setPWM0A(uint8_t pwmValue);                // Set direct PWM value on OC0A
 void setPWM0B(uint8_t pwmValue);                // Set direct PWM value on OC0B
 uint8_t calculate_PWM0(uint8_t angle);      // Calculate PWM value for servo on Timer0
+uint8_t calculate_PWM0_ticks(uint16_t ticks); // Convert a 0.5 us pulse width to a Timer0 PWM value
+uint16_t Timer0_frameCount(void);           // PWM periods output since init (wraps)
 
 #endif // TIMER0_PWM_H
\ No newline at end of file
@@ -0,0 +1,256 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa el motor de reproduccin de secuencias.
+*
+* Tiempo:
+*   El tiempo restante del cuadro se guarda en ms x 100 del tiempo de la
+*   secuencia. Cada vez que corre la tarea se le resta el tiempo real
+*   transcurrido (ticks de 1 ms del planificador) multiplicado por la
+*   velocidad en %, as que un cambio de velocidad no necesita dividir y
+*   el retraso de una vuelta del lazo no se acumula. Solo la duracin de
+*   la transicin que se entrega a la salida se divide, una vez por cuadro.
+*
+* Pausa:
+*   Detiene la tarea y los servos (MOTION_hold). Al continuar se vuelve a
+*   enviar la pose del cuadro con la parte de la transicin que faltaba.
+*
+* Cuadros:
+*   Cada cuadro se pide a la fuente una sola vez, al empezarlo, y se
+*   guarda en RAM para pausar, continuar o cambiar la velocidad. Hacia
+*   adelante los nmeros llegan en orden, as que una fuente que decodifica
+*   en flujo solo vuelve a abrir la secuencia en una bsqueda, al volver al
+*   primer cuadro o en sentido contrario.
+*
+* Ida y vuelta:
+*   En sentido contrario, la transicin hacia un cuadro es la del cuadro
+*   que se deja (el mismo tramo recorrido al revs) y la espera es la del
+*   cuadro al que se llega.
+************************************************************************/
+
+#include "PLAYBACK.h"
+#include "../LBRY7/SCHEDULER.h"
+#include "../LBRY8/MOTION.h"
+#include "../LBRY12/BENCH.h"
+
+static SalidaPose funcionSalida = 0;
+static EventoReproduccion funcionEvento = 0;
+static FuenteCuadros funcionFuente = 0;
+static uint8_t idTarea = SCHED_SIN_TAREA;
+
+static uint8_t estado = PLAY_DETENIDO;
+static uint8_t modoRepeticion = PLAY_UNA_VEZ;
+static uint8_t repeticiones = 0;        // 0 = sin fin
+static uint8_t repeticionesHechas = 0;
+static uint16_t velocidad = 100;        // %
+
+static uint8_t numCuadros = 0;
+static uint8_t cuadroActual = 0;
+static int8_t direccion = 1;
+static CuadroClave cuadroEnCurso;
+static uint32_t restante = 0;           // ms x 100
+static uint32_t esperaRestante = 0;     // Parte de restante que es espera (ms x 100)
+static uint16_t ultimoTick = 0;
+
+// Tiempo de la secuencia (ms x 100) a ms reales con la velocidad actual
+static uint16_t escalar(uint32_t tiempo) {
+	uint32_t ms = tiempo / velocidad;
+	return (ms > 0xFFFF) ? 0xFFFF : (uint16_t)ms;
+}
+
+// Enviar la pose del cuadro actual con la parte de la transicin que falta
+static void enviarPose(void) {
+	uint32_t transicion = (restante > esperaRestante) ? (restante - esperaRestante) : 0;
+	if (funcionSalida) {
+		funcionSalida(&cuadroEnCurso.pose, escalar(transicion));
+	}
+}
+
+static void terminar(void) {
+	estado = PLAY_DETENIDO;
+	SCHED_stopTask(idTarea);
+	if (funcionEvento) {
+		funcionEvento(PLAY_EVENTO_FIN, cuadroActual);
+	}
+}
+
+// Empezar el cuadro numero, ya ledo de la fuente (transicion en unidades de UNIDAD_TIEMPO_MS)
+static void empezarCuadro(uint8_t numero, const CuadroClave* cuadro, uint8_t transicion) {
+	cuadroActual = numero;
+	cuadroEnCurso = *cuadro;
+	esperaRestante = (uint32_t)cuadro->espera * UNIDAD_TIEMPO_MS * 100;
+	restante = (uint32_t)transicion * UNIDAD_TIEMPO_MS * 100 + esperaRestante;
+	
+	if (funcionSalida) {
+		funcionSalida(&cuadro->pose, escalar((uint32_t)transicion * UNIDAD_TIEMPO_MS * 100));
+	}
+	if (funcionEvento) {
+		funcionEvento(PLAY_EVENTO_CUADRO, numero);
+	}
+}
+
+// Siguiente cuadro segn el sentido y el modo de repeticin
+static void avanzar(void) {
+	int16_t siguiente = (int16_t)cuadroActual + direccion;
+	
+	if (siguiente < 0 || siguiente >= numCuadros) {
+		if (modoRepeticion == PLAY_UNA_VEZ) {
+			terminar();
+			return;
+		}
+		
+		// Un ciclo completo: fin de la secuencia (bucle) o regreso al inicio (ida y vuelta)
+		if (modoRepeticion == PLAY_BUCLE || direccion < 0) {
+			repeticionesHechas++;
+			if (repeticiones && repeticionesHechas >= repeticiones) {
+				terminar();
+				return;
+			}
+		}
+		
+		if (modoRepeticion == PLAY_BUCLE) {
+			siguiente = 0;
+			} else {
+			direccion = -direccion;
+			siguiente = (numCuadros > 1) ? (int16_t)cuadroActual + direccion : 0;
+		}
+	}
+	
+	CuadroClave cuadro;
+	if (!funcionFuente((uint8_t)siguiente, &cuadro)) {
+		terminar();
+		return;
+	}
+	
+	// Hacia atrs se recorre al revs el tramo del cuadro que se deja
+	uint8_t transicion = (direccion > 0) ? cuadro.transicion : cuadroEnCurso.transicion;
+	empezarCuadro((uint8_t)siguiente, &cuadro, transicion);
+}
+
+// Tarea: una vez por trama mientras se reproduce
+static void tareaReproduccion(void) {
+	BENCH_BEGIN(BENCH_SECUENCIA);
+	uint16_t ahora = SCHED_ticks();
+	uint32_t avance = (uint32_t)(uint16_t)(ahora - ultimoTick) * velocidad;
+	ultimoTick = ahora;
+	
+	if (restante > avance) {
+		restante -= avance;
+		if (esperaRestante > restante) esperaRestante = restante;
+		} else {
+		// Lo que se pas del cuadro se descuenta del siguiente (sin deriva en bucles largos)
+		uint32_t sobrante = avance - restante;
+		avanzar();
+		if (restante > sobrante) {
+			restante -= sobrante;
+			if (esperaRestante > restante) esperaRestante = restante;
+		}
+	}
+	BENCH_END(BENCH_SECUENCIA);
+}
+
+static void arrancarTarea(void) {
+	ultimoTick = SCHED_ticks();
+	SCHED_setPeriod(idTarea, PLAY_PERIODO_MS);
+}
+
+void PLAY_init(SalidaPose salida, EventoReproduccion evento) {
+	funcionSalida = salida;
+	funcionEvento = evento;
+	estado = PLAY_DETENIDO;
+	
+	// Registrada detenida: PLAY_start le asigna el periodo
+	idTarea = SCHED_addTask(tareaReproduccion, 0, 0);
+	SCHED_stopTask(idTarea);
+}
+
+uint8_t PLAY_start(FuenteCuadros fuente, uint8_t cuadros) {
+	if (fuente == 0 || cuadros == 0 || idTarea == SCHED_SIN_TAREA) return 0;
+	
+	funcionFuente = fuente;
+	numCuadros = cuadros;
+	direccion = 1;
+	repeticionesHechas = 0;
+	estado = PLAY_REPRODUCIENDO;
+	
+	CuadroClave cuadro;
+	if (!funcionFuente(0, &cuadro)) {
+		estado = PLAY_DETENIDO;
+		return 0;
+	}
+	empezarCuadro(0, &cuadro, cuadro.transicion);
+	arrancarTarea();
+	return 1;
+}
+
+void PLAY_stop(void) {
+	estado = PLAY_DETENIDO;
+	SCHED_stopTask(idTarea);
+}
+
+void PLAY_pause(void) {
+	if (estado != PLAY_REPRODUCIENDO) return;
+	
+	estado = PLAY_PAUSADO;
+	SCHED_stopTask(idTarea);
+	MOTION_hold();
+}
+
+void PLAY_resume(void) {
+	if (estado != PLAY_PAUSADO) return;
+	
+	estado = PLAY_REPRODUCIENDO;
+	enviarPose();
+	arrancarTarea();
+}
+
+uint8_t PLAY_seek(uint8_t numero) {
+	if (estado == PLAY_DETENIDO || numero >= numCuadros) return 0;
+	
+	// Con pausa el servo va al cuadro pero el tiempo sigue detenido
+	CuadroClave cuadro;
+	if (!funcionFuente(numero, &cuadro)) return 0;
+	empezarCuadro(numero, &cuadro, cuadro.transicion);
+	if (estado == PLAY_REPRODUCIENDO) {
+		ultimoTick = SCHED_ticks();
+	}
+	return 1;
+}
+
+uint8_t PLAY_setRepeat(uint8_t modo, uint8_t veces) {
+	if (modo > PLAY_IDA_VUELTA) return 0;
+	
+	modoRepeticion = modo;
+	repeticiones = veces;
+	repeticionesHechas = 0;
+	return 1;
+}
+
+uint8_t PLAY_setSpeed(uint16_t porcentaje) {
+	if (porcentaje < PLAY_VELOCIDAD_MIN || porcentaje > PLAY_VELOCIDAD_MAX) return 0;
+	
+	velocidad = porcentaje;
+	
+	// Una transicin en curso se reenva con la duracin nueva
+	if (estado == PLAY_REPRODUCIENDO && restante > esperaRestante) {
+		enviarPose();
+	}
+	return 1;
+}
+
+uint8_t PLAY_state(void) {
+	return estado;
+}
+
+uint8_t PLAY_currentFrame(void) {
+	return cuadroActual;
+}
+
+uint16_t PLAY_speed(void) {
+	return velocidad;
+}
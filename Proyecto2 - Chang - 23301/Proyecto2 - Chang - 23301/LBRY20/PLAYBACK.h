@@ -0,0 +1,71 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica del motor de reproduccin de
+* secuencias. Una tarea del planificador corre cada trama de servo
+* (20 ms) mientras hay una reproduccin y descuenta el tiempo de cada
+* cuadro clave (transicin + espera) escalado por la velocidad, as que
+* pausar, continuar, buscar un cuadro o cambiar la velocidad tiene efecto
+* en la trama siguiente y el lazo principal nunca espera.
+*
+* Los cuadros vienen de una funcin fuente (ranuras guardadas o una
+* secuencia con nombre de la EEPROM) y la pose se entrega a una funcin
+* de salida con la duracin de la transicin ya escalada. La fuente se
+* llama una vez por cuadro; al avanzar los nmeros llegan en orden, as
+* que puede decodificar en flujo.
+*
+* Repeticin:
+*   - PLAY_UNA_VEZ: del primer cuadro al ltimo y termina
+*   - PLAY_BUCLE: vuelve al primer cuadro; repeticiones veces (0 = sin fin)
+*   - PLAY_IDA_VUELTA: al llegar a un extremo recorre la secuencia en
+*     sentido contrario; repeticiones = idas y vueltas (0 = sin fin)
+*
+* Velocidad en porcentaje (100 = tiempos grabados, 25-400).
+************************************************************************/
+
+#ifndef PLAYBACK_H
+#define PLAYBACK_H
+#include "../LBRY11/HAL.h"
+#include "../LBRY4/EEPROM.h"
+#include <stdint.h>
+
+// Estados
+#define PLAY_DETENIDO 0
+#define PLAY_REPRODUCIENDO 1
+#define PLAY_PAUSADO 2
+
+// Modos de repeticin
+#define PLAY_UNA_VEZ 0
+#define PLAY_BUCLE 1
+#define PLAY_IDA_VUELTA 2
+
+// Eventos
+#define PLAY_EVENTO_CUADRO 0        // Empieza un cuadro clave (numero = ndice)
+#define PLAY_EVENTO_FIN 1           // La reproduccin termin sola
+
+#define PLAY_VELOCIDAD_MIN 25       // %
+#define PLAY_VELOCIDAD_MAX 400
+#define PLAY_PERIODO_MS 20          // Una trama de servo
+
+typedef uint8_t (*FuenteCuadros)(uint8_t numero, CuadroClave* cuadro);
+typedef void (*SalidaPose)(const PosicionGarra* pose, uint16_t duracion);
+typedef void (*EventoReproduccion)(uint8_t evento, uint8_t numero);
+
+void PLAY_init(SalidaPose salida, EventoReproduccion evento);           // Register task (stopped) and callbacks
+uint8_t PLAY_start(FuenteCuadros fuente, uint8_t numCuadros);          // Play from keyframe 0, returns 0 if empty
+void PLAY_stop(void);                                                   // Stop (current move finishes)
+void PLAY_pause(void);                                                  // Freeze timing and hold the servos
+void PLAY_resume(void);                                                 // Continue from where it was paused
+uint8_t PLAY_seek(uint8_t numero);                                      // Jump to a keyframe, returns 0 if out of range
+uint8_t PLAY_setRepeat(uint8_t modo, uint8_t repeticiones);            // Repeat mode and count (0 = forever)
+uint8_t PLAY_setSpeed(uint16_t porcentaje);                             // Speed multiplier in %, returns 0 if out of range
+uint8_t PLAY_state(void);                                               // PLAY_DETENIDO, PLAY_REPRODUCIENDO or PLAY_PAUSADO
+uint8_t PLAY_currentFrame(void);                                        // Index of the current keyframe
+uint16_t PLAY_speed(void);                                              // Current speed in %
+
+#endif // PLAYBACK_H
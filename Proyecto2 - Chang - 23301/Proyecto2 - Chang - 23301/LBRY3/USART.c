@@ -11,6 +11,13 @@
 * transmisin y recepcin de datos seriales, incluyendo configuracin
 * automtica de velocidad de transmisin y manejo de interrupciones.
 *
+* Transmisin por interrupcin:
+* Los datos se copian a un buffer circular (FIFO) y la interrupcin
+* USART_UDRE_vect los enva uno a uno cuando el registro UDR0 queda libre.
+* Si el buffer se llena se aplica la poltica seleccionada (bloquear,
+* descartar o truncar) y se lleva registro del nivel mximo de llenado y
+* de los bytes descartados.
+*
 *
 * Conexiones de Hardware:
 *   - RX (Recepcin): PD0 - Pin de entrada serial
@@ -18,14 +25,88 @@
 ************************************************************************/
 
 #include "USART.h"
-#include <avr/interrupt.h>
+#include "../LBRY12/BENCH.h"
+#include <string.h>
+
+#define USART_TX_MASCARA (USART_TX_BUFFER - 1)
+
+// Buffer circular de transmisin
+static volatile char bufferTx[USART_TX_BUFFER];
+static volatile uint8_t cabezaTx = 0;        // Siguiente posicin a escribir
+static volatile uint8_t colaTx = 0;          // Siguiente byte a transmitir
+static volatile uint8_t maxOcupadoTx = 0;    // Nivel mximo de llenado registrado
+static volatile uint16_t descartadosTx = 0;  // Bytes descartados por buffer lleno
+static uint8_t politicaTx = USART_TX_BLOQUEAR;
+
+static uint8_t ocupadoTx(void) {
+	return (uint8_t)(cabezaTx - colaTx) & USART_TX_MASCARA;
+}
+
+static uint8_t libreTx(void) {
+	// Se deja una casilla vaca para distinguir buffer lleno de vaco
+	return (USART_TX_BUFFER - 1) - ocupadoTx();
+}
+
+// Agregar un byte al buffer (llamar con interrupciones deshabilitadas y con espacio libre)
+static void encolarTx(char dato) {
+	bufferTx[cabezaTx] = dato;
+	cabezaTx = (cabezaTx + 1) & USART_TX_MASCARA;
+	
+	uint8_t ocupado = ocupadoTx();
+	if (ocupado > maxOcupadoTx) {
+		maxOcupadoTx = ocupado;
+	}
+	
+	// Habilitar la interrupcin de registro vaco para que vace el buffer
+	UCSR0B |= (1 << UDRIE0);
+}
+
+// Transmitir un byte del buffer sin usar el ISR (interrupciones deshabilitadas)
+static void vaciarTxManual(void) {
+	while (!(UCSR0A & (1 << UDRE0)));
+	UDR0 = bufferTx[colaTx];
+	colaTx = (colaTx + 1) & USART_TX_MASCARA;
+}
+
+// Intentar encolar un byte segn la poltica. Devuelve 1 si se encol
+static uint8_t ponerTx(char dato) {
+	for (;;) {
+		uint8_t sreg = SREG;
+		cli();
+		
+		if (libreTx() > 0) {
+			encolarTx(dato);
+			SREG = sreg;
+			return 1;
+		}
+		
+		if (politicaTx != USART_TX_BLOQUEAR) {
+			descartadosTx++;
+			SREG = sreg;
+			return 0;
+		}
+		
+		// Si se llam con interrupciones deshabilitadas (por ejemplo desde un ISR)
+		// el ISR de transmisin no puede correr, as que se libera espacio a mano
+		if (!(sreg & (1 << SREG_I))) {
+			vaciarTxManual();
+		}
+		
+		SREG = sreg;
+	}
+}
 
 void initUSART(void) {
 	// Configurar velocidad de transmisin
 	UBRR0H = (uint8_t)(UBRR_VALUE >> 8);
 	UBRR0L = (uint8_t)UBRR_VALUE;
 	
+	// Buffer de transmisin vaco
+	cabezaTx = 0;
+	colaTx = 0;
+	
 	// Habilitar transmisor y receptor, y habilitar interrupcin de recepcin
+	// (la interrupcin de transmisin se habilita cuando hay datos en el buffer)
 	UCSR0B = (1 << RXEN0) | (1 << TXEN0) | (1 << RXCIE0);
 	
 	// Formato de trama: 8 bits de datos, 1 bit de parada, sin paridad
@@ -33,17 +114,63 @@ void initUSART(void) {
 }
 
 void sendUSARTData(char dato) {
-	// Esperar hasta que el buffer de transmisin est vaco
-	while (!(UCSR0A & (1 << UDRE0)));
-	
-	// Colocar dato en el buffer
-	UDR0 = dato;
+	// Colocar dato en el buffer, el ISR se encarga de transmitirlo
+	ponerTx(dato);
 }
 
 void sendUSARTString(const char* cadena) {
+	if (politicaTx == USART_TX_DESCARTAR) {
+		// Encolar el mensaje completo o descartarlo completo
+		uint16_t longitud = strlen(cadena);
+		uint8_t sreg = SREG;
+		cli();
+		if (longitud > libreTx()) {
+			descartadosTx += longitud;
+			} else {
+			while (*cadena) {
+				encolarTx(*cadena++);
+			}
+		}
+		SREG = sreg;
+		return;
+	}
+	
 	// Enviar cada carcter de la cadena
 	while (*cadena) {
-		sendUSARTData(*cadena++);
+		if (!ponerTx(*cadena++)) {
+			// Truncar: el resto de la cadena tambin se descarta
+			descartadosTx += strlen(cadena);
+			return;
+		}
+	}
+}
+
+void sendUSARTString_P(const char* cadena) {
+	if (politicaTx == USART_TX_DESCARTAR) {
+		// Encolar el mensaje completo o descartarlo completo
+		uint16_t longitud = strlen_P(cadena);
+		uint8_t sreg = SREG;
+		cli();
+		if (longitud > libreTx()) {
+			descartadosTx += longitud;
+			} else {
+			char dato;
+			while ((dato = pgm_read_byte(cadena++)) != 0) {
+				encolarTx(dato);
+			}
+		}
+		SREG = sreg;
+		return;
+	}
+	
+	// Leer cada carcter de la flash y enviarlo
+	char dato;
+	while ((dato = pgm_read_byte(cadena++)) != 0) {
+		if (!ponerTx(dato)) {
+			// Truncar: el resto de la cadena tambin se descarta
+			descartadosTx += strlen_P(cadena);
+			return;
+		}
 	}
 }
 
@@ -53,4 +180,66 @@ char receiveUSARTData(void) {
 	
 	// Retornar dato recibido
 	return UDR0;
-}
\ No newline at end of file
+}
+
+void setUSARTTxPolicy(uint8_t politica) {
+	if (politica <= USART_TX_TRUNCAR) {
+		politicaTx = politica;
+	}
+}
+
+uint8_t getUSARTTxPending(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t ocupado = ocupadoTx();
+	SREG = sreg;
+	return ocupado;
+}
+
+uint8_t getUSARTTxHighWater(void) {
+	return maxOcupadoTx;
+}
+
+uint16_t getUSARTTxDropped(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t descartados = descartadosTx;
+	SREG = sreg;
+	return descartados;
+}
+
+void resetUSARTTxStats(void) {
+	uint8_t sreg = SREG;
+	cli();
+	maxOcupadoTx = ocupadoTx();
+	descartadosTx = 0;
+	SREG = sreg;
+}
+
+void flushUSART(void) {
+	// Esperar a que el buffer se vace (a mano si las interrupciones estn apagadas)
+	while (getUSARTTxPending() > 0) {
+		if (!(SREG & (1 << SREG_I))) {
+			vaciarTxManual();
+		}
+	}
+	
+	// Esperar a que el ltimo byte pase de UDR0 al registro de desplazamiento
+	while (!(UCSR0A & (1 << UDRE0)));
+}
+
+// INTERRUPCIONES
+ISR(USART_UDRE_vect) {
+	BENCH_BEGIN(BENCH_ISR_UDRE);
+	
+	if (cabezaTx != colaTx) {
+		// Enviar el siguiente byte del buffer
+		UDR0 = bufferTx[colaTx];
+		colaTx = (colaTx + 1) & USART_TX_MASCARA;
+		} else {
+		// Buffer vaco: deshabilitar la interrupcin hasta que haya ms datos
+		UCSR0B &= ~(1 << UDRIE0);
+	}
+	
+	BENCH_END(BENCH_ISR_UDRE);
+}
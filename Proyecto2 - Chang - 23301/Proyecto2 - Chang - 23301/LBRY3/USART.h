@@ -11,6 +11,12 @@
 * transmisin y recepcin de datos seriales, as como constantes de
 * configuracin para velocidad de transmisin.
 *
+* La transmisin usa un buffer circular vaciado por la interrupcin
+* USART_UDRE_vect, por lo que las funciones de envo regresan de inmediato
+* mientras haya espacio. La poltica de buffer lleno es configurable.
+* Los textos fijos se guardan en flash y se envan con sendUSARTString_P
+* (por ejemplo sendUSARTString_P(PSTR("texto"))) para no ocupar SRAM.
+*
 * Conexiones de Hardware Requeridas: 
 *   - RX (Recepcin): PD0 - Conectar a TX del dispositivo externo
 *   - TX (Transmisin): PD1 - Conectar a RX del dispositivo externo
@@ -21,14 +27,28 @@
 #define USART_H
 
 #define F_CPU 16000000UL
-#include <avr/io.h>
+#include "../LBRY11/HAL.h"
 
 #define BAUD 9600
 #define UBRR_VALUE ((F_CPU/16/BAUD)-1)
 
+#define USART_TX_BUFFER 128   // Tamao del buffer de transmisin (potencia de 2)
+
+// Polticas cuando el buffer de transmisin est lleno
+#define USART_TX_BLOQUEAR 0   // Esperar a que el ISR libere espacio
+#define USART_TX_DESCARTAR 1  // Descartar completo el mensaje que no cabe
+#define USART_TX_TRUNCAR 2    // Encolar lo que cabe y descartar el resto
+
 void initUSART(void);                           // Initialize USART
 void sendUSARTData(char dato);                  // Send data via USART
 void sendUSARTString(const char* cadena);       // Send string via USART
+void sendUSARTString_P(const char* cadena);     // Send string stored in flash (PROGMEM/PSTR)
 char receiveUSARTData(void);                    // Receive data from USART
+void setUSARTTxPolicy(uint8_t politica);        // Set policy for a full TX buffer
+uint8_t getUSARTTxPending(void);                // Bytes waiting in the TX buffer
+uint8_t getUSARTTxHighWater(void);              // Highest TX buffer fill seen
+uint16_t getUSARTTxDropped(void);               // Bytes dropped because the buffer was full
+void resetUSARTTxStats(void);                   // Reset TX buffer counters
+void flushUSART(void);                          // Wait until the TX buffer is empty
 
 #endif // USART_H
\ No newline at end of file
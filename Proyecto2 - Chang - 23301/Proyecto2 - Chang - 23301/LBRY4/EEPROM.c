@@ -11,107 +11,1085 @@
 * persistente de posiciones de la garra robtica, incluyendo operaciones
 * de lectura, escritura y gestin de mltiples posiciones guardadas.
 *
-* Estructura de datos en EEPROM:
-* - Direccin 0: Nmero de posiciones guardadas
-* - Direcciones 1+: Posiciones guardadas (4 bytes cada una)
-*   - Byte 0: Posicin base
-*   - Byte 1: Posicin brazo1
-*   - Byte 2: Posicin brazo2
-*   - Byte 3: Posicin pinza
+* Estructura de datos en EEPROM (ver EEPROM.h):
+* - Direcciones 0-7: Cabecera con firma, versin del formato y CRC
+* - Direcciones 8-391: Dos bancos de registros de posiciones de 8 bytes
+* - Direcciones 392-989: Secuencias con nombre y tiempos por cuadro
+* - Direcciones 990-1023: Bloque de calibracin de los servos
+*
+* Al arrancar la imagen se valida en una sola pasada: cabecera, registro
+* de posiciones y cadena de secuencias (cada una con su CRC). Una
+* secuencia con CRC incorrecto se descarta en lugar de reproducirse. Una
+* imagen de las versiones 2 o 3 se migra sacando sus secuencias del
+* bloque de calibracin antes de escribir la cabecera nueva. Las
+* posiciones de los formatos anteriores (tabla fija o registro "PLOG") se
+* migran, y una EEPROM nueva recibe formato. Una cabecera "GARR" daada o
+* de otra versin, o una imagen que no se reconoce, no se borra: lo que
+* tenga CRC correcto se carga, la imagen queda en solo lectura y solo
+* EEPROM_format (a pedido del usuario) le vuelve a dar formato.
+*
+* Registro de escritura secuencial (log):
+* Cada vez que se guarda una posicin se agrega un registro nuevo con un
+* nmero de secuencia mayor, en lugar de sobrescribir siempre las mismas
+* celdas; la cuenta de posiciones viaja dentro de cada registro, as que
+* ya no existe una celda de contador que se desgaste primero. Cuando el
+* banco activo se llena, las posiciones vigentes se copian al otro banco
+* (compactacin) y se sigue escribiendo ah. Al arrancar se recorren
+* ambos bancos y, por cada ranura, gana el registro vlido (CRC correcto)
+* con la secuencia ms alta. Adems, un byte solo se escribe si su valor
+* cambia, y guardar una posicin idntica no escribe nada.
+*
+* Copia en RAM:
+* Al arrancar la tabla de posiciones y la cuenta se cargan a RAM; las
+* lecturas (loadPosition, Saved_Pos_Count) ya no acceden a la EEPROM y
+* cada guardado actualiza la copia y la EEPROM a la vez (write-through).
+*
+* Escritura asncrona:
+* writeEEPROMB no espera a la EEPROM (~3.4 ms por byte); solo agrega el
+* byte a una cola que la interrupcin EE_READY va escribiendo. As guardar
+* una posicin regresa de inmediato y los servos, botones y UART siguen
+* funcionando. readEEPROM consulta primero la cola (y el byte que se est
+* programando) y responde sin esperar a la EEPROM; solo una direccin que
+* no est pendiente espera a que termine la escritura en curso. La
+* comparacin con el valor guardado se hace en la interrupcin, justo
+* antes de programar cada byte. Si la cola se llena, writeEEPROMB espera
+* a que haya espacio.
+*
+* Secuencias:
+* Una secuencia se escribe cuadro por cuadro al final de la cadena
+* (EEPROM_beginSequence, EEPROM_addKeyframe, EEPROM_endSequence). El byte
+* de estado se escribe al final, as una secuencia incompleta nunca se
+* vuelve vlida. Borrar una secuencia solo la marca; cuando el espacio
+* libre ya no alcanza para una secuencia completa, EEPROM_beginSequence
+* recorre las vigentes hacia el inicio del rea y recupera el de las
+* borradas (compactacin). Si se corta la alimentacin a media
+* compactacin, las secuencias anteriores a la que se mova no se pierden.
+*
+* Cada cuadro se guarda como la diferencia con el anterior (1 a 3 bytes
+* en movimientos pequeos, en lugar de 6), con un cuadro absoluto cada
+* INTERVALO_ABSOLUTO cuadros. La reproduccin usa un LectorSecuencia que
+* decodifica un cuadro a la vez; para empezar en un cuadro intermedio se
+* saltan los encabezados hasta el cuadro absoluto anterior y solo se
+* decodifican los que siguen.
 *
 ************************************************************************/
 
 #include "EEPROM.h"
+#include "../LBRY12/BENCH.h"
+
+// Estado del registro (reconstruido al arrancar)
+static PosicionGarra cachePosiciones[MAX_POSICIONES_GUARDADAS]; // Copia en RAM de la tabla de posiciones
+static uint16_t ranurasGuardadas = 0;                       // Bit n = ranura n guardada alguna vez
+static uint8_t cuentaPosiciones = 0;
+static uint16_t secuenciaActual = 0;
+static uint8_t bancoActivo = 0;
+static uint8_t siguienteRegistro = 0;                       // ndice libre dentro del banco activo
+
+// Directorio de secuencias (reconstruido al arrancar)
+static uint16_t direccionSecuencia[MAX_SECUENCIAS];
+static uint8_t cuadrosSecuencia[MAX_SECUENCIAS];
+static uint8_t numSecuencias = 0;
+static uint8_t erroresSecuencia = 0;
+static uint16_t finSecuencias = DIRECCION_SECUENCIAS;      // Byte SECUENCIA_FIN de la cadena
+static uint16_t bytesRecuperables = 0;                      // Secuencias borradas o daadas dentro de la cadena
+
+// Estado de la imagen al arrancar
+static uint8_t estadoImagen = IMAGEN_VALIDA;
+
+// Secuencia en escritura (0 = ninguna)
+static uint16_t direccionNueva = 0;
+static uint16_t longitudNueva = 0;                          // Bytes de datos codificados
+static uint8_t cuadrosNueva = 0;
+static uint8_t crcNueva = 0;
+static CuadroClave anteriorNueva;                           // Base de las diferencias
+
+// Cola de escritura atendida por la interrupcin EE_READY
+static volatile uint16_t colaDireccion[EEPROM_COLA_ESCRITURA];
+static volatile uint8_t colaDato[EEPROM_COLA_ESCRITURA];
+static volatile uint8_t inicioCola = 0;
+static volatile uint8_t pendientesEscritura = 0;
+static volatile uint16_t direccionEnCurso = 0;              // Byte que se programa mientras EEPE = 1
+static volatile uint8_t datoEnCurso = 0;
+static volatile EepromCallback funcionEscritura = 0;
+
+static uint16_t direccionRegistro(uint8_t banco, uint8_t indice) {
+	return DIRECCION_REGISTROS + ((uint16_t)banco * REGISTROS_POR_BANCO + indice) * BYTES_POR_REGISTRO;
+}
+
+static uint8_t crc8(uint8_t crc, uint8_t dato) {
+	// CRC-8 con polinomio 0x07
+	crc ^= dato;
+	for (uint8_t i = 0; i < 8; i++) {
+		crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+	}
+	return crc;
+}
+
+// Escribir un registro en el banco activo (el banco debe tener espacio)
+static void escribirRegistro(uint8_t ranura, PosicionGarra posicion) {
+	uint16_t direccion = direccionRegistro(bancoActivo, siguienteRegistro);
+	uint8_t registro[BYTES_POR_REGISTRO];
+	
+	secuenciaActual++;
+	registro[0] = (uint8_t)secuenciaActual;
+	registro[1] = (uint8_t)(secuenciaActual >> 8);
+	registro[2] = (cuentaPosiciones << 4) | ranura;
+	registro[4] = posicion.base;
+	registro[5] = posicion.brazo1;
+	registro[6] = posicion.brazo2;
+	registro[7] = posicion.pinza;
+	
+	uint8_t crc = 0;
+	for (uint8_t i = 0; i < BYTES_POR_REGISTRO; i++) {
+		if (i != 3) crc = crc8(crc, registro[i]);
+	}
+	registro[3] = crc;
+	
+	// El byte de ranura se escribe al final: hasta entonces el registro sigue vaco
+	for (uint8_t i = 0; i < BYTES_POR_REGISTRO; i++) {
+		if (i != 2) writeEEPROMB(direccion + i, registro[i]);
+	}
+	writeEEPROMB(direccion + 2, registro[2]);
+	
+	// Escritura directa (write-through): la copia en RAM siempre est al da
+	if (ranura < MAX_POSICIONES_GUARDADAS) {
+		cachePosiciones[ranura] = posicion;
+		ranurasGuardadas |= (1 << ranura);
+	}
+	siguienteRegistro++;
+}
+
+// Agregar un registro, compactando primero si el banco activo est lleno
+static void agregarRegistro(uint8_t ranura, PosicionGarra posicion) {
+	if (siguienteRegistro >= REGISTROS_POR_BANCO) {
+		compactPositions();
+	}
+	escribirRegistro(ranura, posicion);
+}
+
+// Leer y validar un registro. Devuelve 1 si es vlido
+static uint8_t leerRegistro(uint16_t direccion, uint16_t* secuencia, uint8_t* ranuraCuenta) {
+	uint8_t registro[BYTES_POR_REGISTRO];
+	
+	registro[2] = readEEPROM(direccion + 2);
+	if (registro[2] == REGISTRO_VACIO) return 0;
+	
+	uint8_t crc = 0;
+	for (uint8_t i = 0; i < BYTES_POR_REGISTRO; i++) {
+		if (i != 2) registro[i] = readEEPROM(direccion + i);
+		if (i != 3) crc = crc8(crc, registro[i]);
+	}
+	if (crc != registro[3]) return 0;
+	
+	*secuencia = registro[0] | ((uint16_t)registro[1] << 8);
+	*ranuraCuenta = registro[2];
+	return 1;
+}
+
+// Reescribir las posiciones vigentes desde el inicio del banco activo
+static void copiarVigentes(void) {
+	siguienteRegistro = 0;
+	
+	// Todas las copias llevan la cuenta actual y secuencias nuevas
+	for (uint8_t ranura = 0; ranura < MAX_POSICIONES_GUARDADAS; ranura++) {
+		if (ranurasGuardadas & (1 << ranura)) {
+			escribirRegistro(ranura, cachePosiciones[ranura]);
+		}
+	}
+	
+	// Sin posiciones vigentes, un registro de cuenta conserva el estado
+	if (siguienteRegistro == 0) {
+		PosicionGarra vacia = {0, 0, 0, 0};
+		escribirRegistro(RANURA_CUENTA, vacia);
+	}
+}
+
+// Recorrer un registro de posiciones y quedarse con lo ms reciente
+static void escanearRegistro(uint16_t base, uint8_t registrosPorBanco) {
+	uint16_t direccionRanura[MAX_POSICIONES_GUARDADAS];
+	uint16_t secuenciaRanura[MAX_POSICIONES_GUARDADAS];
+	uint8_t hayRegistros = 0;
+	
+	for (uint8_t banco = 0; banco < 2; banco++) {
+		for (uint8_t i = 0; i < registrosPorBanco; i++) {
+			uint16_t direccion = base + ((uint16_t)banco * registrosPorBanco + i) * BYTES_POR_REGISTRO;
+			uint16_t secuencia;
+			uint8_t ranuraCuenta;
+			
+			if (!leerRegistro(direccion, &secuencia, &ranuraCuenta)) continue;
+			
+			// El registro ms reciente define la cuenta y el punto de escritura
+			if (!hayRegistros || (int16_t)(secuencia - secuenciaActual) > 0) {
+				hayRegistros = 1;
+				secuenciaActual = secuencia;
+				cuentaPosiciones = ranuraCuenta >> 4;
+				bancoActivo = banco;
+				siguienteRegistro = i + 1;
+			}
+			
+			uint8_t ranura = ranuraCuenta & 0x0F;
+			if (ranura < MAX_POSICIONES_GUARDADAS) {
+				if (!(ranurasGuardadas & (1 << ranura)) || (int16_t)(secuencia - secuenciaRanura[ranura]) > 0) {
+					ranurasGuardadas |= (1 << ranura);
+					direccionRanura[ranura] = direccion;
+					secuenciaRanura[ranura] = secuencia;
+				}
+			}
+		}
+	}
+	
+	if (cuentaPosiciones > MAX_POSICIONES_GUARDADAS) {
+		cuentaPosiciones = MAX_POSICIONES_GUARDADAS;
+	}
+	
+	// Cargar la tabla a RAM una sola vez; despus las lecturas no tocan la EEPROM
+	for (uint8_t ranura = 0; ranura < MAX_POSICIONES_GUARDADAS; ranura++) {
+		if (ranurasGuardadas & (1 << ranura)) {
+			// Los datos empiezan en el byte 4 del registro
+			uint16_t direccionBase = direccionRanura[ranura] + 4;
+			cachePosiciones[ranura].base = readEEPROM(direccionBase);
+			cachePosiciones[ranura].brazo1 = readEEPROM(direccionBase + 1);
+			cachePosiciones[ranura].brazo2 = readEEPROM(direccionBase + 2);
+			cachePosiciones[ranura].pinza = readEEPROM(direccionBase + 3);
+		}
+	}
+}
+
+// Leer la tabla fija del formato original (versin 0)
+static void leerTablaAnterior(void) {
+	uint8_t numAnteriores = readEEPROM(DIRECCION_NUM_POSICIONES);
+	
+	if (numAnteriores > MAX_POSICIONES_GUARDADAS) numAnteriores = 0;
+	for (uint8_t i = 0; i < numAnteriores; i++) {
+		uint16_t direccionBase = DIRECCION_BASE_EEPROM + (i * BYTES_POR_POSICION);
+		cachePosiciones[i].base = readEEPROM(direccionBase);
+		cachePosiciones[i].brazo1 = readEEPROM(direccionBase + 1);
+		cachePosiciones[i].brazo2 = readEEPROM(direccionBase + 2);
+		cachePosiciones[i].pinza = readEEPROM(direccionBase + 3);
+		ranurasGuardadas |= (1 << i);
+	}
+	cuentaPosiciones = numAnteriores;
+}
+
+// Comparar los primeros cuatro bytes de la imagen con una firma
+static uint8_t tieneFirma(const char* firma) {
+	for (uint8_t i = 0; i < 4; i++) {
+		if (readEEPROM(DIRECCION_CABECERA + i) != (uint8_t)firma[i]) return 0;
+	}
+	return 1;
+}
+
+// La versin 0 (o una EEPROM nueva) nunca us el rea de secuencias y no
+// tiene registros con CRC vlido donde ahora est el registro
+static uint8_t esTablaAnterior(void) {
+	uint16_t secuencia;
+	uint8_t ranuraCuenta;
+	
+	if (readEEPROM(DIRECCION_SECUENCIAS) != SECUENCIA_FIN) return 0;
+	for (uint8_t i = 0; i < 2 * REGISTROS_POR_BANCO; i++) {
+		if (leerRegistro(direccionRegistro(0, i), &secuencia, &ranuraCuenta)) return 0;
+	}
+	return 1;
+}
+
+// Verificar la firma, la versin y el CRC de la cabecera. Devuelve la
+// versin (2 a FORMATO_VERSION) o 0 si la cabecera no es vlida
+static uint8_t cabeceraValida(void) {
+	static const char firma[4] = {'G', 'A', 'R', 'R'};
+	uint8_t crc = 0;
+	
+	for (uint8_t i = 0; i < BYTES_CABECERA - 2; i++) {
+		uint8_t dato = readEEPROM(DIRECCION_CABECERA + i);
+		if (i < 4 && dato != firma[i]) return 0;
+		crc = crc8(crc, dato);
+	}
+	// Las versiones 2 y 3 tienen el mismo registro (la 2 sin secuencias
+	// comprimidas, ninguna con bloque de calibracin)
+	uint8_t version = readEEPROM(DIRECCION_CABECERA + 4);
+	if (version < 2 || version > FORMATO_VERSION) return 0;
+	if (readEEPROM(DIRECCION_CABECERA + 5) != REGISTROS_POR_BANCO) return 0;
+	if (crc != readEEPROM(DIRECCION_CABECERA + BYTES_CABECERA - 2)) return 0;
+	
+	return version;
+}
+
+// Escribir la cabecera de esta versin
+static void escribirCabecera(void) {
+	uint8_t cabecera[BYTES_CABECERA] = {'G', 'A', 'R', 'R', FORMATO_VERSION, REGISTROS_POR_BANCO, 0, 0xFF};
+	
+	for (uint8_t i = 0; i < BYTES_CABECERA - 2; i++) {
+		cabecera[BYTES_CABECERA - 2] = crc8(cabecera[BYTES_CABECERA - 2], cabecera[i]);
+	}
+	for (uint8_t i = 0; i < BYTES_CABECERA; i++) {
+		writeEEPROMB(DIRECCION_CABECERA + i, cabecera[i]);
+	}
+}
+
+// Dar formato a la imagen conservando las posiciones que ya estn en RAM
+static void formatearImagen(void) {
+	// Marcar todos los registros como vacos (un byte por registro)
+	for (uint8_t banco = 0; banco < 2; banco++) {
+		for (uint8_t i = 0; i < REGISTROS_POR_BANCO; i++) {
+			writeEEPROMB(direccionRegistro(banco, i) + 2, REGISTRO_VACIO);
+		}
+	}
+	
+	// Cadena de secuencias vaca
+	writeEEPROMB(DIRECCION_SECUENCIAS, SECUENCIA_FIN);
+	
+	// Migrar las posiciones como registros del banco 0
+	bancoActivo = 0;
+	copiarVigentes();
+	
+	// La cabecera se escribe al final: sin ella el formato se repite al arrancar
+	escribirCabecera();
+}
+
+// Longitud total de una secuencia sin el CRC (0 si ah no empieza una)
+static uint16_t longitudSecuencia(uint16_t direccion) {
+	uint8_t estado = readEEPROM(direccion);
+	
+	if (estado == SECUENCIA_DELTA || estado == SECUENCIA_BORRADA_DELTA) {
+		return BYTES_CABECERA_DELTA + (readEEPROM(direccion + BYTES_CABECERA_SECUENCIA) |
+		((uint16_t)readEEPROM(direccion + BYTES_CABECERA_SECUENCIA + 1) << 8));
+		} else if (estado == SECUENCIA_VALIDA || estado == SECUENCIA_BORRADA) {
+		return BYTES_CABECERA_SECUENCIA + (uint16_t)readEEPROM(direccion + 1) * BYTES_POR_CUADRO;
+	}
+	return 0;
+}
+
+// Recorrer la cadena de secuencias hasta fin, validando el CRC de cada una
+static void cargarSecuencias(uint16_t fin) {
+	uint16_t direccion = DIRECCION_SECUENCIAS;
+	
+	while (direccion < fin) {
+		uint8_t estado = readEEPROM(direccion);
+		uint8_t cuadros = readEEPROM(direccion + 1);
+		
+		// Las borradas tambin se saltan
+		uint16_t longitud = longitudSecuencia(direccion);
+		if (longitud == 0) break;
+		if (longitud >= fin || direccion + longitud + 1 > fin) break;
+		
+		// Lo que no queda en el directorio se recupera al compactar
+		uint8_t vigente = 0;
+		
+		if (estado == SECUENCIA_VALIDA || estado == SECUENCIA_DELTA) {
+			// Mismo orden que al escribir: nombre, datos, longitud y cuadros
+			uint8_t crc = 0;
+			for (uint16_t i = 2; i < longitud; i++) {
+				if (i == BYTES_CABECERA_SECUENCIA && estado == SECUENCIA_DELTA) i += 2;
+				if (i < longitud) crc = crc8(crc, readEEPROM(direccion + i));
+			}
+			if (estado == SECUENCIA_DELTA) {
+				crc = crc8(crc, readEEPROM(direccion + BYTES_CABECERA_SECUENCIA));
+				crc = crc8(crc, readEEPROM(direccion + BYTES_CABECERA_SECUENCIA + 1));
+			}
+			crc = crc8(crc, cuadros);
+			
+			if (crc != readEEPROM(direccion + longitud)) {
+				erroresSecuencia++;
+				} else if (numSecuencias < MAX_SECUENCIAS) {
+				direccionSecuencia[numSecuencias] = direccion;
+				cuadrosSecuencia[numSecuencias] = cuadros;
+				numSecuencias++;
+				vigente = 1;
+			}
+		}
+		if (!vigente) bytesRecuperables += longitud + 1;
+		
+		direccion += longitud + 1;
+	}
+	
+	finSecuencias = direccion;
+}
+
+// Migracin a la versin 4: la cadena de una imagen anterior puede llegar
+// hasta el final de la EEPROM, donde ahora est el bloque de calibracin
+static void liberarCalibracion(void) {
+	if (finSecuencias <= FIN_SECUENCIAS) return;
+	
+	// Bajar las vigentes sobre las borradas y descartar las que aun as no caben
+	EEPROM_compactSequences();
+	while (numSecuencias > 0) {
+		uint16_t direccion = direccionSecuencia[numSecuencias - 1];
+		if (direccion + longitudSecuencia(direccion) + 1 <= FIN_SECUENCIAS) break;
+		numSecuencias--;
+		erroresSecuencia++;
+		finSecuencias = direccion;
+	}
+	if (finSecuencias < FIN_SECUENCIAS) {
+		writeEEPROMB(finSecuencias, SECUENCIA_FIN);
+	}
+	
+	// Esos bytes eran datos de secuencia, no una calibracin
+	writeEEPROMB(DIRECCION_CALIBRACION, 0xFF);
+}
 
 // Inicializar la EEPROM
 void initEEPROM(void) {
-	// La EEPROM en AVR no requiere inicializacin especfica
-	// Pero podemos verificar si es la primera vez que se usa
-	if (readEEPROM(DIRECCION_NUM_POSICIONES) == 0xFF) {
-		// Si es la primera vez, inicializar el contador de posiciones
-		writeEEPROMB(DIRECCION_NUM_POSICIONES, 0);
+	// Las ranuras nunca guardadas se leen como una EEPROM borrada
+	for (uint8_t i = 0; i < MAX_POSICIONES_GUARDADAS; i++) {
+		cachePosiciones[i].base = 0xFF;
+		cachePosiciones[i].brazo1 = 0xFF;
+		cachePosiciones[i].brazo2 = 0xFF;
+		cachePosiciones[i].pinza = 0xFF;
+	}
+	ranurasGuardadas = 0;
+	cuentaPosiciones = 0;
+	secuenciaActual = 0;
+	bancoActivo = 0;
+	siguienteRegistro = 0;
+	numSecuencias = 0;
+	erroresSecuencia = 0;
+	finSecuencias = DIRECCION_SECUENCIAS;
+	bytesRecuperables = 0;
+	direccionNueva = 0;
+	estadoImagen = IMAGEN_VALIDA;
+	
+	// Imagen de esta versin: validar registro y secuencias en una pasada
+	uint8_t version = cabeceraValida();
+	if (version == FORMATO_VERSION) {
+		escanearRegistro(DIRECCION_REGISTROS, REGISTROS_POR_BANCO);
+		cargarSecuencias(FIN_SECUENCIAS);
+		return;
+	}
+	
+	// Versiones 2 y 3: sacar las secuencias del bloque de calibracin
+	if (version != 0) {
+		escanearRegistro(DIRECCION_REGISTROS, REGISTROS_POR_BANCO);
+		cargarSecuencias(V3_FIN_SECUENCIAS);
+		liberarCalibracion();
+		escribirCabecera();     // Al final: si se corta, la migracin se repite
+		return;
 	}
+	
+	// Cabecera daada o de otra versin: cargar lo que tenga CRC correcto,
+	// pero no escribir nada hasta que el usuario pida dar formato
+	if (tieneFirma("GARR")) {
+		escanearRegistro(DIRECCION_REGISTROS, REGISTROS_POR_BANCO);
+		cargarSecuencias(FIN_SECUENCIAS);
+		estadoImagen = IMAGEN_INVALIDA;
+		return;
+	}
+	
+	// Formato anterior (o EEPROM nueva): rescatar las posiciones y dar formato
+	if (tieneFirma("PLOG")) {
+		escanearRegistro(V1_DIRECCION_REGISTROS, V1_REGISTROS_POR_BANCO);
+		} else if (esTablaAnterior()) {
+		leerTablaAnterior();
+		} else {
+		estadoImagen = IMAGEN_INVALIDA;
+		return;
+	}
+	formatearImagen();
+	estadoImagen = IMAGEN_FORMATEADA;
 }
 
-// Escribir un byte en la EEPROM
-void writeEEPROMB(uint16_t address, uint8_t dato) {
-	// Esperar a que cualquier escritura previa termine
-	while(EECR & (1<<EEPE));
+// Borrar posiciones y secuencias y dar formato (a pedido del usuario)
+void EEPROM_format(void) {
+	for (uint8_t i = 0; i < MAX_POSICIONES_GUARDADAS; i++) {
+		cachePosiciones[i].base = 0xFF;
+		cachePosiciones[i].brazo1 = 0xFF;
+		cachePosiciones[i].brazo2 = 0xFF;
+		cachePosiciones[i].pinza = 0xFF;
+	}
+	ranurasGuardadas = 0;
+	cuentaPosiciones = 0;
+	numSecuencias = 0;
+	erroresSecuencia = 0;
+	finSecuencias = DIRECCION_SECUENCIAS;
+	bytesRecuperables = 0;
+	direccionNueva = 0;
 	
+	estadoImagen = IMAGEN_FORMATEADA;
+	formatearImagen();
+}
+
+uint8_t EEPROM_imageStatus(void) {
+	return estadoImagen;
+}
+
+// Iniciar la escritura fsica de un byte (EEPE debe estar en 0)
+static void iniciarEscrituraHW(uint16_t address, uint8_t dato) {
 	// Preparar la direccin y los datos
 	EEAR = address;
 	EEDR = dato;
 	
-	// Escribir uno lgico en EEMPE
+	// EEMPE y EEPE deben escribirse con menos de 4 ciclos de diferencia
+	uint8_t sreg = SREG;
+	cli();
 	EECR |= (1<<EEMPE);
-	
-	// Iniciar la escritura estableciendo EEPE
 	EECR |= (1<<EEPE);
+	SREG = sreg;
 }
 
-// Leer un byte de la EEPROM
-uint8_t readEEPROM(uint16_t address) {
-	// Esperar a que cualquier escritura previa termine
-	while(EECR & (1<<EEPE));
-	
-	// Preparar la direccin
+// Leer la celda fsica (EEPE debe estar en 0)
+static uint8_t leerHW(uint16_t address) {
 	EEAR = address;
-	
-	// Iniciar la lectura estableciendo EERE
 	EECR |= (1<<EERE);
-	
-	// Devolver los datos ledos
 	return EEDR;
 }
 
-// Guardar una posicin completa en la EEPROM
-void savePosition(uint8_t positionNum, PosicionGarra posicion) {
-	// Calcular la direccin base para esta posicin
-	uint16_t direccionBase = DIRECCION_BASE_EEPROM + (positionNum * BYTES_POR_POSICION);
+// ltimo valor encolado para una direccin (con interrupciones deshabilitadas)
+static uint8_t buscarEnCola(uint16_t address, uint8_t* dato) {
+	for (uint8_t i = pendientesEscritura; i > 0; i--) {
+		uint8_t indice = (inicioCola + i - 1) % EEPROM_COLA_ESCRITURA;
+		if (colaDireccion[indice] == address) {
+			*dato = colaDato[indice];
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Sacar el siguiente byte de la cola y escribirlo (EEPE debe estar en 0)
+static void atenderCola(void) {
+	while (pendientesEscritura != 0) {
+		uint16_t direccion = colaDireccion[inicioCola];
+		uint8_t dato = colaDato[inicioCola];
+		inicioCola = (inicioCola + 1) % EEPROM_COLA_ESCRITURA;
+		pendientesEscritura--;
+		
+		// Si la celda ya tiene ese valor no se gasta el ciclo de escritura
+		if (leerHW(direccion) != dato) {
+			direccionEnCurso = direccion;
+			datoEnCurso = dato;
+			iniciarEscrituraHW(direccion, dato);
+			return;
+		}
+	}
 	
-	// Escribir cada componente de la posicin
-	writeEEPROMB(direccionBase, posicion.base);
-	writeEEPROMB(direccionBase + 1, posicion.brazo1);
-	writeEEPROMB(direccionBase + 2, posicion.brazo2);
-	writeEEPROMB(direccionBase + 3, posicion.pinza);
+	// Cola vaca: apagar la interrupcin y avisar que termin
+	EECR &= ~(1<<EERIE);
+	if (funcionEscritura) {
+		funcionEscritura();
+	}
+}
+
+// Escribir un byte en la EEPROM (solo si el valor cambia)
+void writeEEPROMB(uint16_t address, uint8_t dato) {
+	// Imagen que no se reconoce: no tocarla hasta EEPROM_format
+	if (estadoImagen == IMAGEN_INVALIDA) return;
 	
-	// Si estamos guardando en una nueva posicin, incrementar el contador
-	uint8_t numPosiciones = Saved_Pos_Count();
-	if (positionNum >= numPosiciones) {
-		increment_Saved_Count();
+	// Cola llena: esperar a que el ISR libere espacio (o atenderla aqu si
+	// las interrupciones estn deshabilitadas)
+	while (pendientesEscritura >= EEPROM_COLA_ESCRITURA) {
+		if (!(SREG & (1<<SREG_I)) && !(EECR & (1<<EEPE))) {
+			atenderCola();
+		}
 	}
+	
+	// Encolar el byte; la interrupcin EE_READY lo compara y lo escribe
+	// cuando la EEPROM est libre
+	uint8_t sreg = SREG;
+	cli();
+	uint8_t anterior;
+	if (buscarEnCola(address, &anterior) && anterior == dato) {
+		// Ese mismo valor ya est pendiente
+		SREG = sreg;
+		return;
+	}
+	uint8_t fin = (inicioCola + pendientesEscritura) % EEPROM_COLA_ESCRITURA;
+	colaDireccion[fin] = address;
+	colaDato[fin] = dato;
+	pendientesEscritura++;
+	EECR |= (1<<EERIE);
+	SREG = sreg;
 }
 
-// Cargar una posicin desde la EEPROM
-PosicionGarra loadPosition(uint8_t positionNum) {
-	PosicionGarra posicion;
+// Leer un byte de la EEPROM (incluye los bytes que an esperan en la cola)
+uint8_t readEEPROM(uint16_t address) {
+	uint8_t dato;
+	uint8_t sreg = SREG;
+	cli();
 	
-	// Calcular la direccin base para esta posicin
-	uint16_t direccionBase = DIRECCION_BASE_EEPROM + (positionNum * BYTES_POR_POSICION);
+	// El valor ms reciente puede estar todava en la cola: no hace falta esperar
+	if (buscarEnCola(address, &dato)) {
+		SREG = sreg;
+		return dato;
+	}
 	
-	// Leer cada componente de la posicin
-	posicion.base = readEEPROM(direccionBase);
-	posicion.brazo1 = readEEPROM(direccionBase + 1);
-	posicion.brazo2 = readEEPROM(direccionBase + 2);
-	posicion.pinza = readEEPROM(direccionBase + 3);
+	while (EECR & (1<<EEPE)) {
+		// La celda que se est programando ya tiene su valor en RAM
+		if (address == direccionEnCurso) {
+			dato = datoEnCurso;
+			SREG = sreg;
+			return dato;
+		}
+		
+		// Otra direccin: esperar a que termine la escritura (con interrupciones activas).
+		// El ISR solo saca bytes de la cola, as que la direccin sigue sin estar pendiente
+		SREG = sreg;
+		while (EECR & (1<<EEPE));
+		cli();
+	}
 	
-	return posicion;
+	dato = leerHW(address);
+	SREG = sreg;
+	return dato;
+}
+
+// Nmero de bytes que esperan ser escritos
+uint8_t EEPROM_pending(void) {
+	return pendientesEscritura;
+}
+
+// 1 mientras haya bytes en la cola o una escritura en curso
+uint8_t EEPROM_isBusy(void) {
+	return (pendientesEscritura != 0) || (EECR & (1<<EEPE));
+}
+
+// Esperar a que todas las escrituras pendientes terminen (p. ej. antes de apagar)
+void EEPROM_flush(void) {
+	while (EEPROM_isBusy()) {
+		// Sin interrupciones el ISR no corre: atender la cola aqu
+		if (!(SREG & (1<<SREG_I)) && !(EECR & (1<<EEPE)) && pendientesEscritura != 0) {
+			atenderCola();
+		}
+	}
+}
+
+// Registrar la funcin llamada (desde el ISR) cuando la cola se vaca
+void EEPROM_setWriteCallback(EepromCallback funcion) {
+	funcionEscritura = funcion;
+}
+
+// Guardar una posicin completa en la EEPROM. Devuelve 0 si no se pudo
+// (ranura fuera de rango o imagen en solo lectura)
+uint8_t savePosition(uint8_t positionNum, PosicionGarra posicion) {
+	if (positionNum >= MAX_POSICIONES_GUARDADAS) return 0;
+	if (estadoImagen == IMAGEN_INVALIDA) return 0;
+	
+	// Si estamos guardando en una nueva posicin, incrementar el contador
+	uint8_t cuentaAnterior = cuentaPosiciones;
+	if (positionNum >= cuentaPosiciones && cuentaPosiciones < MAX_POSICIONES_GUARDADAS) {
+		cuentaPosiciones++;
+	}
+	
+	// Si la ranura ya tiene exactamente esa posicin, no escribir nada
+	if (cuentaPosiciones == cuentaAnterior && (ranurasGuardadas & (1 << positionNum))) {
+		PosicionGarra actual = cachePosiciones[positionNum];
+		if (actual.base == posicion.base && actual.brazo1 == posicion.brazo1 &&
+		actual.brazo2 == posicion.brazo2 && actual.pinza == posicion.pinza) {
+			return 1;
+		}
+	}
+	
+	agregarRegistro(positionNum, posicion);
+	return 1;
+}
+
+// Cargar una posicin (desde la copia en RAM)
+PosicionGarra loadPosition(uint8_t positionNum) {
+	// Ranura fuera de rango: devolver los valores de una EEPROM borrada
+	if (positionNum >= MAX_POSICIONES_GUARDADAS) {
+		PosicionGarra posicion = {0xFF, 0xFF, 0xFF, 0xFF};
+		return posicion;
+	}
+	
+	return cachePosiciones[positionNum];
 }
 
 // Obtener el nmero de posiciones guardadas
 uint8_t Saved_Pos_Count(void) {
-	return readEEPROM(DIRECCION_NUM_POSICIONES);
+	return cuentaPosiciones;
 }
 
 // Incrementar el contador de posiciones guardadas
 void increment_Saved_Count(void) {
-	uint8_t numPosiciones = Saved_Pos_Count();
-	if (numPosiciones < MAX_POSICIONES_GUARDADAS) {
-		writeEEPROMB(DIRECCION_NUM_POSICIONES, numPosiciones + 1);
+	if (cuentaPosiciones < MAX_POSICIONES_GUARDADAS) {
+		cuentaPosiciones++;
+		PosicionGarra vacia = {0, 0, 0, 0};
+		agregarRegistro(RANURA_CUENTA, vacia);
 	}
 }
 
 // Borrar todas las posiciones (reiniciar contador)
 void clearAllPositions(void) {
-	writeEEPROMB(DIRECCION_NUM_POSICIONES, 0);
-}
\ No newline at end of file
+	if (cuentaPosiciones == 0) return;
+	
+	cuentaPosiciones = 0;
+	PosicionGarra vacia = {0, 0, 0, 0};
+	agregarRegistro(RANURA_CUENTA, vacia);
+}
+
+// Copiar las posiciones vigentes al otro banco y continuar escribiendo ah
+void compactPositions(void) {
+	// Las posiciones vigentes ya estn en RAM: el banco destino puede
+	// sobrescribirse aunque tenga registros de una compactacin interrumpida
+	bancoActivo ^= 1;
+	copiarVigentes();
+}
+
+// Empezar una secuencia nueva al final de la cadena. Devuelve 1 si hay espacio
+// (0 tambin con la imagen en solo lectura)
+uint8_t EEPROM_beginSequence(const char* nombre) {
+	if (estadoImagen == IMAGEN_INVALIDA) return 0;
+	if (numSecuencias >= MAX_SECUENCIAS) return 0;
+	
+	// Sin espacio para una secuencia de ranuras completa: recuperar el de las borradas
+	if (bytesRecuperables > 0 && FIN_SECUENCIAS - finSecuencias < RESERVA_SECUENCIA) {
+		EEPROM_compactSequences();
+	}
+	if (finSecuencias + BYTES_CABECERA_DELTA + 1 > FIN_SECUENCIAS) return 0;
+	
+	direccionNueva = finSecuencias;
+	longitudNueva = 0;
+	cuadrosNueva = 0;
+	crcNueva = 0;
+	
+	// El byte de estado sigue en SECUENCIA_FIN hasta EEPROM_endSequence
+	for (uint8_t i = 0; i < LONGITUD_NOMBRE; i++) {
+		uint8_t caracter = *nombre ? (uint8_t)*nombre++ : 0;
+		writeEEPROMB(direccionNueva + 2 + i, caracter);
+		crcNueva = crc8(crcNueva, caracter);
+	}
+	
+	return 1;
+}
+
+// Codificar un cuadro respecto al anterior. Devuelve el nmero de bytes
+static uint8_t codificarCuadro(const CuadroClave* cuadro, const CuadroClave* anterior, uint8_t absoluto, uint8_t* bytes) {
+	const uint8_t* nuevo = &cuadro->pose.base;
+	const uint8_t* previo = &anterior->pose.base;
+	int8_t diferencias[4];
+	uint8_t ejes = 0;
+	uint8_t numEjes = 0;
+	uint8_t caben4bits = 1;
+	
+	for (uint8_t eje = 0; eje < 4 && !absoluto; eje++) {
+		int16_t diferencia = (int16_t)nuevo[eje] - previo[eje];
+		if (diferencia == 0) continue;
+		if (diferencia < -128 || diferencia > 127) {
+			absoluto = 1;
+			break;
+		}
+		if (diferencia < -8 || diferencia > 7) caben4bits = 0;
+		diferencias[numEjes++] = (int8_t)diferencia;
+		ejes |= (1 << eje);
+	}
+	
+	if (absoluto) {
+		bytes[0] = CUADRO_ABSOLUTO;
+		for (uint8_t eje = 0; eje < 4; eje++) {
+			bytes[1 + eje] = nuevo[eje];
+		}
+		bytes[5] = cuadro->transicion;
+		bytes[6] = cuadro->espera;
+		return 7;
+	}
+	
+	uint8_t n = 1;
+	bytes[0] = ejes;
+	if (cuadro->transicion != anterior->transicion || cuadro->espera != anterior->espera) {
+		bytes[0] |= CUADRO_TIEMPOS;
+		bytes[n++] = cuadro->transicion;
+		bytes[n++] = cuadro->espera;
+	}
+	if (caben4bits && numEjes > 1) {
+		bytes[0] |= CUADRO_NIBBLES;
+		for (uint8_t i = 0; i < numEjes; i += 2) {
+			uint8_t alto = (i + 1 < numEjes) ? ((uint8_t)diferencias[i + 1] << 4) : 0;
+			bytes[n++] = ((uint8_t)diferencias[i] & 0x0F) | alto;
+		}
+		} else {
+		for (uint8_t i = 0; i < numEjes; i++) {
+			bytes[n++] = (uint8_t)diferencias[i];
+		}
+	}
+	return n;
+}
+
+// Agregar un cuadro a la secuencia en escritura. Devuelve 1 si hay espacio
+uint8_t EEPROM_addKeyframe(const CuadroClave* cuadro) {
+	if (direccionNueva == 0 || cuadrosNueva == 0xFF) return 0;
+	
+	uint8_t bytes[1 + BYTES_POR_CUADRO];
+	uint8_t absoluto = (cuadrosNueva % INTERVALO_ABSOLUTO) == 0;
+	uint8_t n = codificarCuadro(cuadro, &anteriorNueva, absoluto, bytes);
+	
+	uint16_t direccion = direccionNueva + BYTES_CABECERA_DELTA + longitudNueva;
+	if (direccion + n + 1 > FIN_SECUENCIAS) return 0;
+	
+	for (uint8_t i = 0; i < n; i++) {
+		writeEEPROMB(direccion + i, bytes[i]);
+		crcNueva = crc8(crcNueva, bytes[i]);
+	}
+	longitudNueva += n;
+	cuadrosNueva++;
+	anteriorNueva = *cuadro;
+	
+	return 1;
+}
+
+// Cerrar la secuencia en escritura. Devuelve su ndice o SIN_SECUENCIA
+uint8_t EEPROM_endSequence(void) {
+	if (direccionNueva == 0) return SIN_SECUENCIA;
+	
+	uint16_t direccion = direccionNueva;
+	direccionNueva = 0;
+	if (cuadrosNueva == 0) return SIN_SECUENCIA;
+	
+	uint16_t longitud = BYTES_CABECERA_DELTA + longitudNueva;
+	uint8_t crc = crcNueva;
+	crc = crc8(crc, (uint8_t)longitudNueva);
+	crc = crc8(crc, (uint8_t)(longitudNueva >> 8));
+	crc = crc8(crc, cuadrosNueva);
+	
+	writeEEPROMB(direccion + 1, cuadrosNueva);
+	writeEEPROMB(direccion + BYTES_CABECERA_SECUENCIA, (uint8_t)longitudNueva);
+	writeEEPROMB(direccion + BYTES_CABECERA_SECUENCIA + 1, (uint8_t)(longitudNueva >> 8));
+	writeEEPROMB(direccion + longitud, crc);
+	
+	// Nuevo fin de la cadena y, por ltimo, el estado que hace vlida la secuencia
+	if (direccion + longitud + 1 < FIN_SECUENCIAS) {
+		writeEEPROMB(direccion + longitud + 1, SECUENCIA_FIN);
+	}
+	writeEEPROMB(direccion, SECUENCIA_DELTA);
+	
+	finSecuencias = direccion + longitud + 1;
+	direccionSecuencia[numSecuencias] = direccion;
+	cuadrosSecuencia[numSecuencias] = cuadrosNueva;
+	
+	return numSecuencias++;
+}
+
+void EEPROM_deleteSequence(uint8_t indice) {
+	if (indice >= numSecuencias) return;
+	
+	// La marca de borrado conserva el tipo para poder saltar la secuencia al arrancar
+	uint8_t estado = readEEPROM(direccionSecuencia[indice]);
+	writeEEPROMB(direccionSecuencia[indice], (estado == SECUENCIA_DELTA) ? SECUENCIA_BORRADA_DELTA : SECUENCIA_BORRADA);
+	bytesRecuperables += longitudSecuencia(direccionSecuencia[indice]) + 1;
+	
+	// Quitarla del directorio (las siguientes bajan un ndice)
+	numSecuencias--;
+	for (uint8_t i = indice; i < numSecuencias; i++) {
+		direccionSecuencia[i] = direccionSecuencia[i + 1];
+		cuadrosSecuencia[i] = cuadrosSecuencia[i + 1];
+	}
+}
+
+void EEPROM_clearSequences(void) {
+	writeEEPROMB(DIRECCION_SECUENCIAS, SECUENCIA_FIN);
+	
+	numSecuencias = 0;
+	erroresSecuencia = 0;
+	finSecuencias = DIRECCION_SECUENCIAS;
+	bytesRecuperables = 0;
+	direccionNueva = 0;
+}
+
+// Recorrer las secuencias vigentes hacia el inicio del rea, sobre las borradas
+void EEPROM_compactSequences(void) {
+	if (direccionNueva != 0 || bytesRecuperables == 0) return;
+	
+	uint16_t destino = DIRECCION_SECUENCIAS;
+	for (uint8_t s = 0; s < numSecuencias; s++) {
+		uint16_t origen = direccionSecuencia[s];
+		uint16_t longitud = longitudSecuencia(origen) + 1;     // Con el CRC
+		
+		if (origen != destino) {
+			// El destino est antes del origen: copiar hacia adelante no pisa
+			// bytes que falten por leer. El estado se escribe al final, as la
+			// copia solo es vlida cuando est completa
+			uint8_t estado = readEEPROM(origen);
+			for (uint16_t i = 1; i < longitud; i++) {
+				writeEEPROMB(destino + i, readEEPROM(origen + i));
+			}
+			writeEEPROMB(destino, estado);
+			direccionSecuencia[s] = destino;
+		}
+		destino += longitud;
+	}
+	
+	if (destino < FIN_SECUENCIAS) {
+		writeEEPROMB(destino, SECUENCIA_FIN);
+	}
+	finSecuencias = destino;
+	bytesRecuperables = 0;
+}
+
+uint8_t EEPROM_sequenceCount(void) {
+	return numSecuencias;
+}
+
+uint8_t EEPROM_findSequence(const char* nombre) {
+	for (uint8_t indice = 0; indice < numSecuencias; indice++) {
+		uint8_t i;
+		for (i = 0; i < LONGITUD_NOMBRE; i++) {
+			if (readEEPROM(direccionSecuencia[indice] + 2 + i) != (uint8_t)nombre[i]) break;
+			if (nombre[i] == 0) return indice;
+		}
+		if (i == LONGITUD_NOMBRE) return indice;
+	}
+	
+	return SIN_SECUENCIA;
+}
+
+void EEPROM_getSequenceName(uint8_t indice, char* nombre) {
+	nombre[0] = 0;
+	if (indice >= numSecuencias) return;
+	
+	for (uint8_t i = 0; i < LONGITUD_NOMBRE; i++) {
+		nombre[i] = readEEPROM(direccionSecuencia[indice] + 2 + i);
+	}
+	nombre[LONGITUD_NOMBRE] = 0;
+}
+
+uint8_t EEPROM_sequenceLength(uint8_t indice) {
+	if (indice >= numSecuencias) return 0;
+	
+	return cuadrosSecuencia[indice];
+}
+
+// Leer un cuadro de una secuencia. Devuelve 1 si existe
+uint8_t EEPROM_readKeyframe(uint8_t indice, uint8_t numero, CuadroClave* cuadro) {
+	LectorSecuencia lector;
+	
+	if (!EEPROM_openSequence(indice, numero, &lector)) return 0;
+	return EEPROM_nextKeyframe(&lector, cuadro);
+}
+
+// Bytes que ocupa un cuadro codificado, segn su encabezado
+static uint8_t longitudCuadro(uint8_t encabezado) {
+	if (encabezado & CUADRO_ABSOLUTO) return 7;
+	
+	uint8_t numEjes = 0;
+	for (uint8_t ejes = encabezado & CUADRO_EJES; ejes; ejes >>= 1) {
+		numEjes += ejes & 1;
+	}
+	if (encabezado & CUADRO_NIBBLES) numEjes = (numEjes + 1) / 2;
+	
+	return 1 + numEjes + ((encabezado & CUADRO_TIEMPOS) ? 2 : 0);
+}
+
+// Preparar un lector en el cuadro numero. Devuelve 1 si existe
+uint8_t EEPROM_openSequence(uint8_t indice, uint8_t numero, LectorSecuencia* lector) {
+	if (indice >= numSecuencias || numero >= cuadrosSecuencia[indice]) return 0;
+	
+	uint16_t direccion = direccionSecuencia[indice];
+	lector->comprimida = (readEEPROM(direccion) == SECUENCIA_DELTA);
+	
+	if (!lector->comprimida) {
+		// Cuadros de tamao fijo: acceso directo
+		lector->direccion = direccion + BYTES_CABECERA_SECUENCIA + (uint16_t)numero * BYTES_POR_CUADRO;
+		lector->restantes = cuadrosSecuencia[indice] - numero;
+		return 1;
+	}
+	
+	// Saltar encabezados hasta el ltimo cuadro absoluto antes de numero
+	direccion += BYTES_CABECERA_DELTA;
+	uint16_t direccionAbsoluto = direccion;
+	uint8_t cuadroAbsoluto = 0;
+	for (uint8_t i = 0; i < numero; i++) {
+		direccion += longitudCuadro(readEEPROM(direccion));
+		if (readEEPROM(direccion) & CUADRO_ABSOLUTO) {
+			direccionAbsoluto = direccion;
+			cuadroAbsoluto = i + 1;
+		}
+	}
+	
+	// Decodificar desde ah los cuadros que faltan
+	lector->direccion = direccionAbsoluto;
+	lector->restantes = cuadrosSecuencia[indice] - cuadroAbsoluto;
+	for (uint8_t i = cuadroAbsoluto; i < numero; i++) {
+		EEPROM_nextKeyframe(lector, &lector->anterior);
+	}
+	
+	return 1;
+}
+
+// Decodificar el siguiente cuadro. Devuelve 0 al terminar la secuencia
+uint8_t EEPROM_nextKeyframe(LectorSecuencia* lector, CuadroClave* cuadro) {
+	if (lector->restantes == 0) return 0;
+	lector->restantes--;
+	
+	uint16_t direccion = lector->direccion;
+	uint8_t encabezado = lector->comprimida ? readEEPROM(direccion++) : CUADRO_ABSOLUTO;
+	CuadroClave nuevo = lector->anterior;
+	uint8_t* pose = &nuevo.pose.base;
+	
+	if (encabezado & CUADRO_ABSOLUTO) {
+		for (uint8_t eje = 0; eje < 4; eje++) {
+			pose[eje] = readEEPROM(direccion++);
+		}
+		nuevo.transicion = readEEPROM(direccion++);
+		nuevo.espera = readEEPROM(direccion++);
+		} else {
+		if (encabezado & CUADRO_TIEMPOS) {
+			nuevo.transicion = readEEPROM(direccion++);
+			nuevo.espera = readEEPROM(direccion++);
+		}
+		
+		uint8_t dato = 0;
+		uint8_t mitad = 0;
+		for (uint8_t eje = 0; eje < 4; eje++) {
+			if (!(encabezado & (1 << eje))) continue;
+			
+			int8_t diferencia;
+			if (encabezado & CUADRO_NIBBLES) {
+				// Nibble con signo: bajo primero, luego alto
+				if (mitad == 0) dato = readEEPROM(direccion++);
+				uint8_t nibble = mitad ? (dato >> 4) : (dato & 0x0F);
+				diferencia = (nibble & 0x08) ? (int8_t)(nibble | 0xF0) : (int8_t)nibble;
+				mitad ^= 1;
+				} else {
+				diferencia = (int8_t)readEEPROM(direccion++);
+			}
+			pose[eje] += diferencia;
+		}
+	}
+	
+	lector->direccion = direccion;
+	lector->anterior = nuevo;
+	*cuadro = nuevo;
+	return 1;
+}
+
+uint16_t EEPROM_freeBytes(void) {
+	// Lo de las secuencias borradas vuelve a estar disponible al compactar
+	return FIN_SECUENCIAS - finSecuencias + bytesRecuperables;
+}
+
+uint8_t EEPROM_sequenceErrors(void) {
+	return erroresSecuencia;
+}
+
+uint8_t EEPROM_loadCalibration(uint8_t* datos, uint8_t n) {
+	if (n > DATOS_CALIBRACION) return 0;
+	if (readEEPROM(DIRECCION_CALIBRACION) != CALIBRACION_VALIDA) return 0;
+	
+	uint8_t crc = 0;
+	for (uint8_t i = 0; i < n; i++) {
+		datos[i] = readEEPROM(DIRECCION_CALIBRACION + 1 + i);
+		crc = crc8(crc, datos[i]);
+	}
+	
+	return crc == readEEPROM(DIRECCION_CALIBRACION + BYTES_CALIBRACION - 1);
+}
+
+uint8_t EEPROM_saveCalibration(const uint8_t* datos, uint8_t n) {
+	if (n > DATOS_CALIBRACION) return 0;
+	if (estadoImagen == IMAGEN_INVALIDA) return 0;
+	
+	// Sin firma mientras cambian los datos: un corte deja el bloque invlido
+	uint8_t crc = 0;
+	writeEEPROMB(DIRECCION_CALIBRACION, 0xFF);
+	for (uint8_t i = 0; i < n; i++) {
+		writeEEPROMB(DIRECCION_CALIBRACION + 1 + i, datos[i]);
+		crc = crc8(crc, datos[i]);
+	}
+	writeEEPROMB(DIRECCION_CALIBRACION + BYTES_CALIBRACION - 1, crc);
+	writeEEPROMB(DIRECCION_CALIBRACION, CALIBRACION_VALIDA);
+	return 1;
+}
+
+// INTERRUPCIONES
+ISR(EE_READY_vect) {
+	// La EEPROM termin la escritura anterior: escribir el siguiente byte
+	BENCH_BEGIN(BENCH_ISR_EEPROM);
+	atenderCola();
+	BENCH_END(BENCH_ISR_EEPROM);
+}
@@ -10,15 +10,60 @@
 * EEPROM. Proporciona estructuras de datos, constantes de configuracin
 * y declaraciones de funciones para almacenamiento persistente de
 * posiciones de garra robtica y gestin de memoria no voltil.
-
+*
+* Las escrituras se encolan y se completan en segundo plano con la
+* interrupcin EE_READY; EEPROM_flush espera a que terminen.
+*
+* Imagen de la EEPROM (versin FORMATO_VERSION):
+*   - 0-7: Cabecera: 'G','A','R','R', versin, registros por banco, CRC-8
+*   - 8-391: Registro de posiciones (dos bancos)
+*   - 392-989: Secuencias con nombre, una tras otra
+*   - 990-1023: Calibracin de los servos (ver abajo)
+*
+* Las posiciones se guardan como un registro (log) de escritura
+* secuencial repartido en dos bancos para distribuir el desgaste de la
+* EEPROM. Cada registro ocupa BYTES_POR_REGISTRO bytes:
+*   - Bytes 0-1: Nmero de secuencia (16 bits, little-endian)
+*   - Byte 2: (cuenta de posiciones << 4) | ranura; 0xFF = registro vaco
+*   - Byte 3: CRC-8 del resto del registro
+*   - Bytes 4-7: base, brazo1, brazo2, pinza
+*
+* Cada secuencia comprimida (SECUENCIA_DELTA) ocupa:
+*   - Byte 0: Estado (SECUENCIA_DELTA, SECUENCIA_BORRADA_DELTA o SECUENCIA_FIN)
+*   - Byte 1: Nmero de cuadros clave
+*   - Bytes 2-9: Nombre (rellenado con 0)
+*   - Bytes 10-11: Longitud de los datos codificados (little-endian)
+*   - Datos: cuadros codificados (ver abajo)
+*   - ltimo byte: CRC-8 del nombre, los datos, la longitud y el nmero de cuadros
+*
+* Codificacin de cada cuadro (primer byte = encabezado del cuadro):
+*   - CUADRO_ABSOLUTO: siguen base, brazo1, brazo2, pinza, transicin y
+*     espera. Se usa en el primer cuadro, cada INTERVALO_ABSOLUTO cuadros
+*     (puntos de bsqueda) y cuando un cambio no cabe en 8 bits.
+*   - Delta: bits 0-3 = ejes que cambian; CUADRO_TIEMPOS = siguen la
+*     transicin y la espera nuevas; CUADRO_NIBBLES = los cambios caben en
+*     -8..7 y van de dos en dos por byte (nibble bajo primero), si no, un
+*     byte con signo por eje. Un cuadro idntico al anterior ocupa 1 byte.
+*
+* Las secuencias de la versin 2 (SECUENCIA_VALIDA, cuadros de 6 bytes sin
+* longitud) se siguen leyendo sin cambios.
+*
+* Bloque de calibracin (lo interpreta LBRY19/CALIBRATION):
+*   - Byte 0: CALIBRACION_VALIDA (se escribe al final)
+*   - Bytes 1-32: Datos de los 4 canales
+*   - Byte 33: CRC-8 de los datos
+*
+* Las versiones 2 y 3 no tenan el bloque: sus secuencias podan llegar
+* hasta el final de la EEPROM. Al migrar a la versin 4, si la cadena
+* invade el bloque, las secuencias vigentes se compactan hacia abajo, las
+* que aun as no caben se descartan (cuentan en EEPROM_sequenceErrors) y
+* la firma del bloque se borra, porque esos bytes eran datos de secuencia.
 ************************************************************************/
 
 #ifndef EEPROM_H
 #define EEPROM_H
 
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include <util/delay.h>
+#include "../LBRY11/HAL.h"
 
 // Estructura para almacenar posiciones de servos
 typedef struct {
@@ -28,19 +73,116 @@ typedef struct {
 	uint8_t pinza;
 } PosicionGarra;
 
+// Cuadro clave de una secuencia: pose y tiempos (en unidades de UNIDAD_TIEMPO_MS)
+typedef struct {
+	PosicionGarra pose;
+	uint8_t transicion;     // Tiempo para llegar a la pose
+	uint8_t espera;         // Tiempo detenido en la pose antes del siguiente cuadro
+} CuadroClave;
+
+// Decodificador por flujo: entrega un cuadro a la vez sin cargar la secuencia a RAM
+typedef struct {
+	uint16_t direccion;     // Siguiente byte codificado
+	uint8_t restantes;      // Cuadros por leer
+	uint8_t comprimida;     // 0: cuadros de 6 bytes (versin 2)
+	CuadroClave anterior;   // ltimo cuadro entregado (base de las diferencias)
+} LectorSecuencia;
+
 
 #define MAX_POSICIONES_GUARDADAS 10
 #define BYTES_POR_POSICION 4
-#define DIRECCION_BASE_EEPROM 0
+
+#define EEPROM_TAMANO 1024
+#define FORMATO_VERSION 4                                   // 4: bloque de calibracin al final
+
+// Formatos anteriores, solo se usan para migrar los datos
+#define DIRECCION_BASE_EEPROM 0                                     // Versin 0: tabla fija
 #define DIRECCION_NUM_POSICIONES (MAX_POSICIONES_GUARDADAS * BYTES_POR_POSICION)
+#define V1_DIRECCION_REGISTROS 4                                    // Versin 1: firma "PLOG" + registro
+#define V1_REGISTROS_POR_BANCO 63
+#define V3_FIN_SECUENCIAS EEPROM_TAMANO                     // Versiones 2 y 3: secuencias hasta el final
+
+// Cabecera de la imagen
+#define DIRECCION_CABECERA 0
+#define BYTES_CABECERA 8
+
+// Registro de posiciones con nivelacin de desgaste
+#define DIRECCION_REGISTROS (DIRECCION_CABECERA + BYTES_CABECERA)
+#define BYTES_POR_REGISTRO 8
+#define REGISTROS_POR_BANCO 24            // 2 bancos x 24 x 8 bytes = 384 bytes
+#define RANURA_CUENTA 0x0E                // Registro que solo cambia la cuenta (borrar)
+#define REGISTRO_VACIO 0xFF
+
+// Secuencias con nombre
+#define DIRECCION_SECUENCIAS (DIRECCION_REGISTROS + 2 * REGISTROS_POR_BANCO * BYTES_POR_REGISTRO)
+#define MAX_SECUENCIAS 8
+#define LONGITUD_NOMBRE 8
+#define BYTES_CABECERA_SECUENCIA (2 + LONGITUD_NOMBRE)   // Versin 2 (sin longitud)
+#define BYTES_CABECERA_DELTA (BYTES_CABECERA_SECUENCIA + 2)
+#define BYTES_POR_CUADRO 6                                  // Cuadro sin comprimir
+#define SECUENCIA_VALIDA 0xA5             // Cuadros de 6 bytes (versin 2)
+#define SECUENCIA_BORRADA 0x00
+#define SECUENCIA_DELTA 0xA6              // Cuadros codificados por diferencias
+#define SECUENCIA_BORRADA_DELTA 0x01
+#define SECUENCIA_FIN 0xFF
+#define FIN_SECUENCIAS DIRECCION_CALIBRACION                // Primer byte fuera del rea de secuencias
+#define RESERVA_SECUENCIA (BYTES_CABECERA_DELTA + 1 + MAX_POSICIONES_GUARDADAS * (1 + BYTES_POR_CUADRO)) // Secuencia de ranuras ms larga
+
+// Codificacin de cuadros
+#define CUADRO_ABSOLUTO 0x80
+#define CUADRO_NIBBLES 0x40
+#define CUADRO_TIEMPOS 0x10
+#define CUADRO_EJES 0x0F
+#define INTERVALO_ABSOLUTO 8
+#define SIN_SECUENCIA 0xFF
+#define UNIDAD_TIEMPO_MS 20               // Unidad de transicin y espera (una trama de servo)
+
+// Calibracin de los servos (al final de la imagen)
+#define BYTES_CALIBRACION 34
+#define DATOS_CALIBRACION (BYTES_CALIBRACION - 2)           // Sin la firma ni el CRC
+#define DIRECCION_CALIBRACION (EEPROM_TAMANO - BYTES_CALIBRACION)
+#define CALIBRACION_VALIDA 0xCA
+
+// Estado de la imagen al arrancar
+#define IMAGEN_VALIDA 0
+#define IMAGEN_FORMATEADA 1               // EEPROM nueva o formato anterior migrado
+#define IMAGEN_INVALIDA 2                 // Cabecera daada o desconocida: solo lectura
+
+#define EEPROM_COLA_ESCRITURA 32          // Bytes en espera de escritura (cuatro registros)
+
+typedef void (*EepromCallback)(void);
 
 void initEEPROM(void);                                          // Initialize EEPROM
 void writeEEPROMB(uint16_t address, uint8_t dato);          // Write byte to EEPROM
 uint8_t readEEPROM(uint16_t address);                      // Read byte from EEPROM
-void savePosition(uint8_t positionNum, PosicionGarra posicion); // Save gripper position
+uint8_t savePosition(uint8_t positionNum, PosicionGarra posicion); // Save gripper position (0 if read-only)
 PosicionGarra loadPosition(uint8_t positionNum);               // Load gripper position
 uint8_t Saved_Pos_Count(void);                          // Get number of saved positions
 void increment_Saved_Count(void);                       // Increment saved positions counter
 void clearAllPositions(void);                                  // Clear all saved positions
+void compactPositions(void);                                   // Move live records to the other bank
+uint8_t EEPROM_pending(void);                                  // Bytes waiting in the write queue
+uint8_t EEPROM_isBusy(void);                                   // 1 while writes are pending
+void EEPROM_flush(void);                                       // Wait until all queued writes finish
+void EEPROM_setWriteCallback(EepromCallback funcion);          // Called (from ISR) when the queue drains
+uint8_t EEPROM_beginSequence(const char* nombre);              // Start writing a named sequence
+uint8_t EEPROM_addKeyframe(const CuadroClave* cuadro);         // Append a keyframe to the sequence being written
+uint8_t EEPROM_endSequence(void);                              // Commit the sequence, returns its index
+void EEPROM_deleteSequence(uint8_t indice);                    // Mark a sequence as deleted
+void EEPROM_clearSequences(void);                              // Delete all sequences and free their space
+void EEPROM_compactSequences(void);                            // Reclaim the space of deleted sequences
+uint8_t EEPROM_sequenceCount(void);                            // Number of valid sequences
+uint8_t EEPROM_findSequence(const char* nombre);               // Index of a sequence by name
+void EEPROM_getSequenceName(uint8_t indice, char* nombre);     // Copy name (LONGITUD_NOMBRE + 1 bytes)
+uint8_t EEPROM_sequenceLength(uint8_t indice);                 // Number of keyframes of a sequence
+uint8_t EEPROM_readKeyframe(uint8_t indice, uint8_t numero, CuadroClave* cuadro); // Read one keyframe
+uint8_t EEPROM_openSequence(uint8_t indice, uint8_t numero, LectorSecuencia* lector); // Start decoding at keyframe numero
+uint8_t EEPROM_nextKeyframe(LectorSecuencia* lector, CuadroClave* cuadro); // Decode the next keyframe
+uint16_t EEPROM_freeBytes(void);                               // Free bytes in the sequence area
+uint8_t EEPROM_sequenceErrors(void);                           // Sequences rejected by the CRC at boot
+uint8_t EEPROM_imageStatus(void);                              // IMAGEN_VALIDA, IMAGEN_FORMATEADA or IMAGEN_INVALIDA
+void EEPROM_format(void);                                      // Erase positions and sequences and write a new header
+uint8_t EEPROM_loadCalibration(uint8_t* datos, uint8_t n);     // Read calibration block, returns 0 if missing or corrupt
+uint8_t EEPROM_saveCalibration(const uint8_t* datos, uint8_t n); // Write calibration block (n <= DATOS_CALIBRACION, 0 if read-only)
 
 #endif /* EEPROM_H */
\ No newline at end of file
@@ -9,6 +9,16 @@
 * Esta librera implementa el control de servomotores mediante seales PWM
 * generadas con el Timer1 del microcontrolador AVR. Utiliza modo Fast PWM
 * con ICR1 para mayor precisin y control de dos servomotores independientes.
+* La conversin ngulo -> valor de comparacin usa una tabla en memoria de
+* programa generada en tiempo de compilacin (sin multiplicacin ni divisin
+* de 32 bits en cada actualizacin).
+*
+* Registros sombra: los valores de comparacin nuevos se guardan en RAM
+* y TIMER1_OVF los copia al final de su rutina, despus de la funcin de
+* trama, as los valores que calcule el motor de movimiento en esa trama
+* salen juntos en la siguiente. Copiar un registro de 16 bits en la
+* interrupcin tambin evita que el programa principal lo escriba a
+* medias (TEMP compartido) si lo interrumpe otra rutina.
 
 * Conexiones de Hardware:
 *   - PWM Timer1 Canal A: PB1 (OC1A) - Servo Brazo2
@@ -16,6 +26,23 @@
 ************************************************************************/
 
 #include "TIMER1_PWM.h"
+#include "../LBRY9/LUT.h"
+#include "../LBRY12/BENCH.h"
+
+// Tabla ngulo (0-180) -> valor de OCR1x: 0 = 1ms = 2000, 180 = 2ms = 4000
+#define PWM1_ANGULO(a) (uint16_t)(2000 + (uint32_t)(a) * 2000 / 180)
+static const uint16_t tablaPWM1[181] PROGMEM = { LUT_181(PWM1_ANGULO) };
+
+// Funcin llamada al inicio de cada trama (desborde en TOP = ICR1)
+static volatile Timer1Callback funcionTrama = 0;
+
+#define PENDIENTE_1A 0x01
+#define PENDIENTE_1B 0x02
+
+static volatile uint16_t sombra1A = 3000;
+static volatile uint16_t sombra1B = 3000;
+static volatile uint8_t pendientes1 = 0;
+static volatile uint16_t tramas1 = 0;
 
 void Timer1_init(void) {
 	// Configurar pines como salida
@@ -35,14 +62,34 @@ void Timer1_init(void) {
 	// Valores iniciales para Timer1
 	OCR1A = 3000;
 	OCR1B = 3000;
+	sombra1A = 3000;
+	sombra1B = 3000;
+	pendientes1 = 0;
+	tramas1 = 0;
+	
+	// Desborde: copiar los registros sombra una vez por trama
+	TIFR1 = (1 << TOV1);
+	TIMSK1 |= (1 << TOIE1);
 }
 
 void setPWM1A(uint16_t pwmValue) {
-	OCR1A = pwmValue;
+	uint8_t sreg = SREG;
+	cli();
+	if (pwmValue != sombra1A) {
+		sombra1A = pwmValue;
+		pendientes1 |= PENDIENTE_1A;
+	}
+	SREG = sreg;
 }
 
 void setPWM1B(uint16_t pwmValue) {
-	OCR1B = pwmValue;
+	uint8_t sreg = SREG;
+	cli();
+	if (pwmValue != sombra1B) {
+		sombra1B = pwmValue;
+		pendientes1 |= PENDIENTE_1B;
+	}
+	SREG = sreg;
 }
 
 uint16_t calculate_PWM1(uint8_t angle) {
@@ -50,8 +97,7 @@ uint16_t calculate_PWM1(uint8_t angle) {
 	// 0 = 1ms = 2000, 180 = 2ms = 4000
 	if (angle > 180) angle = 180;
 	
-	uint16_t pwmValue = 2000 + (uint32_t)angle * 2000 / 180;
-	return pwmValue;
+	return pgm_read_word(&tablaPWM1[angle]);
 }
 
 uint16_t calculate_PWM1_inverted(uint8_t angle) {
@@ -59,6 +105,35 @@ uint16_t calculate_PWM1_inverted(uint8_t angle) {
 	// 0 = 2ms = 4000, 180 = 1ms = 2000
 	if (angle > 180) angle = 180;
 	
-	uint16_t pwmValue = 4000 - (uint32_t)angle * 2000 / 180;
-	return pwmValue;
-}
\ No newline at end of file
+	// 4000 - (tabla - 2000): la tabla no invertida reflejada sobre el rango 2000-4000
+	return 6000 - pgm_read_word(&tablaPWM1[angle]);
+}
+
+void Timer1_setFrameCallback(Timer1Callback funcion) {
+	// La interrupcin de desborde queda siempre activa por los registros sombra
+	funcionTrama = funcion;
+}
+
+uint16_t Timer1_frameCount(void) {
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t tramas = tramas1;
+	SREG = sreg;
+	
+	return tramas;
+}
+
+// INTERRUPCIONES
+ISR(TIMER1_OVF_vect) {
+	BENCH_BEGIN(BENCH_ISR_TRAMA);
+	if (funcionTrama) {
+		funcionTrama();
+	}
+	
+	// Los valores de esta trama salen juntos en la siguiente
+	if (pendientes1 & PENDIENTE_1A) OCR1A = sombra1A;
+	if (pendientes1 & PENDIENTE_1B) OCR1B = sombra1B;
+	pendientes1 = 0;
+	tramas1++;
+	BENCH_END(BENCH_ISR_TRAMA);
+}
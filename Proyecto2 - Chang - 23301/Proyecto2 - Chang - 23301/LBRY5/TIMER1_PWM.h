@@ -10,6 +10,11 @@
 * mediante PWM generado por Timer1. Proporciona declaraciones de funciones
 * para el manejo de dos canales independientes con mayor precisin que
 * Timer0, ideal para servos que requieren control angular fino.
+* Tambin permite registrar una funcin que se ejecuta al inicio de cada
+* trama de 20 ms (desborde del Timer1) para sincronizar el movimiento.
+* setPWM1A/setPWM1B escriben registros sombra que el desborde copia a
+* OCR1A/OCR1B despus de la funcin de trama, los dos en la misma trama
+* y solo si cambiaron. Timer1_frameCount cuenta las tramas de salida.
 *
 * Conexiones de Hardware: 
 *   - PWM Timer1 Canal A: PB1 (OC1A) - Control Servo Brazo2
@@ -17,14 +22,17 @@
 ************************************************************************/
 #ifndef TIMER1_PWM_H
 #define TIMER1_PWM_H
-#include <avr/io.h>
+#include "../LBRY11/HAL.h"
 #include <stdint.h>
 
+typedef void (*Timer1Callback)(void);
 
 void Timer1_init(void);                                       // Initialize Timer1 PWM
 void setPWM1A(uint16_t pwmValue);                              // Set PWM value on OC1A
 void setPWM1B(uint16_t pwmValue);                              // Set PWM value on OC1B
 uint16_t calculate_PWM1(uint8_t angle);                   // Calculate PWM value for servo on Timer1
 uint16_t calculate_PWM1_inverted(uint8_t angle);           // Calculate inverted PWM value for servo on Timer1
+void Timer1_setFrameCallback(Timer1Callback funcion);        // Call funcion at every 20 ms frame (50 Hz)
+uint16_t Timer1_frameCount(void);                            // 20 ms frames output since init (wraps)
 
 #endif // TIMER1_PWM_H
\ No newline at end of file
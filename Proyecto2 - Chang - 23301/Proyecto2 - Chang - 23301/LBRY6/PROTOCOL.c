@@ -0,0 +1,177 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa un protocolo binario de tramas para controlar
+* la garra robtica por USART con menos bytes que los comandos ASCII.
+* La recepcin es una mquina de estados alimentada byte a byte desde la
+* interrupcin de recepcin; cuando una trama completa llega, queda
+* disponible para que el lazo principal la procese. Cada trama se
+* protege con un CRC-8.
+*
+* Ejemplo (mover servos a 90,45,120,30):
+*   Peticin:  A5 01 04 5A 2D 78 1E CRC   (8 bytes)
+*   Respuesta: A5 81 01 00 CRC            (5 bytes)
+************************************************************************/
+
+#include "PROTOCOL.h"
+#include "../LBRY3/USART.h"
+#include "../LBRY7/SCHEDULER.h"
+
+// Estados de la mquina de recepcin
+#define RX_ESPERA_SYNC 0
+#define RX_OPCODE 1
+#define RX_LONGITUD 2
+#define RX_DATOS 3
+#define RX_CRC 4
+
+static TramaBinaria trama;
+static volatile uint8_t estadoRx = RX_ESPERA_SYNC;
+static volatile uint8_t opcodeRx = 0;
+static volatile uint8_t longitudRx = 0;
+static volatile uint8_t indiceDatos = 0;
+static volatile uint8_t crcRx = 0;
+static volatile uint8_t descartarRx = 0;    // Trama en curso que no cabe (la anterior no se ha procesado)
+static volatile uint8_t tramaLista = 0;
+static uint16_t ultimoByteRx = 0;           // Tick del planificador del ltimo byte recibido
+
+uint8_t PROTO_crc8(uint8_t crc, uint8_t dato) {
+	// CRC-8 con polinomio x^8 + x^2 + x + 1 (0x07)
+	crc ^= dato;
+	for (uint8_t i = 0; i < 8; i++) {
+		if (crc & 0x80) {
+			crc = (crc << 1) ^ 0x07;
+			} else {
+			crc <<= 1;
+		}
+	}
+	return crc;
+}
+
+uint8_t PROTO_rxByte(uint8_t dato) {
+	// Una pausa a mitad de trama indica bytes perdidos: descartar la trama
+	// incompleta para que este byte se interprete desde la sincrona
+	uint16_t ahora = SCHED_ticks();
+	if (estadoRx != RX_ESPERA_SYNC && (uint16_t)(ahora - ultimoByteRx) > PROTO_TIMEOUT_MS) {
+		estadoRx = RX_ESPERA_SYNC;
+	}
+	ultimoByteRx = ahora;
+	
+	switch (estadoRx) {
+		case RX_ESPERA_SYNC:
+		// Fuera de una trama solo interesa el byte de sincrona,
+		// todo lo dems pertenece a los comandos ASCII
+		if (dato != PROTO_SYNC) {
+			return 0;
+		}
+		// Si la trama anterior no se ha procesado, la nueva se recibe pero se descarta
+		descartarRx = tramaLista;
+		crcRx = 0;
+		estadoRx = RX_OPCODE;
+		break;
+		
+		case RX_OPCODE:
+		opcodeRx = dato;
+		crcRx = PROTO_crc8(crcRx, dato);
+		estadoRx = RX_LONGITUD;
+		break;
+		
+		case RX_LONGITUD:
+		if (dato > PROTO_MAX_PAYLOAD) {
+			// Longitud imposible: volver a buscar sincrona
+			estadoRx = RX_ESPERA_SYNC;
+			break;
+		}
+		longitudRx = dato;
+		crcRx = PROTO_crc8(crcRx, dato);
+		indiceDatos = 0;
+		estadoRx = (dato > 0) ? RX_DATOS : RX_CRC;
+		break;
+		
+		case RX_DATOS:
+		if (!descartarRx) {
+			trama.datos[indiceDatos] = dato;
+		}
+		indiceDatos++;
+		crcRx = PROTO_crc8(crcRx, dato);
+		if (indiceDatos >= longitudRx) {
+			estadoRx = RX_CRC;
+		}
+		break;
+		
+		case RX_CRC:
+		if (!descartarRx) {
+			// La trama queda disponible aunque el CRC falle para poder responder con error
+			trama.opcode = opcodeRx;
+			trama.longitud = longitudRx;
+			trama.estado = (dato == crcRx) ? PROTO_OK : PROTO_ERR_CRC;
+			tramaLista = 1;
+		}
+		estadoRx = RX_ESPERA_SYNC;
+		break;
+		
+		default:
+		estadoRx = RX_ESPERA_SYNC;
+		break;
+	}
+	
+	return 1;
+}
+
+uint8_t PROTO_frameAvailable(void) {
+	return tramaLista;
+}
+
+const TramaBinaria* PROTO_getFrame(void) {
+	return &trama;
+}
+
+void PROTO_releaseFrame(void) {
+	tramaLista = 0;
+}
+
+void PROTO_sendFrame(uint8_t opcode, const uint8_t* datos, uint8_t longitud) {
+	uint8_t crc = 0;
+	
+	sendUSARTData(PROTO_SYNC);
+	sendUSARTData(opcode);
+	crc = PROTO_crc8(crc, opcode);
+	sendUSARTData(longitud);
+	crc = PROTO_crc8(crc, longitud);
+	
+	for (uint8_t i = 0; i < longitud; i++) {
+		sendUSARTData(datos[i]);
+		crc = PROTO_crc8(crc, datos[i]);
+	}
+	
+	sendUSARTData(crc);
+}
+
+void PROTO_sendResponse(uint8_t opcode, uint8_t estado, const uint8_t* datos, uint8_t longitud) {
+	uint8_t crc = 0;
+	uint8_t opRespuesta = opcode | PROTO_RESPUESTA;
+	
+	// Igual que PROTO_sendFrame pero con el estado como primer byte de datos
+	sendUSARTData(PROTO_SYNC);
+	sendUSARTData(opRespuesta);
+	crc = PROTO_crc8(crc, opRespuesta);
+	sendUSARTData(longitud + 1);
+	crc = PROTO_crc8(crc, longitud + 1);
+	sendUSARTData(estado);
+	crc = PROTO_crc8(crc, estado);
+	
+	for (uint8_t i = 0; i < longitud; i++) {
+		sendUSARTData(datos[i]);
+		crc = PROTO_crc8(crc, datos[i]);
+	}
+	
+	sendUSARTData(crc);
+}
+
+void PROTO_sendAck(uint8_t opcode, uint8_t estado) {
+	PROTO_sendResponse(opcode, estado, 0, 0);
+}
@@ -0,0 +1,69 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica para el protocolo binario de
+* comandos. Proporciona el formato de trama, los cdigos de operacin,
+* los cdigos de estado de las respuestas y las funciones para recibir
+* y enviar tramas por USART junto a los comandos ASCII existentes.
+*
+* Formato de trama (peticin y respuesta):
+*   [SYNC 0xA5] [OPCODE] [LONGITUD] [DATOS 0..PROTO_MAX_PAYLOAD] [CRC-8]
+*   - El CRC-8 (polinomio 0x07, valor inicial 0x00) cubre OPCODE,
+*     LONGITUD y DATOS.
+*   - La respuesta usa OPCODE | 0x80 y su primer byte de datos es el
+*     cdigo de estado, seguido de los datos pedidos (si los hay).
+*   - Si entre dos bytes de una trama pasan ms de PROTO_TIMEOUT_MS, lo
+*     recibido se descarta y se vuelve a buscar el byte de sincrona.
+************************************************************************/
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+#define PROTO_SYNC 0xA5
+#define PROTO_MAX_PAYLOAD 48
+#define PROTO_RESPUESTA 0x80        // Bit que marca una trama de respuesta
+#define PROTO_TIMEOUT_MS 50         // Pausa mxima entre bytes de una trama
+
+// Cdigos de operacin
+#define PROTO_OP_SET_POSE 0x01      // Datos: base, brazo1, brazo2, pinza
+#define PROTO_OP_GOTO_POS 0x02      // Datos: n (cargar posicin guardada n)
+#define PROTO_OP_SAVE_BULK 0x03     // Datos: inicio, cantidad, cantidad x 4 bytes
+#define PROTO_OP_LOAD_BULK 0x04     // Datos: inicio, cantidad -> respuesta con cantidad x 4 bytes
+#define PROTO_OP_TELEMETRY 0x05     // Sin datos -> respuesta con estado actual
+#define PROTO_OP_STREAM 0x06        // Datos: periodo (ms, 16 bits), campos, formato. El robot
+                                    // enva cada muestra con este opcode (ver TELEMETRY.h)
+
+// Cdigos de estado de la respuesta
+#define PROTO_OK 0x00
+#define PROTO_ERR_CRC 0x01
+#define PROTO_ERR_OPCODE 0x02
+#define PROTO_ERR_LONGITUD 0x03
+#define PROTO_ERR_RANGO 0x04
+#define PROTO_ERR_MODO 0x05
+#define PROTO_ERR_SOLO_LECTURA 0x06  // EEPROM con imagen desconocida (ver EEPROM_imageStatus)
+
+// Trama recibida
+typedef struct {
+	uint8_t opcode;
+	uint8_t longitud;
+	uint8_t datos[PROTO_MAX_PAYLOAD];
+	uint8_t estado;                 // PROTO_OK o PROTO_ERR_CRC
+} TramaBinaria;
+
+uint8_t PROTO_rxByte(uint8_t dato);                     // Feed a received byte, returns 1 if consumed
+uint8_t PROTO_frameAvailable(void);                     // Check for a complete frame
+const TramaBinaria* PROTO_getFrame(void);               // Get the complete frame
+void PROTO_releaseFrame(void);                          // Release the frame buffer
+uint8_t PROTO_crc8(uint8_t crc, uint8_t dato);          // Update CRC-8 with one byte
+void PROTO_sendFrame(uint8_t opcode, const uint8_t* datos, uint8_t longitud); // Send a frame
+void PROTO_sendResponse(uint8_t opcode, uint8_t estado, const uint8_t* datos, uint8_t longitud); // Send a response
+void PROTO_sendAck(uint8_t opcode, uint8_t estado);     // Send a status-only response
+
+#endif // PROTOCOL_H
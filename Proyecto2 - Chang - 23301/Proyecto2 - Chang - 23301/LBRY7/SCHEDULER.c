@@ -0,0 +1,132 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa un planificador cooperativo sencillo basado en
+* una base de tiempo de 1 ms. El Timer2 (sin uso por los servos) genera
+* la interrupcin que incrementa el contador de milisegundos, y el lazo
+* principal llama a SCHED_run() para ejecutar cada tarea cuando se cumple
+* su tiempo. Las tareas no deben bloquear: hacen una parte del trabajo y
+* regresan, de modo que ninguna detiene a las dems.
+*
+* Una funcin de tick (SCHED_setTickCallback) se ejecuta dentro del ISR
+* cada 1 ms, para trabajo corto que necesita un periodo exacto aunque el
+* lazo principal est ocupado (por ejemplo el antirrebote de los botones).
+*
+* Clculo de la base de tiempo:
+*   16 MHz / 64 = 250 kHz -> 250 cuentas = 1 ms (OCR2A = 249)
+************************************************************************/
+
+#include "SCHEDULER.h"
+#include "../LBRY12/BENCH.h"
+
+typedef struct {
+	TareaFuncion funcion;
+	uint16_t periodo;      // 0 = tarea de una sola ejecucin
+	uint16_t siguiente;    // Tick en el que debe ejecutarse
+	uint8_t activa;
+} Tarea;
+
+static Tarea tareas[SCHED_MAX_TAREAS];
+static uint8_t numTareas = 0;
+static volatile uint16_t ticks = 0;
+static volatile SchedTickCallback funcionTick = 0;
+
+void SCHED_init(void) {
+	numTareas = 0;
+	ticks = 0;
+	
+	// Timer2 en modo CTC con prescaler 64 -> interrupcin cada 1 ms
+	TCCR2A = (1 << WGM21);
+	TCCR2B = (1 << CS22);
+	OCR2A = 249;
+	TCNT2 = 0;
+	TIMSK2 = (1 << OCIE2A);
+}
+
+uint16_t SCHED_ticks(void) {
+	// Lectura atmica del contador de 16 bits
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t valor = ticks;
+	SREG = sreg;
+	return valor;
+}
+
+uint8_t SCHED_addTask(TareaFuncion funcion, uint16_t periodo, uint16_t retardo) {
+	if (numTareas >= SCHED_MAX_TAREAS) {
+		return SCHED_SIN_TAREA;
+	}
+	
+	uint8_t id = numTareas++;
+	tareas[id].funcion = funcion;
+	tareas[id].periodo = periodo;
+	tareas[id].siguiente = SCHED_ticks() + retardo;
+	tareas[id].activa = 1;
+	
+	return id;
+}
+
+void SCHED_startOnce(uint8_t id, uint16_t retardo) {
+	if (id >= numTareas) return;
+	
+	tareas[id].siguiente = SCHED_ticks() + retardo;
+	tareas[id].activa = 1;
+}
+
+void SCHED_stopTask(uint8_t id) {
+	if (id >= numTareas) return;
+	
+	tareas[id].activa = 0;
+}
+
+void SCHED_setPeriod(uint8_t id, uint16_t periodo) {
+	if (id >= numTareas) return;
+	
+	// La primera ejecucin con el nuevo periodo es un periodo despus
+	tareas[id].periodo = periodo;
+	tareas[id].siguiente = SCHED_ticks() + periodo;
+	tareas[id].activa = (periodo > 0);
+}
+
+void SCHED_run(void) {
+	for (uint8_t id = 0; id < numTareas; id++) {
+		Tarea* tarea = &tareas[id];
+		
+		if (!tarea->activa) continue;
+		
+		// Comparacin con signo para soportar el desborde del contador
+		uint16_t ahora = SCHED_ticks();
+		if ((int16_t)(ahora - tarea->siguiente) < 0) continue;
+		
+		if (tarea->periodo > 0) {
+			// Mantener la cadencia; si la tarea se atras ms de un periodo, no acumular ejecuciones
+			tarea->siguiente += tarea->periodo;
+			if ((int16_t)(ahora - tarea->siguiente) >= 0) {
+				tarea->siguiente = ahora + tarea->periodo;
+			}
+			} else {
+			tarea->activa = 0;
+		}
+		
+		tarea->funcion();
+	}
+}
+
+void SCHED_setTickCallback(SchedTickCallback funcion) {
+	funcionTick = funcion;
+}
+
+// INTERRUPCIONES
+ISR(TIMER2_COMPA_vect) {
+	BENCH_BEGIN(BENCH_ISR_TICK);
+	ticks++;
+	if (funcionTick) {
+		funcionTick();
+	}
+	BENCH_END(BENCH_ISR_TICK);
+}
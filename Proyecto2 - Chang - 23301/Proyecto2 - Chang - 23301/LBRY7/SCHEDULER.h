@@ -0,0 +1,38 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica para el planificador cooperativo
+* de tareas. Proporciona la base de tiempo de 1 ms generada con Timer2 y
+* las funciones para registrar tareas peridicas o de una sola ejecucin
+* que el lazo principal ejecuta cuando les corresponde.
+*
+* Recursos de Hardware:
+*   - Timer2 en modo CTC, interrupcin de comparacin A cada 1 ms
+************************************************************************/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+#define SCHED_MAX_TAREAS 8       // Nmero mximo de tareas registradas
+#define SCHED_SIN_TAREA 0xFF     // Identificador devuelto cuando no hay espacio
+
+typedef void (*TareaFuncion)(void);
+typedef void (*SchedTickCallback)(void);
+
+void SCHED_init(void);                                              // Initialize Timer2 tick and task table
+uint16_t SCHED_ticks(void);                                         // Milliseconds since start (wraps at 65536)
+uint8_t SCHED_addTask(TareaFuncion funcion, uint16_t periodo, uint16_t retardo); // Add task (periodo 0 = one-shot)
+void SCHED_startOnce(uint8_t id, uint16_t retardo);                 // Re-arm a task to run once after retardo ms
+void SCHED_stopTask(uint8_t id);                                    // Stop a task
+void SCHED_setPeriod(uint8_t id, uint16_t periodo);                 // Change period and restart (0 stops the task)
+void SCHED_run(void);                                               // Run every task that is due
+void SCHED_setTickCallback(SchedTickCallback funcion);              // Call funcion from the 1 ms tick ISR
+
+#endif // SCHEDULER_H
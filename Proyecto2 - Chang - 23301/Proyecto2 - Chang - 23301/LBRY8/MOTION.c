@@ -0,0 +1,322 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Esta librera implementa un motor de movimiento punto a punto para los
+* servomotores. En lugar de saltar directamente al ngulo pedido, cada eje
+* acelera hasta su velocidad mxima, avanza y desacelera para detenerse en
+* el objetivo (perfil de velocidad trapezoidal). El clculo se ejecuta una
+* vez por trama de 20 ms desde la interrupcin de desborde del Timer1.
+*
+* Aritmtica de punto fijo:
+*   - Posiciones en grados Q8.8 (1/256 de grado): 180 = 46080
+*   - Velocidad en grados Q8.8 por trama, aceleracin en grados Q8.8 por
+*     trama^2. La conversin desde grados/s se hace solo al configurar.
+*   - La decisin de frenar compara v*(v+a) con 2*a*d (sin divisiones):
+*     si la distancia restante d es menor o igual a la distancia de
+*     frenado, el eje desacelera.
+*
+* Movimiento coordinado:
+*   Un solo perfil trapezoidal de N tramas, en unidades de avance: la
+*   velocidad sube 1, 2, ... R unidades por trama, se mantiene en R y
+*   baja R, ... 1, para un total de U = R * (N - R + 1) unidades. Cada
+*   eje recorre su distancia d escalada por ese perfil: despus de
+*   recorrer u unidades est en inicio + d * u / U. As su velocidad
+*   mxima es d / (N - R + 1) y su aceleracin d / U por trama.
+*
+*   N y R se eligen al empezar (fuera del ISR) para que ningn eje pase
+*   de su velocidad ni de su aceleracin; una duracin pedida solo puede
+*   alargar el movimiento. La divisin d / U tambin se hace una vez, como
+*   un factor Q16, y en cada trama el ISR solo suma la velocidad del perfil
+*   y hace una multiplicacin por eje. En la trama N cada eje queda
+*   exactamente en su objetivo.
+************************************************************************/
+
+#include "MOTION.h"
+#include "../LBRY5/TIMER1_PWM.h"
+
+typedef struct {
+	uint16_t posicion;      // Posicin actual (Q8.8 grados)
+	uint16_t objetivo;      // Posicin objetivo (Q8.8 grados)
+	int16_t velocidad;      // Velocidad actual con signo (Q8.8 grados/trama)
+	int16_t velMax;         // Velocidad mxima (Q8.8 grados/trama)
+	int16_t aceleracion;    // Aceleracin (Q8.8 grados/trama^2)
+	uint8_t anguloSalida;   // ltimo ngulo escrito en la salida
+	uint16_t tramasCoord;   // Tramas restantes del movimiento coordinado (0 = perfil trapezoidal)
+	uint16_t inicioCoord;   // Posicin al empezar el movimiento coordinado (Q8.8)
+	uint32_t factorCoord;   // d / U en Q16 (avance por unidad del perfil)
+	uint32_t unidadesCoord; // Unidades del perfil recorridas
+	int8_t direccionCoord;
+} EjeMovimiento;
+
+static volatile EjeMovimiento ejes[MOTION_NUM_EJES];
+static SalidaServo funcionSalida = 0;
+
+// Perfil compartido del movimiento coordinado
+static volatile uint16_t tramasTotalCoord = 0;             // N
+static volatile uint16_t rampaCoord = 0;                   // R
+
+// Escribir la salida solo cuando cambia el ngulo entero (redondeado)
+static void escribirSalida(uint8_t eje, volatile EjeMovimiento* m) {
+	uint8_t angulo = (uint8_t)((m->posicion + 128) >> 8);
+	if (angulo != m->anguloSalida) {
+		m->anguloSalida = angulo;
+		if (funcionSalida) {
+			funcionSalida(eje, angulo);
+		}
+	}
+}
+
+void MOTION_init(SalidaServo salida) {
+	funcionSalida = salida;
+	
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		ejes[eje].posicion = 0;
+		ejes[eje].objetivo = 0;
+		ejes[eje].velocidad = 0;
+		ejes[eje].anguloSalida = 0;
+		ejes[eje].tramasCoord = 0;
+	}
+	MOTION_setLimits(MOTION_TODOS, MOTION_VEL_DEFECTO, MOTION_ACEL_DEFECTO);
+	
+	// Avanzar los ejes al inicio de cada trama de 20 ms
+	Timer1_setFrameCallback(MOTION_update);
+}
+
+void MOTION_setLimits(uint8_t eje, uint16_t velocidad, uint16_t aceleracion) {
+	if (velocidad > MOTION_VEL_MAX) velocidad = MOTION_VEL_MAX;
+	if (aceleracion > MOTION_ACEL_MAX) aceleracion = MOTION_ACEL_MAX;
+	
+	// Convertir grados/s y grados/s^2 a Q8.8 por trama (una sola vez)
+	int16_t velTrama = (int16_t)(((uint32_t)velocidad * 256) / MOTION_FRECUENCIA);
+	int16_t acelTrama = (int16_t)(((uint32_t)aceleracion * 256) / ((uint16_t)MOTION_FRECUENCIA * MOTION_FRECUENCIA));
+	if (velTrama < 1) velTrama = 1;
+	if (acelTrama < 1) acelTrama = 1;
+	
+	for (uint8_t i = 0; i < MOTION_NUM_EJES; i++) {
+		if (eje == MOTION_TODOS || eje == i) {
+			uint8_t sreg = SREG;
+			cli();
+			ejes[i].velMax = velTrama;
+			ejes[i].aceleracion = acelTrama;
+			SREG = sreg;
+		}
+	}
+}
+
+void MOTION_setTarget(uint8_t eje, uint8_t angulo) {
+	if (eje >= MOTION_NUM_EJES) return;
+	if (angulo > 180) angulo = 180;
+	
+	uint8_t sreg = SREG;
+	cli();
+	ejes[eje].objetivo = (uint16_t)angulo << 8;
+	ejes[eje].tramasCoord = 0;  // Sigue con el perfil desde la velocidad actual
+	SREG = sreg;
+}
+
+void MOTION_jumpTo(uint8_t eje, uint8_t angulo) {
+	if (eje >= MOTION_NUM_EJES) return;
+	if (angulo > 180) angulo = 180;
+	
+	uint8_t sreg = SREG;
+	cli();
+	ejes[eje].posicion = (uint16_t)angulo << 8;
+	ejes[eje].objetivo = (uint16_t)angulo << 8;
+	ejes[eje].velocidad = 0;
+	ejes[eje].anguloSalida = angulo;
+	ejes[eje].tramasCoord = 0;
+	SREG = sreg;
+	
+	if (funcionSalida) {
+		funcionSalida(eje, angulo);
+	}
+}
+
+uint16_t MOTION_moveCoordinated(const uint8_t* angulos, uint16_t duracion) {
+	uint16_t posiciones[MOTION_NUM_EJES];
+	uint16_t objetivos[MOTION_NUM_EJES];
+	uint16_t distancias[MOTION_NUM_EJES];
+	
+	// Fotografa de las posiciones actuales
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		posiciones[eje] = ejes[eje].posicion;
+	}
+	SREG = sreg;
+	
+	// Lmites del perfil compartido, segn el eje ms exigido:
+	//   velocidad:   N - R + 1 >= d / velMax
+	//   aceleracin: R * (N - R + 1) >= d / aceleracion
+	uint16_t largo = 1;                 // N - R + 1
+	uint16_t area = 1;                  // R * (N - R + 1)
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		uint8_t angulo = (angulos[eje] > 180) ? 180 : angulos[eje];
+		objetivos[eje] = (uint16_t)angulo << 8;
+		distancias[eje] = (objetivos[eje] >= posiciones[eje]) ?
+		(objetivos[eje] - posiciones[eje]) : (posiciones[eje] - objetivos[eje]);
+		
+		uint16_t porVelocidad = (distancias[eje] + ejes[eje].velMax - 1) / ejes[eje].velMax;
+		uint16_t porAceleracion = (distancias[eje] + ejes[eje].aceleracion - 1) / ejes[eje].aceleracion;
+		if (porVelocidad > largo) largo = porVelocidad;
+		if (porAceleracion > area) area = porAceleracion;
+	}
+	
+	// Rampa ms corta que cumple ambos lmites; si no alcanza la velocidad
+	// mxima, el perfil es un tringulo (sin tramo constante)
+	uint16_t rampa = (area + largo - 1) / largo;
+	if (rampa >= largo) {
+		rampa = 1;
+		while ((uint32_t)rampa * (rampa + 1) < area) rampa++;
+		largo = rampa + 1;
+	}
+	uint16_t tramas = largo + rampa - 1;
+	
+	// Una duracin pedida solo alarga el tramo constante
+	uint16_t pedidas = duracion / MOTION_MS_TRAMA;
+	if (pedidas > tramas) {
+		largo += pedidas - tramas;
+		tramas = pedidas;
+	}
+	uint32_t unidades = (uint32_t)rampa * largo;
+	
+	// Factores Q16 de cada eje (las divisiones, fuera del ISR)
+	uint32_t factores[MOTION_NUM_EJES];
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		factores[eje] = ((uint32_t)distancias[eje] << 16) / unidades;
+	}
+	
+	// Arrancar todos los ejes en la misma trama
+	sreg = SREG;
+	cli();
+	tramasTotalCoord = tramas;
+	rampaCoord = rampa;
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		volatile EjeMovimiento* m = &ejes[eje];
+		m->objetivo = objetivos[eje];
+		m->inicioCoord = posiciones[eje];
+		m->factorCoord = factores[eje];
+		m->unidadesCoord = 0;
+		m->direccionCoord = (objetivos[eje] >= posiciones[eje]) ? 1 : -1;
+		// El ISR pudo avanzar el eje desde la fotografa: partir de la misma posicin
+		m->posicion = posiciones[eje];
+		m->tramasCoord = (distancias[eje] > 0) ? tramas : 0;
+		if (m->tramasCoord == 0) m->velocidad = 0;
+	}
+	SREG = sreg;
+	
+	return tramas;
+}
+
+void MOTION_hold(void) {
+	// El objetivo pasa a ser la posicin actual: el eje queda quieto en la siguiente trama
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		ejes[eje].objetivo = ejes[eje].posicion;
+		ejes[eje].velocidad = 0;
+		ejes[eje].tramasCoord = 0;
+	}
+	SREG = sreg;
+}
+
+uint8_t MOTION_getPosition(uint8_t eje) {
+	if (eje >= MOTION_NUM_EJES) return 0;
+	
+	return ejes[eje].anguloSalida;
+}
+
+uint8_t MOTION_isMoving(void) {
+	uint8_t enMovimiento = 0;
+	
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		if (ejes[eje].posicion != ejes[eje].objetivo || ejes[eje].velocidad != 0) {
+			enMovimiento = 1;
+		}
+	}
+	SREG = sreg;
+	
+	return enMovimiento;
+}
+
+void MOTION_update(void) {
+	for (uint8_t eje = 0; eje < MOTION_NUM_EJES; eje++) {
+		volatile EjeMovimiento* m = &ejes[eje];
+		
+		if (m->tramasCoord > 0) {
+			// Movimiento coordinado: velocidad del perfil en la trama k (1..N)
+			uint16_t k = tramasTotalCoord - m->tramasCoord + 1;
+			uint16_t faltan = m->tramasCoord;
+			uint16_t velocidad = rampaCoord;
+			if (k < velocidad) velocidad = k;
+			if (faltan < velocidad) velocidad = faltan;
+			m->unidadesCoord += velocidad;
+			
+			uint16_t anterior = m->posicion;
+			m->tramasCoord--;
+			if (m->tramasCoord == 0) {
+				m->posicion = m->objetivo;
+				m->velocidad = 0;
+				} else {
+				uint16_t recorrido = (uint16_t)((m->unidadesCoord * m->factorCoord) >> 16);
+				m->posicion = (m->direccionCoord > 0) ? m->inicioCoord + recorrido : m->inicioCoord - recorrido;
+				m->velocidad = (int16_t)(m->posicion - anterior);
+			}
+			
+			escribirSalida(eje, m);
+			continue;
+		}
+		
+		int32_t distancia = (int32_t)m->objetivo - m->posicion;
+		if (distancia == 0 && m->velocidad == 0) continue;
+		
+		// Trabajar con magnitudes en la direccin del objetivo
+		int8_t direccion = (distancia >= 0) ? 1 : -1;
+		uint16_t d = (distancia >= 0) ? (uint16_t)distancia : (uint16_t)(-distancia);
+		int16_t a = m->aceleracion;
+		int16_t s = (direccion > 0) ? m->velocidad : -m->velocidad; // Velocidad hacia el objetivo
+		
+		if (s < 0) {
+			// Se mueve alejndose (el objetivo cambi): frenar primero
+			s += a;
+			} else if ((int32_t)s * (s + a) >= 2L * a * d) {
+			// La distancia restante alcanza justo para frenar: desacelerar,
+			// pero sin detenerse antes de llegar
+			s -= a;
+			if (s < a) s = a;
+			} else {
+			// Acelerar hasta la velocidad mxima
+			s += a;
+			if (s > m->velMax) s = m->velMax;
+		}
+		
+		if (s >= 0 && (uint16_t)s >= d) {
+			// Llega al objetivo en esta trama
+			m->posicion = m->objetivo;
+			m->velocidad = 0;
+			} else {
+			int16_t paso = (direccion > 0) ? s : -s;
+			int32_t nueva = (int32_t)m->posicion + paso;
+			
+			// Al frenar en sentido contrario no salir del rango 0-180
+			if (nueva < 0) {
+				nueva = 0;
+				paso = 0;
+				} else if (nueva > ((int32_t)180 << 8)) {
+				nueva = (int32_t)180 << 8;
+				paso = 0;
+			}
+			m->posicion = (uint16_t)nueva;
+			m->velocidad = paso;
+		}
+		
+		escribirSalida(eje, m);
+	}
+}
@@ -0,0 +1,52 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define la interfaz pblica para el motor de movimiento de
+* los servomotores. Proporciona funciones para fijar la posicin objetivo
+* de cada eje y configurar la velocidad mxima y la aceleracin del
+* perfil trapezoidal con el que cada eje se desplaza hacia su objetivo.
+*
+* Movimiento coordinado (MOTION_moveCoordinated): los cuatro ejes salen
+* en la misma trama y llegan juntos en la trama final. Todos siguen el
+* mismo perfil trapezoidal, escalado a la distancia que le toca recorrer
+* a cada uno, as que la pose cambia en lnea recta en el espacio de
+* articulaciones. La duracin nunca es menor que la que necesita el eje
+* ms exigido con su velocidad mxima y su aceleracin.
+*
+* Recursos de Hardware:
+*   - Interrupcin de desborde del Timer1 (una vez por trama de 20 ms)
+************************************************************************/
+
+#ifndef MOTION_H
+#define MOTION_H
+#include "../LBRY11/HAL.h"
+#include <stdint.h>
+
+#define MOTION_NUM_EJES 4
+#define MOTION_TODOS 0xFF          // Aplicar a todos los ejes
+#define MOTION_FRECUENCIA 50       // Tramas por segundo (periodo del Timer1)
+#define MOTION_VEL_DEFECTO 180     // Velocidad mxima por defecto (grados/s)
+#define MOTION_ACEL_DEFECTO 720    // Aceleracin por defecto (grados/s^2)
+#define MOTION_VEL_MAX 600         // Lmite de la velocidad configurable (grados/s)
+#define MOTION_ACEL_MAX 10000      // Lmite de la aceleracin configurable (grados/s^2)
+#define MOTION_MS_TRAMA (1000 / MOTION_FRECUENCIA)
+
+// Funcin que escribe un ngulo (0-180) en la salida PWM de un eje
+typedef void (*SalidaServo)(uint8_t eje, uint8_t angulo);
+
+void MOTION_init(SalidaServo salida);                                   // Initialize motion engine on the Timer1 frame
+void MOTION_setLimits(uint8_t eje, uint16_t velocidad, uint16_t aceleracion); // Set max velocity (deg/s) and acceleration (deg/s^2)
+void MOTION_setTarget(uint8_t eje, uint8_t angulo);                     // Move axis to angle with the velocity profile
+void MOTION_jumpTo(uint8_t eje, uint8_t angulo);                        // Set axis position immediately (no profile)
+uint16_t MOTION_moveCoordinated(const uint8_t* angulos, uint16_t duracion); // Move all axes to arrive together (at least duracion ms, 0 = as fast as the limits allow), returns frames
+void MOTION_hold(void);                                                 // Stop all axes where they are (no ramp)
+uint8_t MOTION_getPosition(uint8_t eje);                                // Current (interpolated) angle of an axis
+uint8_t MOTION_isMoving(void);                                          // 1 while any axis is moving
+void MOTION_update(void);                                               // Advance all axes one frame (called from ISR)
+
+#endif // MOTION_H
@@ -0,0 +1,39 @@
+/************************************************************************
+* Universidad del Valle de Guatemala
+* IE2023: Programacin de Microcontroladores
+* Conexin UART
+*
+* Autor: Juan Ren Chang Lam
+*
+* Descripcin:
+* Este archivo define macros para generar tablas de bsqueda en tiempo de
+* compilacin. Cada macro LUT_Nx(F, i) expande F(i), F(i+1), ... con N
+* elementos, de modo que una tabla en memoria de programa (PROGMEM) se
+* llena con la misma frmula que antes se calculaba en cada llamada.
+*
+* Ejemplo (tabla de 181 elementos para ngulos 0-180):
+*   #define MI_FORMULA(a) ((a) * 2)
+*   const uint16_t tabla[181] PROGMEM = { LUT_181(MI_FORMULA) };
+************************************************************************/
+
+#ifndef LUT_H
+#define LUT_H
+
+#define LUT_1x(F, i)    F(i),
+#define LUT_2x(F, i)    LUT_1x(F, i)   LUT_1x(F, (i) + 1)
+#define LUT_4x(F, i)    LUT_2x(F, i)   LUT_2x(F, (i) + 2)
+#define LUT_8x(F, i)    LUT_4x(F, i)   LUT_4x(F, (i) + 4)
+#define LUT_16x(F, i)   LUT_8x(F, i)   LUT_8x(F, (i) + 8)
+#define LUT_32x(F, i)   LUT_16x(F, i)  LUT_16x(F, (i) + 16)
+#define LUT_64x(F, i)   LUT_32x(F, i)  LUT_32x(F, (i) + 32)
+#define LUT_128x(F, i)  LUT_64x(F, i)  LUT_64x(F, (i) + 64)
+#define LUT_256x(F, i)  LUT_128x(F, i) LUT_128x(F, (i) + 128)
+#define LUT_512x(F, i)  LUT_256x(F, i) LUT_256x(F, (i) + 256)
+
+// Tabla completa de ngulos 0-180 (181 elementos)
+#define LUT_181(F)      LUT_128x(F, 0) LUT_32x(F, 128) LUT_16x(F, 160) LUT_4x(F, 176) LUT_1x(F, 180)
+
+// Tabla completa de lecturas ADC de 10 bits 0-1023 (1024 elementos)
+#define LUT_1024(F)     LUT_512x(F, 0) LUT_512x(F, 512)
+
+#endif // LUT_H
@@ -26,6 +26,7 @@
 *
 *   Comunicacin:
 *     - UART: PD0 (RX), PD1 (TX) - Interfaz de comunicacin serial
+*       (comandos ASCII y tramas binarias con CRC, ver LBRY6/PROTOCOL.h)
 *
 *   Interfaz de Usuario:
 *     - Botn Cambio Modo: PB0 (con pull-up interno)
@@ -39,17 +40,27 @@
 ************************************************************************/
 
 #define F_CPU 16000000UL
-#include <avr/io.h>
-#include <avr/interrupt.h>
-#include <util/delay.h>
+#include "LBRY11/HAL.h"
 #include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
 #include "LBRY1/ADC.h"
 #include "LBRY2/TIMER0_PWM.h"
 #include "LBRY3/USART.h"
 #include "LBRY4/EEPROM.h"
 #include "LBRY5/TIMER1_PWM.h"
+#include "LBRY6/PROTOCOL.h"
+#include "LBRY7/SCHEDULER.h"
+#include "LBRY8/MOTION.h"
+#include "LBRY10/SERVO_MUX.h"
+#include "LBRY12/BENCH.h"
+#include "LBRY13/PROFILER.h"
+#include "LBRY14/BUTTONS.h"
+#include "LBRY15/MESSAGES.h"
+#include "LBRY16/FORMAT.h"
+#include "LBRY17/TELEMETRY.h"
+#include "LBRY18/KINEMATICS.h"
+#include "LBRY19/CALIBRATION.h"
+#include "LBRY20/PLAYBACK.h"
 
 // Servos
 #define SERVO_BASE 0
@@ -63,6 +74,9 @@
 #define USART_MODE 2
 #define EEPROM_MODE 3
 
+// Ttulo de cada modo en la tabla de mensajes (MANUAL, USART, EEPROM en orden)
+#define MSG_MODO(modo) (MSG_MODO_MANUAL + (modo) - MANUAL_MODE)
+
 // Leds indicadores
 #define LED_MANUAL PD2
 #define LED_USART PD3
@@ -70,10 +84,13 @@
 #define LED_POS_BIT0 PC4
 #define LED_POS_BIT1 PC5
 
-// Push Buttons
-#define PUSH_MODE PB0
-#define PUSH_SAVE PB3
-#define PUSH_PLAY PD7
+// Periodos de las tareas del planificador (ms)
+#define PERIODO_BOTONES 10
+#define PERIODO_ADC 10
+#define PERIODO_SERVOS 20
+#define PERIODO_COMANDOS 2
+#define RETARDO_SECUENCIA 1000  // Tiempo entre posiciones de la secuencia
+#define SIN_CUADRO 0xFF         // Lector de la secuencia sin abrir
 
 // Posicin inicial
 volatile uint8_t posServoBase = 90;
@@ -84,111 +101,162 @@ volatile uint8_t posServoPinza = 0;
 // Modo de operacin
 volatile uint8_t modoOperacion = 0; // 0: Sin seleccionar, 1: Manual, 2: USART, 3: EEPROM
 
+// Movimiento coordinado (los 4 ejes llegan juntos)
+uint8_t movimientoCoordinado = 0;
+uint16_t duracionCoordinada = 0;    // ms, 0: la define el eje ms lento
+
 // Buffer para USART
-char bufferRx[20];
+#define TAMANO_BUFFER_RX 32             // "CAL,n,min,max,centro,inv,inf,sup" cabe completo
+char bufferRx[TAMANO_BUFFER_RX];
 uint8_t indiceBuffer = 0;
 uint8_t comandoCompleto = 0;
 
-// Estado de los botones
-volatile uint8_t estadoBotonAnterior = 1; // Pull-up, por lo que 1 es estado sin presionar
-volatile uint8_t estadoBotonReproducirAnterior = 1;
-volatile uint8_t estadoBotonGuardarAnterior = 1;
-volatile uint8_t flagBotonPresionado = 0;
-volatile uint8_t flagBotonReproducirPresionado = 0;
-volatile uint8_t flagBotonGuardarPresionado = 0;
-
 // Variables para modo EEPROM
 volatile uint8_t posicionActualEEPROM = 0;
 volatile uint8_t posicionSiguienteGuardado = 0;
-volatile uint8_t ejecutandoSecuencia = 0;
+uint8_t secuenciaReproduciendo = SIN_SECUENCIA;   // Secuencia con nombre en curso (SIN_SECUENCIA = ranuras)
+LectorSecuencia lectorReproduccion;               // Decodificador de la secuencia en curso
+uint8_t siguienteCuadroLector = SIN_CUADRO;       // Cuadro que entrega el lector sin reabrir
 
 // PROTOTIPO DE FUNCIONES
 void initSystem(void);                                          // Initialize system
 void updateServos(void);                                        // Update servos
+void moveServos(uint16_t duracion);                             // Update servos, coordinated over duracion ms when enabled
+void processCoordinatedCommand(void);                          // Configure coordinated moves (M,modo,ms)
 void processCommand(void);                                      // Process command
+void processBinaryCommand(void);                                // Process binary frame
 void showMenu(void);                                           // Show menu
 void setServoPosition(uint8_t servo, uint8_t angle);          // Set servo position
-void configure_push(void);                                      // Configure buttons
-void check_push(void);                                       // Check buttons
+void writeServoPWM(uint8_t servo, uint8_t angle);              // Write servo PWM output
+void handleButtonEvent(uint8_t evento);                        // Run the action of a button event
 void changeOperationMode(void);                                // Change operation mode
 void showCurrentMode(void);                                    // Show current mode
+void showModeHelp(void);                                       // Show help of current mode
 void configureLEDs(void);                                      // Configure LEDs
 void updateLEDs(void);                                         // Update LEDs
 void updatePositionLEDs(uint8_t position);                     // Update position LEDs
-void saveCurrentPosition(uint8_t positionNum);                 // Save current position
+uint8_t saveCurrentPosition(uint8_t positionNum);              // Save current position (0 if read-only)
 void loadSavedPosition(uint8_t positionNum);                   // Load saved position
-void executeSequence(void);                                    // Execute sequence
-void sendAdafruitData(void);                                   // Send data to Adafruit
+uint8_t readSlotKeyframe(uint8_t numero, CuadroClave* cuadro);  // Keyframe source: saved slots
+uint8_t readSequenceKeyframe(uint8_t numero, CuadroClave* cuadro); // Keyframe source: named sequence in playback
+void playbackPose(const PosicionGarra* pose, uint16_t duracion);  // Playback output: move servos to a pose
+void playbackEvent(uint8_t evento, uint8_t numero);            // Playback progress (LEDs and terminal)
+void processPlaybackCommand(void);                             // Pause, seek, stop, repeat and speed (P, F, O, V)
+uint8_t saveSlotsAsSequence(const char* nombre);               // Store saved slots as a named sequence
+void listSequences(void);                                      // List named sequences
+void fillTelemetry(EstadoTelemetria* estado);                  // Current state for the telemetry stream
+void processTelemetryCommand(void);                            // Configure telemetry (T,periodo,campos,formato)
+void processCartesianCommand(void);                            // Move to a point (X,x,y,z,pinza)
+void processCalibrationCommand(void);                          // Show, edit or save servo calibration (CAL)
+void refreshServoOutputs(void);                                // Rewrite all outputs with the current calibration
 void playNextPosition(void);                                   // Play next position
 void saveNextPosition(void);                                   // Save next position
+void startSlotSequence(void);                                  // Play all saved slots in order
+void clearSavedPositions(void);                                // Erase all saved slots
+void tareaBotones(void);                                       // Task: buttons
+void tareaADC(void);                                           // Task: potentiometer sampling
+void tareaServos(void);                                        // Task: servo refresh
+void tareaComandos(void);                                      // Task: USART commands
 
 int main(void) {
 	initSystem();
 	
 	showMenu();
+	if (EEPROM_imageStatus() == IMAGEN_INVALIDA) {
+		MSG_send(MSG_EEPROM_INVALIDA);
+	}
+	
+	// Registrar las tareas del planificador (cada una con su propio periodo)
+	SCHED_addTask(tareaBotones, PERIODO_BOTONES, 0);
+	SCHED_addTask(tareaADC, PERIODO_ADC, 0);
+	SCHED_addTask(tareaServos, PERIODO_SERVOS, 0);
+	SCHED_addTask(tareaComandos, PERIODO_COMANDOS, 0);
+	PLAY_init(playbackPose, playbackEvent); // Detenida hasta 'E' o 'R,nombre'
+	TELEM_init(fillTelemetry);        // Detenida hasta el comando 'T'
 	
 	while (1) {
-		// Verificar estado de los botones
-		check_push();
-		
-		// Si el botn de modo fue presionado, cambiar modo
-		if (flagBotonPresionado) {
-			changeOperationMode();
-			flagBotonPresionado = 0;
-			updateLEDs();
-		}
-		
-		// Si el botn de reproducir fue presionado en modo EEPROM
-		if (flagBotonReproducirPresionado && modoOperacion == EEPROM_MODE) {
-			playNextPosition();
-			flagBotonReproducirPresionado = 0;
-		}
-		
-		// Si el botn de guardar fue presionado en modo Manual o USART
-		if (flagBotonGuardarPresionado && (modoOperacion == MANUAL_MODE || modoOperacion == USART_MODE)) {
-			saveNextPosition();
-			flagBotonGuardarPresionado = 0;
-		}
+		// Ejecutar las tareas a las que les toca
+		BENCH_BEGIN(BENCH_LAZO);
+		SCHED_run();
+		BENCH_END(BENCH_LAZO);
+		TELEM_loopMark();
+		HAL_IDLE();
+	}
+	
+	return 0;
+}
+
+// Tarea: acciones de los botones
+void tareaBotones(void) {
+	uint8_t evento;
+	
+	// Atender todas las pulsaciones que llegaron desde la ltima vez
+	// (las interrupciones de los botones las guardan en una cola)
+	BENCH_BEGIN(BENCH_BOTONES);
+	while (BUTTONS_getEvent(&evento)) {
+		handleButtonEvent(evento);
+	}
+	BENCH_END(BENCH_BOTONES);
+}
+
+// Tarea: lectura de potencimetros en modo manual
+void tareaADC(void) {
+	// Si estamos en modo control por potencimetros
+	if (modoOperacion == MANUAL_MODE) {
+		BENCH_BEGIN(BENCH_MUESTREO);
 		
-		// Si estamos en modo control por potencimetros
-		if (modoOperacion == MANUAL_MODE) {
-			// Usar lecturas filtradas para reducir el ruido
-			posServoBase = ADC_Angulo(ADC_read_Filtr(0, 5));
-			posServoBrazo1 = ADC_Angulo(ADC_read_Filtr(1, 5));
-			posServoBrazo2 = ADC_Angulo(ADC_read_Filtr(2, 5));
-			// Invertir el rango para la pinza
-			posServoPinza = 180 - ADC_Angulo(ADC_read_Filtr(3, 5));
-			
-			// Mantener actualizacin no muy frecuente para reducir jitter
-			static uint8_t contador = 0;
-			contador++;
-			if (contador >= 3) {
-				updateServos();
-				contador = 0;
-			}
-			
-			_delay_ms(30); // Retraso para estabilidad
-		}
-		// Si estamos en modo EEPROM y ejecutando secuencia
-		else if (modoOperacion == EEPROM_MODE && ejecutandoSecuencia) {
-			executeSequence();
-		}
+		// Usar lecturas filtradas para reducir el ruido
+		// (promedio de las muestras que el ADC toma en segundo plano, no bloquea)
+		posServoBase = ADC_Angulo(ADC_read_Filtr(0, 5));
+		posServoBrazo1 = ADC_Angulo(ADC_read_Filtr(1, 5));
+		posServoBrazo2 = ADC_Angulo(ADC_read_Filtr(2, 5));
+		// Invertir el rango para la pinza
+		posServoPinza = 180 - ADC_Angulo(ADC_read_Filtr(3, 5));
 		
-		// Si se recibi un comando completo por USART
-		if (comandoCompleto) {
-			processCommand();
-			comandoCompleto = 0;
-			indiceBuffer = 0;
-		}
+		BENCH_END(BENCH_MUESTREO);
+	}
+}
+
+// Tarea: refresco de servos en modo manual (una vez por trama de 20 ms)
+void tareaServos(void) {
+	if (modoOperacion == MANUAL_MODE) {
+		BENCH_BEGIN(BENCH_SERVOS);
+		updateServos();
+		BENCH_END(BENCH_SERVOS);
+	}
+}
+
+// Tarea: atencin de comandos recibidos por USART
+void tareaComandos(void) {
+	// Si se recibi un comando completo por USART
+	if (comandoCompleto) {
+		BENCH_BEGIN(BENCH_COMANDO);
+		processCommand();
+		BENCH_END(BENCH_COMANDO);
+		comandoCompleto = 0;
+		indiceBuffer = 0;
 	}
 	
-	return 0;
+	// Si se recibi una trama binaria completa
+	if (PROTO_frameAvailable()) {
+		processBinaryCommand();
+	}
 }
 
 void initSystem(void) {
+#if SERVO_MUX_ENABLE
+	// Todos los servos en el secuenciador por software del Timer1 (Timer0 libre).
+	// Se asignan en orden, de modo que el canal coincide con SERVO_BASE..SERVO_PINZA
+	SERVO_MUX_init();
+	SERVO_MUX_attach(&DDRD, &PORTD, PD5);  // Base
+	SERVO_MUX_attach(&DDRD, &PORTD, PD6);  // Brazo1
+	SERVO_MUX_attach(&DDRB, &PORTB, PB1);  // Brazo2
+	SERVO_MUX_attach(&DDRB, &PORTB, PB2);  // Pinza
+#else
 	// Inicializar PWM para servos (Timer0 y Timer1 separados)
 	Timer0_init();
 	Timer1_init();
+#endif
 	
 	// Inicializar ADC para potencimetros
 	ADC_init();
@@ -199,17 +267,32 @@ void initSystem(void) {
 	// Inicializar EEPROM
 	initEEPROM();
 	
-	// Configurar botones
-	configure_push();
+	// Calibracin de los servos guardada en la EEPROM (antes de la primera salida)
+	CAL_init();
+	
+	// Inicializar base de tiempo de 1 ms (Timer2) para el planificador
+	SCHED_init();
+	
+	// Configurar botones (interrupciones por cambio de pin y antirrebote en el tick)
+	BUTTONS_init();
 	
 	// Configurar LEDs de modo y posicin
 	configureLEDs();
 	
-	// Posiciones iniciales de los servos
-	setPWM0A(calculate_PWM0(posServoBrazo1)); // Brazo1 (Timer0)
-	setPWM0B(calculate_PWM0(posServoBase));   // Base (Timer0)
-	setPWM1A(calculate_PWM1(posServoBrazo2)); // Brazo2 (Timer1)
-	setPWM1B(calculate_PWM1(posServoPinza));  // Pinza (Timer1)
+	// Geometra por defecto de la cinemtica inversa
+	KIN_init();
+	
+	// Inicializar motor de movimiento (perfil trapezoidal en cada trama del Timer1)
+	MOTION_init(writeServoPWM);
+#if SERVO_MUX_ENABLE
+	SERVO_MUX_setFrameCallback(MOTION_update);
+#endif
+	
+	// Posiciones iniciales de los servos (sin perfil de movimiento)
+	MOTION_jumpTo(SERVO_BASE, posServoBase);
+	MOTION_jumpTo(SERVO_BRAZO1, posServoBrazo1);
+	MOTION_jumpTo(SERVO_BRAZO2, posServoBrazo2);
+	MOTION_jumpTo(SERVO_PINZA, posServoPinza);
 	
 	// Obtener el nmero de posiciones guardadas para inicializar el contador de siguiente posicin
 	posicionSiguienteGuardado = Saved_Pos_Count();
@@ -218,20 +301,6 @@ void initSystem(void) {
 	sei();
 }
 
-void configure_push(void) {
-	// Configurar PB0 como entrada con pull-up interno (botn de modo)
-	DDRB &= ~(1 << PUSH_MODE);
-	PORTB |= (1 << PUSH_MODE);
-	
-	// Configurar PB3 como entrada con pull-up interno (botn de guardar)
-	DDRB &= ~(1 << PUSH_SAVE);
-	PORTB |= (1 << PUSH_SAVE);
-	
-	// Configurar PD7 como entrada con pull-up interno (botn de reproducir)
-	DDRD &= ~(1 << PUSH_PLAY);
-	PORTD |= (1 << PUSH_PLAY);
-}
-
 void configureLEDs(void) {
 	// Configurar PD2, PD3 y PD4 como salidas (LEDs de modo)
 	DDRD |= (1 << LED_MANUAL) | (1 << LED_USART) | (1 << LED_EEPROM);
@@ -239,29 +308,38 @@ void configureLEDs(void) {
 	// Configurar PC4 y PC5 como salidas (LEDs indicadores de posicin)
 	DDRC |= (1 << LED_POS_BIT0) | (1 << LED_POS_BIT1);
 	
-	// Apagar todos los LEDs inicialmente
+	// Apagar todos los LEDs inicialmente (PORTD es compartido con el
+	// multiplexor de servos)
+	uint8_t sreg = SREG;
+	cli();
 	PORTD &= ~((1 << LED_MANUAL) | (1 << LED_USART) | (1 << LED_EEPROM));
+	SREG = sreg;
 	PORTC &= ~((1 << LED_POS_BIT0) | (1 << LED_POS_BIT1));
 }
 
 void updateLEDs(void) {
-	// Apagar todos los LEDs de modo primero
-	PORTD &= ~((1 << LED_MANUAL) | (1 << LED_USART) | (1 << LED_EEPROM));
-	
-	// Encender el LED correspondiente al modo actual
+	// LED correspondiente al modo actual
+	uint8_t encendido = 0;
 	switch (modoOperacion) {
 		case MANUAL_MODE:
-		PORTD |= (1 << LED_MANUAL);
+		encendido = (1 << LED_MANUAL);
 		break;
 		case USART_MODE:
-		PORTD |= (1 << LED_USART);
+		encendido = (1 << LED_USART);
 		break;
 		case EEPROM_MODE:
-		PORTD |= (1 << LED_EEPROM);
+		encendido = (1 << LED_EEPROM);
 		break;
 		default:
 		break;
 	}
+	
+	// Apagar los LEDs de modo y encender el del modo en una sola escritura
+	// atmica: PD5 y PD6 los cambian los ISR del multiplexor de servos
+	uint8_t sreg = SREG;
+	cli();
+	PORTD = (PORTD & ~((1 << LED_MANUAL) | (1 << LED_USART) | (1 << LED_EEPROM))) | encendido;
+	SREG = sreg;
 }
 
 void updatePositionLEDs(uint8_t posicion) {
@@ -273,46 +351,54 @@ void updatePositionLEDs(uint8_t posicion) {
 	if (posicion & 0x02) PORTC |= (1 << LED_POS_BIT1);
 }
 
-void check_push(void) {
-	// Leer estado actual de los botones
-	uint8_t estadoBotonActual = (PINB & (1 << PUSH_MODE)) ? 1 : 0;
-	uint8_t estadoBotonReproducirActual = (PIND & (1 << PUSH_PLAY)) ? 1 : 0;
-	uint8_t estadoBotonGuardarActual = (PINB & (1 << PUSH_SAVE)) ? 1 : 0;
+// Accin de cada evento de botn
+void handleButtonEvent(uint8_t evento) {
+	uint8_t tipo = TIPO_DE(evento);
 	
-	// Detectar flanco descendente del botn de modo (botn presionado)
-	if (estadoBotonAnterior == 1 && estadoBotonActual == 0) {
-		_delay_ms(50);
-		
-		// Verificar si sigue presionado
-		if ((PINB & (1 << PUSH_MODE)) == 0) {
-			flagBotonPresionado = 1;
+	switch (BOTON_DE(evento)) {
+		case BOTON_MODO:
+		if (tipo == BOTON_LARGO) {
+			// Mantenido: volver directo al men
+			modoOperacion = MENU_MODE;
+			PLAY_stop();
+			showMenu();
+			} else {
+			changeOperationMode();
 		}
-	}
-	
-	// Detectar flanco descendente del botn de reproducir (botn presionado)
-	if (estadoBotonReproducirAnterior == 1 && estadoBotonReproducirActual == 0) {
-		_delay_ms(50);
-
-		// Verificar si sigue presionado
-		if ((PIND & (1 << PUSH_PLAY)) == 0) {
-			flagBotonReproducirPresionado = 1;
+		updateLEDs();
+		break;
+		
+		case BOTON_REPRODUCIR:
+		if (modoOperacion != EEPROM_MODE) break;
+		if (tipo == BOTON_CORTO && PLAY_state() != PLAY_DETENIDO) {
+			// Con una secuencia en curso: pausar o continuar
+			if (PLAY_state() == PLAY_PAUSADO) {
+				PLAY_resume();
+				sendUSARTString_P(PSTR("\r\nReproduccion continuada\r\n"));
+				} else {
+				PLAY_pause();
+				sendUSARTString_P(PSTR("\r\nReproduccion en pausa\r\n"));
+			}
+			} else if (tipo == BOTON_CORTO) {
+			playNextPosition();
+			} else if (tipo == BOTON_DOBLE) {
+			startSlotSequence();
+			} else if (PLAY_state() != PLAY_DETENIDO) {
+			// Mantenido: detener la secuencia en curso
+			PLAY_stop();
+			sendUSARTString_P(PSTR("\r\nSecuencia detenida\r\n"));
 		}
-	}
-	
-	// Detectar flanco descendente del botn de guardar (botn presionado)
-	if (estadoBotonGuardarAnterior == 1 && estadoBotonGuardarActual == 0) {
-		_delay_ms(50);
+		break;
 		
-		// Verificar si sigue presionado
-		if ((PINB & (1 << PUSH_SAVE)) == 0) {
-			flagBotonGuardarPresionado = 1;
+		case BOTON_GUARDAR:
+		if (modoOperacion != MANUAL_MODE && modoOperacion != USART_MODE) break;
+		if (tipo == BOTON_LARGO) {
+			clearSavedPositions();
+			} else {
+			saveNextPosition();
 		}
+		break;
 	}
-	
-	// Actualizar estados anteriores
-	estadoBotonAnterior = estadoBotonActual;
-	estadoBotonReproducirAnterior = estadoBotonReproducirActual;
-	estadoBotonGuardarAnterior = estadoBotonGuardarActual;
 }
 
 void changeOperationMode(void) {
@@ -323,7 +409,7 @@ void changeOperationMode(void) {
 	}
 	
 	// Si estbamos ejecutando una secuencia, detenerla
-	ejecutandoSecuencia = 0;
+	PLAY_stop();
 	
 	// Apagar los LEDs de posicin al cambiar de modo
 	PORTC &= ~((1 << LED_POS_BIT0) | (1 << LED_POS_BIT1));
@@ -333,91 +419,117 @@ void changeOperationMode(void) {
 }
 
 void showCurrentMode(void) {
+	if (modoOperacion == MENU_MODE) return;
+	
+	// Cambio de modo con el botn: ttulo con prefijo y ayuda del modo
+	MSG_send(MSG_PREFIJO_BOTON);
+	MSG_send(MSG_MODO(modoOperacion));
+	showModeHelp();
+}
+
+void showModeHelp(void) {
+	// Los bloques de ayuda estn una sola vez en la tabla de mensajes (flash)
 	switch (modoOperacion) {
 		case MANUAL_MODE:
-		sendUSARTString("\r\n[BOTON] Modo de control por potenciometros activado\r\n");
-		sendUSARTString("Presiona el boton en PB3 para guardar la posicion actual en EEPROM\r\n");
-		sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
+		MSG_send(MSG_AYUDA_GUARDAR);
 		break;
 		case USART_MODE:
-		sendUSARTString("\r\n[BOTON] Modo de control por USART activado\r\n");
-		sendUSARTString("Formato: S,base,brazo1,brazo2,pinza\r\n");
-		sendUSARTString("Presiona el boton en PB3 para guardar la posicion actual en EEPROM\r\n");
-		sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
+		MSG_send(MSG_AYUDA_USART);
+		MSG_send(MSG_AYUDA_GUARDAR);
 		break;
 		case EEPROM_MODE:
-		sendUSARTString("\r\n[BOTON] Modo EEPROM activado\r\n");
-		sendUSARTString("Comandos disponibles:\r\n");
-		sendUSARTString("G,n - Guardar posicion actual en la posicion n\r\n");
-		sendUSARTString("C,n - Cargar posicion n\r\n");
-		sendUSARTString("E - Ejecutar secuencia de posiciones guardadas\r\n");
-		sendUSARTString("B - Borrar todas las posiciones guardadas\r\n");
-		sendUSARTString("L - Listar posiciones guardadas\r\n");
-		sendUSARTString("Presiona el boton en PD7 para reproducir las posiciones guardadas una por una\r\n");
-		sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
+		MSG_send(MSG_AYUDA_EEPROM);
+		MSG_send(MSG_AYUDA_REPRODUCIR);
+		if (EEPROM_imageStatus() == IMAGEN_INVALIDA) {
+			MSG_send(MSG_EEPROM_INVALIDA);
+		}
 		break;
 		default:
-		break;
+		return;
 	}
+	MSG_send(MSG_AYUDA_VOLVER);
 }
 
 void updateServos(void) {
-	// Usar los valores de PWM especficos para cada timer
-	setPWM0B(calculate_PWM0(posServoBase));      // Base (Timer0)
-	setPWM0A(calculate_PWM0(posServoBrazo1));    // Brazo1 (Timer0)
-	setPWM1A(calculate_PWM1(posServoBrazo2));    // Brazo2 (Timer1)
-	setPWM1B(calculate_PWM1_inverted(posServoPinza)/3);  // Pinza invertida (Timer1)
+	moveServos(duracionCoordinada);
+}
+
+void moveServos(uint16_t duracion) {
+	// En modo manual los potencimetros cambian el objetivo en cada trama,
+	// as que cada eje sigue a su potencimetro con su propio perfil
+	if (movimientoCoordinado && modoOperacion != MANUAL_MODE) {
+		uint8_t angulos[MOTION_NUM_EJES];
+		angulos[SERVO_BASE] = posServoBase;
+		angulos[SERVO_BRAZO1] = posServoBrazo1;
+		angulos[SERVO_BRAZO2] = posServoBrazo2;
+		angulos[SERVO_PINZA] = posServoPinza;
+		MOTION_moveCoordinated(angulos, duracion);
+		return;
+	}
+	
+	// Enviar las posiciones al motor de movimiento, que lleva cada servo
+	// a su objetivo con el perfil de velocidad configurado
+	MOTION_setTarget(SERVO_BASE, posServoBase);
+	MOTION_setTarget(SERVO_BRAZO1, posServoBrazo1);
+	MOTION_setTarget(SERVO_BRAZO2, posServoBrazo2);
+	MOTION_setTarget(SERVO_PINZA, posServoPinza);
 }
 
 void showMenu(void) {
-	sendUSARTString("\r\n--- PROYECTO #2 IE2023 - GARRA ROBOTICA ---\r\n");
-	sendUSARTString("Presione el numero de la opcion que quiere realizar:\r\n");
-	sendUSARTString("1. Controlar garra con Pots (Modo Manual)\r\n");
-	sendUSARTString("2. Establecer una nueva posicion por USART\r\n");
-	sendUSARTString("3. Modo EEPROM (guardar/cargar posiciones)\r\n");
-	sendUSARTString("Tambin puede presionar el botn conectado a PB0 para cambiar de modo\r\n");
-	sendUSARTString("Ingrese opcion: ");
+	MSG_send(MSG_MENU);
 }
 
 void processCommand(void) {
 	// Si el usuario quiere volver al men principal desde cualquier modo
-	if (strcmp(bufferRx, "menu") == 0) {
+	if (strcmp_P(bufferRx, PSTR("menu")) == 0) {
 		modoOperacion = MENU_MODE;
+		PLAY_stop();
 		showMenu();
 		updateLEDs();
 		return; // Salir de la funcin despus de procesar "menu"
 	}
+	
+#if PROFILER_ENABLE
+	// Estadsticas del perfilador, en cualquier modo
+	if (strncmp_P(bufferRx, PSTR("STATS"), 5) == 0) {
+		if (strcmp_P(bufferRx, PSTR("STATS,0")) == 0) {
+			PROF_reset();
+			sendUSARTString_P(PSTR("\r\nEstadisticas reiniciadas\r\n"));
+			} else {
+			PROF_report();
+		}
+		return;
+	}
+#endif
+	
+	// Telemetra peridica, en cualquier modo
+	if (bufferRx[0] == 'T' && bufferRx[1] == ',') {
+		processTelemetryCommand();
+		return;
+	}
+	
+	// Movimiento coordinado, en cualquier modo
+	if (bufferRx[0] == 'M' && bufferRx[1] == ',') {
+		processCoordinatedCommand();
+		return;
+	}
+	
+	// Calibracin de los servos, en cualquier modo
+	if (strncmp_P(bufferRx, PSTR("CAL"), 3) == 0 && (bufferRx[3] == '\0' || bufferRx[3] == ',')) {
+		processCalibrationCommand();
+		return;
+	}
 
 	// Si no hay modo seleccionado, interpretar como seleccin de modo
 	if (modoOperacion == MENU_MODE) {
-		if (bufferRx[0] == '1') {
-			modoOperacion = MANUAL_MODE;
-			sendUSARTString("\r\nModo de control por potenciometros activado\r\n");
-			sendUSARTString("Presiona el boton en PB3 para guardar la posicion actual en EEPROM\r\n");
-			sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
-			updateLEDs();
-			} else if (bufferRx[0] == '2') {
-			modoOperacion = USART_MODE;
-			sendUSARTString("\r\nModo de control por USART activado\r\n");
-			sendUSARTString("Formato: S,base,brazo1,brazo2,pinza\r\n");
-			sendUSARTString("Ejemplo: S,90,45,120,30\r\n");
-			sendUSARTString("Presiona el boton en PB3 para guardar la posicion actual en EEPROM\r\n");
-			sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
-			updateLEDs();
-			} else if (bufferRx[0] == '3') {
-			modoOperacion = EEPROM_MODE;
-			sendUSARTString("\r\nModo EEPROM activado\r\n");
-			sendUSARTString("Comandos disponibles:\r\n");
-			sendUSARTString("G,n - Guardar posicion actual en la posicion n\r\n");
-			sendUSARTString("C,n - Cargar posicion n\r\n");
-			sendUSARTString("E - Ejecutar secuencia de posiciones guardadas\r\n");
-			sendUSARTString("B - Borrar todas las posiciones guardadas\r\n");
-			sendUSARTString("L - Listar posiciones guardadas\r\n");
-			sendUSARTString("Presiona el boton en PD7 para reproducir las posiciones guardadas una por una\r\n");
-			sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
+		if (bufferRx[0] >= '1' && bufferRx[0] <= '3') {
+			modoOperacion = bufferRx[0] - '0';
+			sendUSARTString_P(PSTR("\r\n"));
+			MSG_send(MSG_MODO(modoOperacion));
+			showModeHelp();
 			updateLEDs();
 			} else {
-			sendUSARTString("\r\nOpcion no valida. Intente de nuevo\r\n");
+			sendUSARTString_P(PSTR("\r\nOpcion no valida. Intente de nuevo\r\n"));
 			showMenu();
 		}
 	}
@@ -425,33 +537,68 @@ void processCommand(void) {
 	else if (modoOperacion == USART_MODE) {
 		// Verificar si es un comando de posicin (formato: S,base,brazo1,brazo2,pinza)
 		if (bufferRx[0] == 'S' && bufferRx[1] == ',') {
-			// Extraer valores usando strtok
+			// Extraer valores usando strtok (solo se aplican si llegan los cuatro)
 			char* token = strtok(bufferRx, ",");
 			token = strtok(NULL, ","); // Obtener valor de base
 			if (token != NULL) {
-				posServoBase = atoi(token);
+				uint8_t base = atoi(token);
 				token = strtok(NULL, ","); // Obtener valor de brazo1
 				if (token != NULL) {
-					posServoBrazo1 = atoi(token);
+					uint8_t brazo1 = atoi(token);
 					token = strtok(NULL, ","); // Obtener valor de brazo2
 					if (token != NULL) {
-						posServoBrazo2 = atoi(token);
+						uint8_t brazo2 = atoi(token);
 						token = strtok(NULL, ","); // Obtener valor de pinza
 						if (token != NULL) {
+							posServoBase = base;
+							posServoBrazo1 = brazo1;
+							posServoBrazo2 = brazo2;
 							posServoPinza = atoi(token);
 							
 							// Actualizar posiciones de servos
 							updateServos();
-							sendUSARTString("\r\nPosicion actualizada\r\n");
+							sendUSARTString_P(PSTR("\r\nPosicion actualizada\r\n"));
 						}
 					}
 				}
 			}
 		}
+		// Configurar el perfil de movimiento (formato: V,velocidad,aceleracion)
+		else if (bufferRx[0] == 'V' && bufferRx[1] == ',') {
+			char* token = strtok(bufferRx, ",");
+			token = strtok(NULL, ","); // Obtener velocidad (grados/s)
+			if (token != NULL) {
+				uint16_t velocidad = atoi(token);
+				token = strtok(NULL, ","); // Obtener aceleracin (grados/s^2)
+				if (token != NULL && velocidad > 0) {
+					MOTION_setLimits(MOTION_TODOS, velocidad, atoi(token));
+					sendUSARTString_P(PSTR("\r\nPerfil de movimiento actualizado\r\n"));
+				}
+			}
+		}
+		// Mover la punta a un punto cartesiano (formato: X,x,y,z,pinza)
+		else if (bufferRx[0] == 'X' && bufferRx[1] == ',') {
+			processCartesianCommand();
+		}
+		// Configurar la geometra del brazo (formato: K,brazo1,brazo2,altura)
+		else if (bufferRx[0] == 'K' && bufferRx[1] == ',') {
+			char* token = strtok(bufferRx, ",");
+			uint16_t medidas[3];
+			uint8_t i;
+			for (i = 0; i < 3; i++) {
+				token = strtok(NULL, ","); // Obtener la siguiente medida (mm)
+				if (token == NULL) break;
+				medidas[i] = atoi(token);
+			}
+			if (i == 3 && KIN_setGeometry(medidas[0], medidas[1], medidas[2])) {
+				sendUSARTString_P(PSTR("\r\nGeometria actualizada\r\n"));
+				} else {
+				sendUSARTString_P(PSTR("\r\nGeometria invalida (1-1000 mm)\r\n"));
+			}
+		}
 		else {
-			sendUSARTString("\r\nComando no valido\r\n");
-			sendUSARTString("Formato: S,base,brazo1,brazo2,pinza\r\n");
-			sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
+			MSG_send(MSG_COMANDO_INVALIDO);
+			showModeHelp();
 		}
 	}
 	// Si estamos en modo EEPROM, procesar comandos de EEPROM
@@ -459,17 +606,20 @@ void processCommand(void) {
 		// Guardar posicin actual (G,n)
 		if (bufferRx[0] == 'G' && bufferRx[1] == ',') {
 			uint8_t positionNum = atoi(bufferRx + 2);
-			if (positionNum < MAX_POSICIONES_GUARDADAS) {
-				saveCurrentPosition(positionNum);
+			if (positionNum >= MAX_POSICIONES_GUARDADAS) {
+				sendUSARTString_P(PSTR("\r\nNumero de posicion invalido\r\n"));
+				} else if (!saveCurrentPosition(positionNum)) {
+				MSG_send(MSG_EEPROM_INVALIDA);
+				} else {
 				// Actualizar el contador de posicin siguiente si es necesario
 				if (positionNum >= posicionSiguienteGuardado) {
 					posicionSiguienteGuardado = positionNum + 1;
 				}
-				char mensaje[50];
-				sprintf(mensaje, "\r\nPosicion guardada en la ranura %d\r\n", positionNum);
-				sendUSARTString(mensaje);
-				} else {
-				sendUSARTString("\r\nNumero de posicion invalido\r\n");
+				char linea[FMT_MAX_LINEA];
+				uint8_t largo = FMT_text_P(linea, PSTR("\r\nPosicion guardada en la ranura "));
+				largo += FMT_unsigned(linea + largo, positionNum);
+				largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+				FMT_sendLine(linea, largo);
 			}
 		}
 		// Cargar posicin guardada (C,n)
@@ -477,99 +627,316 @@ void processCommand(void) {
 			uint8_t positionNum = atoi(bufferRx + 2);
 			if (positionNum < Saved_Pos_Count()) {
 				loadSavedPosition(positionNum);
-				char mensaje[50];
-				sprintf(mensaje, "\r\nPosicion %d cargada\r\n", positionNum);
-				sendUSARTString(mensaje);
+				char linea[FMT_MAX_LINEA];
+				uint8_t largo = FMT_text_P(linea, PSTR("\r\nPosicion "));
+				largo += FMT_unsigned(linea + largo, positionNum);
+				largo += FMT_text_P(linea + largo, PSTR(" cargada\r\n"));
+				FMT_sendLine(linea, largo);
 				
 				// Actualizar LEDs para mostrar la posicin actual
 				updatePositionLEDs(positionNum);
 				} else {
-				sendUSARTString("\r\nNumero de posicion invalido o no guardada\r\n");
+				sendUSARTString_P(PSTR("\r\nNumero de posicion invalido o no guardada\r\n"));
 			}
 		}
 		// Ejecutar secuencia (E)
 		else if (bufferRx[0] == 'E') {
-			if (Saved_Pos_Count() > 0) {
-				ejecutandoSecuencia = 1;
-				posicionActualEEPROM = 0;
-				sendUSARTString("\r\nEjecutando secuencia de posiciones guardadas\r\n");
-				} else {
-				sendUSARTString("\r\nNo hay posiciones guardadas para ejecutar\r\n");
-			}
+			startSlotSequence();
 		}
 		// Borrar todas las posiciones (B)
 		else if (bufferRx[0] == 'B') {
-			clearAllPositions();
-			posicionSiguienteGuardado = 0;  // Reiniciar el contador de posicin siguiente
-			sendUSARTString("\r\nTodas las posiciones han sido borradas\r\n");
-			// Apagar los LEDs de posicin
+			clearSavedPositions();
+		}
+		// Guardar las posiciones como secuencia con nombre (N,nombre)
+		else if (bufferRx[0] == 'N' && bufferRx[1] == ',') {
+			if (Saved_Pos_Count() == 0) {
+				sendUSARTString_P(PSTR("\r\nNo hay posiciones guardadas para la secuencia\r\n"));
+				} else if (EEPROM_imageStatus() == IMAGEN_INVALIDA) {
+				MSG_send(MSG_EEPROM_INVALIDA);
+				} else if (saveSlotsAsSequence(bufferRx + 2) == SIN_SECUENCIA) {
+				sendUSARTString_P(PSTR("\r\nNo hay espacio para la secuencia\r\n"));
+				} else {
+				sendUSARTString_P(PSTR("\r\nSecuencia guardada\r\n"));
+			}
+		}
+		// Reproducir secuencia con nombre (R,nombre)
+		else if (bufferRx[0] == 'R' && bufferRx[1] == ',') {
+			uint8_t indice = EEPROM_findSequence(bufferRx + 2);
+			if (indice != SIN_SECUENCIA) {
+				secuenciaReproduciendo = indice;
+				siguienteCuadroLector = SIN_CUADRO;
+				sendUSARTString_P(PSTR("\r\nReproduciendo secuencia\r\n"));
+				PLAY_start(readSequenceKeyframe, EEPROM_sequenceLength(indice));
+				} else {
+				sendUSARTString_P(PSTR("\r\nSecuencia no encontrada\r\n"));
+			}
+		}
+		// Borrar secuencia con nombre (D,nombre)
+		else if (bufferRx[0] == 'D' && bufferRx[1] == ',') {
+			uint8_t indice = EEPROM_findSequence(bufferRx + 2);
+			if (indice != SIN_SECUENCIA) {
+				// Los ndices de las secuencias siguientes cambian al borrar
+				PLAY_stop();
+				EEPROM_deleteSequence(indice);
+				sendUSARTString_P(PSTR("\r\nSecuencia borrada\r\n"));
+				} else {
+				sendUSARTString_P(PSTR("\r\nSecuencia no encontrada\r\n"));
+			}
+		}
+		// Dar formato a la EEPROM, borrando todo (FORMATEAR)
+		else if (strcmp_P(bufferRx, PSTR("FORMATEAR")) == 0) {
+			PLAY_stop();
+			EEPROM_format();
+			posicionSiguienteGuardado = 0;
+			sendUSARTString_P(PSTR("\r\nEEPROM formateada\r\n"));
 			PORTC &= ~((1 << LED_POS_BIT0) | (1 << LED_POS_BIT1));
 		}
+		// Control de la reproduccin (P, P,n, F, O,modo,veces,porcentaje)
+		else if ((bufferRx[0] == 'P' || bufferRx[0] == 'F') && (bufferRx[1] == '\0' || bufferRx[1] == ',')) {
+			processPlaybackCommand();
+		}
+		else if (bufferRx[0] == 'O' && bufferRx[1] == ',') {
+			processPlaybackCommand();
+		}
+		// Listar secuencias con nombre (Q)
+		else if (bufferRx[0] == 'Q') {
+			listSequences();
+		}
 		// Listar posiciones guardadas (L)
 		else if (bufferRx[0] == 'L') {
 			uint8_t numPosiciones = Saved_Pos_Count();
-			char mensaje[50];
-			sprintf(mensaje, "\r\nPosiciones guardadas: %d\r\n", numPosiciones);
-			sendUSARTString(mensaje);
+			char linea[FMT_MAX_LINEA];
+			uint8_t largo = FMT_text_P(linea, PSTR("\r\nPosiciones guardadas: "));
+			largo += FMT_unsigned(linea + largo, numPosiciones);
+			largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+			FMT_sendLine(linea, largo);
 			for (uint8_t i = 0; i < numPosiciones; i++) {
 				PosicionGarra pos = loadPosition(i);
-				sprintf(mensaje, "Pos %d: Base=%d, Brazo1=%d, Brazo2=%d, Pinza=%d\r\n",
-				i, pos.base, pos.brazo1, pos.brazo2, pos.pinza);
-				sendUSARTString(mensaje);
+				largo = FMT_text_P(linea, PSTR("Pos "));
+				largo += FMT_unsigned(linea + largo, i);
+				largo += FMT_text_P(linea + largo, PSTR(": Base="));
+				largo += FMT_unsigned(linea + largo, pos.base);
+				largo += FMT_text_P(linea + largo, PSTR(", Brazo1="));
+				largo += FMT_unsigned(linea + largo, pos.brazo1);
+				largo += FMT_text_P(linea + largo, PSTR(", Brazo2="));
+				largo += FMT_unsigned(linea + largo, pos.brazo2);
+				largo += FMT_text_P(linea + largo, PSTR(", Pinza="));
+				largo += FMT_unsigned(linea + largo, pos.pinza);
+				largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+				FMT_sendLine(linea, largo);
 			}
 		}
 		else {
-			sendUSARTString("\r\nComando no valido\r\n");
-			sendUSARTString("Comandos disponibles:\r\n");
-			sendUSARTString("G,n - Guardar posicion actual en la posicion n\r\n");
-			sendUSARTString("C,n - Cargar posicion n\r\n");
-			sendUSARTString("E - Ejecutar secuencia de posiciones guardadas\r\n");
-			sendUSARTString("B - Borrar todas las posiciones guardadas\r\n");
-			sendUSARTString("L - Listar posiciones guardadas\r\n");
-			sendUSARTString("Presiona el boton en PD7 para reproducir las posiciones guardadas una por una\r\n");
-			sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
+			MSG_send(MSG_COMANDO_INVALIDO);
+			showModeHelp();
 		}
 	}
 	// Si estamos en modo potencimetros, permitir algunos comandos especiales
 	else if (modoOperacion == MANUAL_MODE) {
 		// Puedes agregar ms comandos especiales para el modo manual si es necesario
-		sendUSARTString("\r\nEn modo de control por potenciometros\r\n");
-		sendUSARTString("Presiona el boton en PB3 para guardar la posicion actual en EEPROM\r\n");
-		sendUSARTString("Escribe 'menu' para volver al menu principal\r\n");
+		sendUSARTString_P(PSTR("\r\nEn modo de control por potenciometros\r\n"));
+		showModeHelp();
+	}
+}
+
+void processBinaryCommand(void) {
+	const TramaBinaria* trama = PROTO_getFrame();
+	uint8_t opcode = trama->opcode;
+	uint8_t estado = PROTO_OK;
+	uint8_t respuesta[PROTO_MAX_PAYLOAD - 1];
+	uint8_t longitudRespuesta = 0;
+	
+	// Trama corrupta: responder con el error sin ejecutar nada
+	if (trama->estado != PROTO_OK) {
+		PROTO_releaseFrame();
+		PROTO_sendAck(opcode, trama->estado);
+		return;
+	}
+	
+	switch (opcode) {
+		// Mover los servos (datos: base, brazo1, brazo2, pinza)
+		case PROTO_OP_SET_POSE:
+		if (trama->longitud != 4) {
+			estado = PROTO_ERR_LONGITUD;
+			} else if (modoOperacion == MANUAL_MODE) {
+			estado = PROTO_ERR_MODO;
+			} else {
+			posServoBase = trama->datos[0];
+			posServoBrazo1 = trama->datos[1];
+			posServoBrazo2 = trama->datos[2];
+			posServoPinza = trama->datos[3];
+			updateServos();
+		}
+		break;
+		
+		// Cargar una posicin guardada (datos: n)
+		case PROTO_OP_GOTO_POS:
+		if (trama->longitud != 1) {
+			estado = PROTO_ERR_LONGITUD;
+			} else if (trama->datos[0] >= Saved_Pos_Count()) {
+			estado = PROTO_ERR_RANGO;
+			} else if (modoOperacion == MANUAL_MODE) {
+			estado = PROTO_ERR_MODO;
+			} else {
+			loadSavedPosition(trama->datos[0]);
+			updatePositionLEDs(trama->datos[0]);
+		}
+		break;
+		
+		// Guardar varias posiciones (datos: inicio, cantidad, cantidad x 4 bytes)
+		case PROTO_OP_SAVE_BULK:
+		if (trama->longitud < 2 || trama->longitud != 2 + trama->datos[1] * BYTES_POR_POSICION) {
+			estado = PROTO_ERR_LONGITUD;
+			} else if (trama->datos[0] + trama->datos[1] > MAX_POSICIONES_GUARDADAS) {
+			estado = PROTO_ERR_RANGO;
+			} else if (EEPROM_imageStatus() == IMAGEN_INVALIDA) {
+			estado = PROTO_ERR_SOLO_LECTURA;
+			} else {
+			const uint8_t* datos = trama->datos + 2;
+			for (uint8_t i = 0; i < trama->datos[1]; i++) {
+				PosicionGarra posicion;
+				posicion.base = *datos++;
+				posicion.brazo1 = *datos++;
+				posicion.brazo2 = *datos++;
+				posicion.pinza = *datos++;
+				savePosition(trama->datos[0] + i, posicion);
+			}
+			// Actualizar el contador de posicin siguiente si es necesario
+			if (trama->datos[0] + trama->datos[1] > posicionSiguienteGuardado) {
+				posicionSiguienteGuardado = trama->datos[0] + trama->datos[1];
+			}
+		}
+		break;
+		
+		// Leer varias posiciones (datos: inicio, cantidad)
+		case PROTO_OP_LOAD_BULK:
+		if (trama->longitud != 2 || trama->datos[1] * BYTES_POR_POSICION > sizeof(respuesta)) {
+			estado = PROTO_ERR_LONGITUD;
+			} else if (trama->datos[0] + trama->datos[1] > Saved_Pos_Count()) {
+			estado = PROTO_ERR_RANGO;
+			} else {
+			for (uint8_t i = 0; i < trama->datos[1]; i++) {
+				PosicionGarra posicion = loadPosition(trama->datos[0] + i);
+				respuesta[longitudRespuesta++] = posicion.base;
+				respuesta[longitudRespuesta++] = posicion.brazo1;
+				respuesta[longitudRespuesta++] = posicion.brazo2;
+				respuesta[longitudRespuesta++] = posicion.pinza;
+			}
+		}
+		break;
+		
+		// Estado actual: ngulos, modo, posiciones guardadas y lecturas ADC (little-endian)
+		case PROTO_OP_TELEMETRY:
+		if (trama->longitud != 0) {
+			estado = PROTO_ERR_LONGITUD;
+			} else {
+			respuesta[longitudRespuesta++] = posServoBase;
+			respuesta[longitudRespuesta++] = posServoBrazo1;
+			respuesta[longitudRespuesta++] = posServoBrazo2;
+			respuesta[longitudRespuesta++] = posServoPinza;
+			respuesta[longitudRespuesta++] = modoOperacion;
+			respuesta[longitudRespuesta++] = Saved_Pos_Count();
+			for (uint8_t canal = 0; canal < ADC_NUM_CANALES; canal++) {
+				uint16_t lectura = ADC_read(canal);
+				respuesta[longitudRespuesta++] = (uint8_t)lectura;
+				respuesta[longitudRespuesta++] = (uint8_t)(lectura >> 8);
+			}
+		}
+		break;
+		
+		// Telemetra peridica (datos: periodo bajo, periodo alto, campos, formato; periodo 0 la detiene)
+		case PROTO_OP_STREAM:
+		if (trama->longitud != 4) {
+			estado = PROTO_ERR_LONGITUD;
+			} else {
+			uint16_t periodo = trama->datos[0] | ((uint16_t)trama->datos[1] << 8);
+			if (periodo == 0) {
+				TELEM_stop();
+				} else if (!TELEM_start(periodo, trama->datos[2], trama->datos[3])) {
+				estado = PROTO_ERR_RANGO;
+			}
+		}
+		break;
+		
+		default:
+		estado = PROTO_ERR_OPCODE;
+		break;
 	}
+	
+	// Liberar el buffer antes de responder para poder recibir la siguiente trama
+	PROTO_releaseFrame();
+	
+	if (estado != PROTO_OK) {
+		longitudRespuesta = 0;
+	}
+	PROTO_sendResponse(opcode, estado, respuesta, longitudRespuesta);
 }
 
 void setServoPosition(uint8_t servo, uint8_t angle) {
 	switch (servo) {
 		case SERVO_BASE:
 		posServoBase = angle;
-		setPWM0B(calculate_PWM0(angle));
 		break;
 		case SERVO_BRAZO1:
 		posServoBrazo1 = angle;
-		setPWM0A(calculate_PWM0(angle));
 		break;
 		case SERVO_BRAZO2:
 		posServoBrazo2 = angle;
-		setPWM1A(calculate_PWM1(angle));
 		break;
 		case SERVO_PINZA:
 		posServoPinza = angle;
-		setPWM1B(calculate_PWM1_inverted(angle)); // Usar funcin invertida
+		break;
+		default:
+		return;
+	}
+	
+	MOTION_setTarget(servo, angle);
+}
+
+// Salida del motor de movimiento: escribir el PWM de un servo (se llama desde el ISR del Timer1)
+void writeServoPWM(uint8_t servo, uint8_t angle) {
+	if (servo > SERVO_PINZA) return;
+	
+	// Pulso calibrado del canal (rango, centro, inversin y lmites), en ticks de 0.5 us
+	uint16_t ticks = CAL_ticks(servo, angle);
+#if SERVO_MUX_ENABLE
+	SERVO_MUX_write(servo, ticks);
+#else
+	// Usar los valores de PWM especficos para cada timer
+	switch (servo) {
+		case SERVO_BASE:
+		setPWM0B(calculate_PWM0_ticks(ticks));        // Base (Timer0)
+		break;
+		case SERVO_BRAZO1:
+		setPWM0A(calculate_PWM0_ticks(ticks));        // Brazo1 (Timer0)
+		break;
+		case SERVO_BRAZO2:
+		setPWM1A(ticks);                              // Brazo2 (Timer1)
+		break;
+		case SERVO_PINZA:
+		setPWM1B(ticks);                              // Pinza (Timer1)
 		break;
 		default:
 		break;
 	}
+#endif
 }
 
-void saveCurrentPosition(uint8_t positionNum) {
+void refreshServoOutputs(void) {
+	// El motor de movimiento solo escribe cuando cambia el ngulo
+	for (uint8_t servo = SERVO_BASE; servo <= SERVO_PINZA; servo++) {
+		writeServoPWM(servo, MOTION_getPosition(servo));
+	}
+}
+
+uint8_t saveCurrentPosition(uint8_t positionNum) {
 	PosicionGarra posicion;
 	posicion.base = posServoBase;
 	posicion.brazo1 = posServoBrazo1;
 	posicion.brazo2 = posServoBrazo2;
 	posicion.pinza = posServoPinza;
 	
-	savePosition(positionNum, posicion);
+	return savePosition(positionNum, posicion);
 }
 
 void loadSavedPosition(uint8_t positionNum) {
@@ -583,36 +950,177 @@ void loadSavedPosition(uint8_t positionNum) {
 	updateServos();
 }
 
-void executeSequence(void) {
-	uint8_t numPosiciones = Saved_Pos_Count();
+// Fuente de cuadros de la secuencia por ranuras: RETARDO_SECUENCIA por posicin
+uint8_t readSlotKeyframe(uint8_t numero, CuadroClave* cuadro) {
+	if (numero >= Saved_Pos_Count()) return 0;
+	
+	cuadro->pose = loadPosition(numero);
+	cuadro->transicion = RETARDO_SECUENCIA / UNIDAD_TIEMPO_MS;
+	cuadro->espera = 0;
+	return 1;
+}
+
+// Fuente de cuadros de la secuencia con nombre en reproduccin. Hacia
+// adelante se sigue decodificando; una bsqueda, la vuelta al primer
+// cuadro o el sentido contrario reabren el lector en ese cuadro
+uint8_t readSequenceKeyframe(uint8_t numero, CuadroClave* cuadro) {
+	if (numero != siguienteCuadroLector &&
+	!EEPROM_openSequence(secuenciaReproduciendo, numero, &lectorReproduccion)) {
+		return 0;
+	}
+	if (!EEPROM_nextKeyframe(&lectorReproduccion, cuadro)) {
+		siguienteCuadroLector = SIN_CUADRO;
+		return 0;
+	}
+	siguienteCuadroLector = numero + 1;
+	return 1;
+}
+
+void playbackPose(const PosicionGarra* pose, uint16_t duracion) {
+	posServoBase = pose->base;
+	posServoBrazo1 = pose->brazo1;
+	posServoBrazo2 = pose->brazo2;
+	posServoPinza = pose->pinza;
 	
-	if (numPosiciones == 0 || posicionActualEEPROM >= numPosiciones) {
-		ejecutandoSecuencia = 0;
-		sendUSARTString("\r\nSecuencia completada\r\n");
+	// Los cuadros siempre se mueven coordinados, sin importar el comando M:
+	// la transicin grabada (ya escalada por la velocidad) es la duracin
+	uint8_t angulos[MOTION_NUM_EJES];
+	angulos[SERVO_BASE] = pose->base;
+	angulos[SERVO_BRAZO1] = pose->brazo1;
+	angulos[SERVO_BRAZO2] = pose->brazo2;
+	angulos[SERVO_PINZA] = pose->pinza;
+	MOTION_moveCoordinated(angulos, duracion);
+}
+
+void playbackEvent(uint8_t evento, uint8_t numero) {
+	if (evento == PLAY_EVENTO_FIN) {
+		sendUSARTString_P(PSTR("\r\nSecuencia completada\r\n"));
 		return;
 	}
 	
-	// Cargar y aplicar la posicin actual
-	loadSavedPosition(posicionActualEEPROM);
+	updatePositionLEDs(numero);
+	posicionActualEEPROM = numero + 1;
 	
-	// Actualizar LEDs para mostrar la posicin actual
-	updatePositionLEDs(posicionActualEEPROM);
+	// Las secuencias por ranuras muestran cada posicin en la terminal
+	if (secuenciaReproduciendo == SIN_SECUENCIA) {
+		char linea[FMT_MAX_LINEA];
+		uint8_t largo = FMT_text_P(linea, PSTR("\r\nEjecutando posicion "));
+		largo += FMT_unsigned(linea + largo, numero + 1);
+		largo += FMT_text_P(linea + largo, PSTR(" de "));
+		largo += FMT_unsigned(linea + largo, Saved_Pos_Count());
+		largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+		FMT_sendLine(linea, largo);
+	}
+}
+
+void processPlaybackCommand(void) {
+	char comando = bufferRx[0];
+	char* token = strtok(bufferRx, ",");
+	token = strtok(NULL, ","); // Obtener primer argumento
 	
-	// Enviar informacin a terminal
-	char mensaje[50];
-	sprintf(mensaje, "\r\nEjecutando posicion %d de %d\r\n", posicionActualEEPROM + 1, numPosiciones);
-	sendUSARTString(mensaje);
+	// P: pausar o continuar; P,n: ir al cuadro n
+	if (comando == 'P') {
+		if (PLAY_state() == PLAY_DETENIDO) {
+			sendUSARTString_P(PSTR("\r\nNo hay una reproduccion en curso\r\n"));
+			} else if (token != NULL) {
+			if (PLAY_seek(atoi(token))) {
+				char linea[FMT_MAX_LINEA];
+				uint8_t largo = FMT_text_P(linea, PSTR("\r\nCuadro "));
+				largo += FMT_unsigned(linea + largo, PLAY_currentFrame());
+				largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+				FMT_sendLine(linea, largo);
+				} else {
+				sendUSARTString_P(PSTR("\r\nCuadro fuera de la secuencia\r\n"));
+			}
+			} else if (PLAY_state() == PLAY_PAUSADO) {
+			PLAY_resume();
+			sendUSARTString_P(PSTR("\r\nReproduccion continuada\r\n"));
+			} else {
+			PLAY_pause();
+			sendUSARTString_P(PSTR("\r\nReproduccion en pausa\r\n"));
+		}
+	}
+	// F: detener
+	else if (comando == 'F') {
+		PLAY_stop();
+		sendUSARTString_P(PSTR("\r\nSecuencia detenida\r\n"));
+	}
+	// O,modo[,veces[,porcentaje]]: repeticin y velocidad (tambin para la
+	// reproduccin en curso; sin porcentaje se conserva la velocidad)
+	else if (comando == 'O') {
+		uint8_t modo = (token != NULL) ? atoi(token) : 0xFF;
+		token = strtok(NULL, ","); // Obtener veces
+		uint8_t veces = (token != NULL) ? atoi(token) : 0;
+		token = strtok(NULL, ","); // Obtener porcentaje
+		uint16_t porcentaje = (token != NULL) ? atoi(token) : PLAY_speed();
+		
+		// Validar todo antes de cambiar algo
+		if (modo <= PLAY_IDA_VUELTA && porcentaje >= PLAY_VELOCIDAD_MIN && porcentaje <= PLAY_VELOCIDAD_MAX) {
+			PLAY_setRepeat(modo, veces);
+			PLAY_setSpeed(porcentaje);
+			char linea[FMT_MAX_LINEA];
+			uint8_t largo = FMT_text_P(linea, PSTR("\r\nRepeticion actualizada, velocidad "));
+			largo += FMT_unsigned(linea + largo, PLAY_speed());
+			largo += FMT_text_P(linea + largo, PSTR("%\r\n"));
+			FMT_sendLine(linea, largo);
+			} else {
+			sendUSARTString_P(PSTR("\r\nFormato: O,modo(0 una vez, 1 bucle, 2 ida y vuelta),veces(0 sin fin),porcentaje(25-400)\r\n"));
+		}
+	}
+}
+
+// Guardar las ranuras 0..n-1 como una secuencia con nombre (reemplaza la anterior)
+uint8_t saveSlotsAsSequence(const char* nombre) {
+	uint8_t anterior = EEPROM_findSequence(nombre);
+	if (anterior != SIN_SECUENCIA) {
+		PLAY_stop();
+		EEPROM_deleteSequence(anterior);
+	}
 	
-	// Avanzar a la siguiente posicin
-	posicionActualEEPROM++;
+	if (!EEPROM_beginSequence(nombre)) {
+		return SIN_SECUENCIA;
+	}
 	
-	// Esperar un tiempo entre posiciones
-	_delay_ms(1000);
+	// Mismo ritmo que la secuencia por ranuras: RETARDO_SECUENCIA por posicin
+	for (uint8_t i = 0; i < Saved_Pos_Count(); i++) {
+		CuadroClave cuadro;
+		readSlotKeyframe(i, &cuadro);
+		if (!EEPROM_addKeyframe(&cuadro)) {
+			break;
+		}
+	}
 	
-	// Si hemos llegado al final, detener la secuencia
-	if (posicionActualEEPROM >= numPosiciones) {
-		ejecutandoSecuencia = 0;
-		sendUSARTString("\r\nSecuencia completada\r\n");
+	uint8_t indice = EEPROM_endSequence();
+	
+	// Al faltar espacio EEPROM_beginSequence compacta el rea y mueve las
+	// secuencias: el lector de la reproduccin en curso se reabre
+	siguienteCuadroLector = SIN_CUADRO;
+	return indice;
+}
+
+void listSequences(void) {
+	char linea[FMT_MAX_LINEA];
+	
+	uint8_t largo = FMT_text_P(linea, PSTR("\r\nSecuencias: "));
+	largo += FMT_unsigned(linea + largo, EEPROM_sequenceCount());
+	largo += FMT_text_P(linea + largo, PSTR(" (libres: "));
+	largo += FMT_unsigned(linea + largo, EEPROM_freeBytes());
+	largo += FMT_text_P(linea + largo, PSTR(" bytes)\r\n"));
+	FMT_sendLine(linea, largo);
+	for (uint8_t i = 0; i < EEPROM_sequenceCount(); i++) {
+		// El nombre va directo al inicio de la lnea
+		EEPROM_getSequenceName(i, linea);
+		largo = strlen(linea);
+		largo += FMT_text_P(linea + largo, PSTR(": "));
+		largo += FMT_unsigned(linea + largo, EEPROM_sequenceLength(i));
+		largo += FMT_text_P(linea + largo, PSTR(" cuadros\r\n"));
+		FMT_sendLine(linea, largo);
+	}
+	if (EEPROM_sequenceErrors() > 0) {
+		largo = FMT_text_P(linea, PSTR("Secuencias descartadas (CRC o sin espacio): "));
+		largo += FMT_unsigned(linea + largo, EEPROM_sequenceErrors());
+		largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+		FMT_sendLine(linea, largo);
 	}
 }
 
@@ -622,7 +1130,7 @@ void playNextPosition(void) {
 	
 	// Verificar si hay posiciones guardadas
 	if (numPosiciones == 0) {
-		sendUSARTString("\r\nNo hay posiciones guardadas para reproducir\r\n");
+		sendUSARTString_P(PSTR("\r\nNo hay posiciones guardadas para reproducir\r\n"));
 		return;
 	}
 	
@@ -638,9 +1146,13 @@ void playNextPosition(void) {
 	updatePositionLEDs(posicionActualEEPROM);
 	
 	// Enviar informacin a terminal
-	char mensaje[50];
-	sprintf(mensaje, "\r\n[BOTON REPROD] Reproduciendo posicion %d de %d\r\n", posicionActualEEPROM + 1, numPosiciones);
-	sendUSARTString(mensaje);
+	char linea[FMT_MAX_LINEA];
+	uint8_t largo = FMT_text_P(linea, PSTR("\r\n[BOTON REPROD] Reproduciendo posicion "));
+	largo += FMT_unsigned(linea + largo, posicionActualEEPROM + 1);
+	largo += FMT_text_P(linea + largo, PSTR(" de "));
+	largo += FMT_unsigned(linea + largo, numPosiciones);
+	largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+	FMT_sendLine(linea, largo);
 	
 	// Avanzar a la siguiente posicin para la prxima vez
 	posicionActualEEPROM++;
@@ -650,33 +1162,253 @@ void playNextPosition(void) {
 void saveNextPosition(void) {
 	// Verificar si hay espacio disponible
 	if (posicionSiguienteGuardado >= MAX_POSICIONES_GUARDADAS) {
-		sendUSARTString("\r\n[BOTON GUARD] Error: Memoria EEPROM llena\r\n");
+		sendUSARTString_P(PSTR("\r\n[BOTON GUARD] Error: Memoria EEPROM llena\r\n"));
 		return;
 	}
 	
 	// Guardar la posicin actual en la siguiente ranura disponible
-	saveCurrentPosition(posicionSiguienteGuardado);
+	if (!saveCurrentPosition(posicionSiguienteGuardado)) {
+		MSG_send(MSG_EEPROM_INVALIDA);
+		return;
+	}
 	
 	// Enviar informacin a terminal
-	char mensaje[50];
-	sprintf(mensaje, "\r\n[BOTON GUARD] Posicion guardada en la ranura %d\r\n", posicionSiguienteGuardado);
-	sendUSARTString(mensaje);
+	char linea[FMT_MAX_LINEA];
+	uint8_t largo = FMT_text_P(linea, PSTR("\r\n[BOTON GUARD] Posicion guardada en la ranura "));
+	largo += FMT_unsigned(linea + largo, posicionSiguienteGuardado);
+	largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+	FMT_sendLine(linea, largo);
 	
 	// Incrementar el contador para la prxima vez
 	posicionSiguienteGuardado++;
 }
 
-void sendAdafruitData(void) {
-	// Crear y enviar una cadena con los valores actuales para que se puedan recibir desde Python
-	char mensaje[50];
-	sprintf(mensaje, "P,%d,%d,%d,%d\r\n", posServoBase, posServoBrazo1, posServoBrazo2, posServoPinza);
-	sendUSARTString(mensaje);
+// Reproducir en orden todas las posiciones guardadas
+void startSlotSequence(void) {
+	if (Saved_Pos_Count() > 0) {
+		secuenciaReproduciendo = SIN_SECUENCIA;
+		sendUSARTString_P(PSTR("\r\nEjecutando secuencia de posiciones guardadas\r\n"));
+		PLAY_start(readSlotKeyframe, Saved_Pos_Count());
+		} else {
+		sendUSARTString_P(PSTR("\r\nNo hay posiciones guardadas para ejecutar\r\n"));
+	}
+}
+
+// Borrar todas las posiciones guardadas
+void clearSavedPositions(void) {
+	clearAllPositions();
+	posicionSiguienteGuardado = 0;  // Reiniciar el contador de posicin siguiente
+	sendUSARTString_P(PSTR("\r\nTodas las posiciones han sido borradas\r\n"));
+	// Apagar los LEDs de posicin
+	PORTC &= ~((1 << LED_POS_BIT0) | (1 << LED_POS_BIT1));
+}
+
+void processCartesianCommand(void) {
+	// Extraer x, y, z (mm, con signo) y la pinza (ngulo)
+	int16_t valores[4];
+	char* token = strtok(bufferRx, ",");
+	for (uint8_t i = 0; i < 4; i++) {
+		token = strtok(NULL, ",");
+		if (token == NULL) {
+			sendUSARTString_P(PSTR("\r\nFormato: X,x,y,z,pinza\r\n"));
+			return;
+		}
+		valores[i] = atoi(token);
+	}
+	
+	// Resolver y validar antes de mover cualquier servo
+	AngulosArticulacion angulos;
+	uint8_t resultado = KIN_solve(valores[0], valores[1], valores[2], &angulos);
+	if (resultado == KIN_FUERA_ALCANCE) {
+		sendUSARTString_P(PSTR("\r\nPunto fuera del alcance del brazo\r\n"));
+		return;
+		} else if (resultado == KIN_DETRAS) {
+		sendUSARTString_P(PSTR("\r\nPunto detras de la base (y debe ser >= 0)\r\n"));
+		return;
+		} else if (resultado != KIN_OK) {
+		sendUSARTString_P(PSTR("\r\nPunto fuera del rango de los servos\r\n"));
+		return;
+	}
+	if (valores[3] < 0 || valores[3] > 180) {
+		sendUSARTString_P(PSTR("\r\nPinza fuera de rango (0-180)\r\n"));
+		return;
+	}
+	
+	posServoBase = angulos.base;
+	posServoBrazo1 = angulos.brazo1;
+	posServoBrazo2 = angulos.brazo2;
+	posServoPinza = (uint8_t)valores[3];
+	updateServos();
+	
+	char linea[FMT_MAX_LINEA];
+	uint8_t largo = FMT_text_P(linea, PSTR("\r\nAngulos: "));
+	largo += FMT_unsigned(linea + largo, angulos.base);
+	linea[largo++] = ',';
+	largo += FMT_unsigned(linea + largo, angulos.brazo1);
+	linea[largo++] = ',';
+	largo += FMT_unsigned(linea + largo, angulos.brazo2);
+	largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+	FMT_sendLine(linea, largo);
+}
+
+// Estado que la telemetra no puede leer por su cuenta
+void fillTelemetry(EstadoTelemetria* estado) {
+	estado->angulos[SERVO_BASE] = posServoBase;
+	estado->angulos[SERVO_BRAZO1] = posServoBrazo1;
+	estado->angulos[SERVO_BRAZO2] = posServoBrazo2;
+	estado->angulos[SERVO_PINZA] = posServoPinza;
+	estado->modo = modoOperacion;
+}
+
+void processTelemetryCommand(void) {
+	// Formato: T,periodo[,campos[,formato]] (campos por defecto todos, formato texto)
+	char* token = strtok(bufferRx, ",");
+	token = strtok(NULL, ","); // Obtener periodo (ms)
+	if (token == NULL) return;
+	
+	uint16_t periodo = atoi(token);
+	uint8_t campos = TELEM_TODOS;
+	uint8_t formato = TELEM_TEXTO;
+	token = strtok(NULL, ","); // Obtener campos
+	if (token != NULL) {
+		campos = atoi(token);
+		token = strtok(NULL, ","); // Obtener formato
+		if (token != NULL) {
+			formato = atoi(token);
+		}
+	}
+	
+	if (periodo == 0) {
+		TELEM_stop();
+		char linea[FMT_MAX_LINEA];
+		uint8_t largo = FMT_text_P(linea, PSTR("\r\nTelemetria detenida (muestras descartadas: "));
+		largo += FMT_unsigned(linea + largo, TELEM_dropped());
+		largo += FMT_text_P(linea + largo, PSTR(")\r\n"));
+		FMT_sendLine(linea, largo);
+		} else if (TELEM_start(periodo, campos, formato)) {
+		sendUSARTString_P(PSTR("\r\nTelemetria activa\r\n"));
+		} else {
+		sendUSARTString_P(PSTR("\r\nTelemetria: T,periodo(>=10 ms),campos(1-31),formato(0 texto, 1 binario)\r\n"));
+		sendUSARTString_P(PSTR("Campos: 1 angulos, 2 ADC, 4 modo, 8 lazo (us), 16 buffer TX\r\n"));
+	}
+}
+
+void processCoordinatedCommand(void) {
+	// Formato: M,modo[,duracion] (0 independiente, 1 coordinado; duracin en ms, 0 automtica)
+	char* token = strtok(bufferRx, ",");
+	token = strtok(NULL, ","); // Obtener modo
+	if (token == NULL || (token[0] != '0' && token[0] != '1')) {
+		sendUSARTString_P(PSTR("\r\nFormato: M,modo(0 independiente, 1 coordinado),duracion(ms, 0 automatica)\r\n"));
+		return;
+	}
+	
+	movimientoCoordinado = token[0] - '0';
+	token = strtok(NULL, ","); // Obtener duracin
+	duracionCoordinada = (token != NULL) ? (uint16_t)atol(token) : 0;
+	
+	if (!movimientoCoordinado) {
+		sendUSARTString_P(PSTR("\r\nMovimiento independiente por eje\r\n"));
+		} else if (duracionCoordinada == 0) {
+		sendUSARTString_P(PSTR("\r\nMovimiento coordinado (duracion automatica)\r\n"));
+		} else {
+		char linea[FMT_MAX_LINEA];
+		uint8_t largo = FMT_text_P(linea, PSTR("\r\nMovimiento coordinado en "));
+		largo += FMT_unsigned(linea + largo, duracionCoordinada);
+		largo += FMT_text_P(linea + largo, PSTR(" ms\r\n"));
+		FMT_sendLine(linea, largo);
+	}
+}
+
+void processCalibrationCommand(void) {
+	// CAL: mostrar; CAL,G: guardar; CAL,D: valores por defecto;
+	// CAL,n,min,max,centro,inv,inf,sup: editar un canal (los campos omitidos no cambian)
+	if (bufferRx[3] == ',' && bufferRx[5] == '\0' && (bufferRx[4] == 'G' || bufferRx[4] == 'D')) {
+		if (bufferRx[4] == 'G') {
+			if (CAL_save()) {
+				sendUSARTString_P(PSTR("\r\nCalibracion guardada en EEPROM\r\n"));
+				} else {
+				MSG_send(MSG_EEPROM_INVALIDA);
+			}
+			} else {
+			CAL_restoreDefaults();
+			refreshServoOutputs();
+			sendUSARTString_P(PSTR("\r\nCalibracion por defecto (CAL,G para guardarla)\r\n"));
+		}
+		return;
+	}
+	
+	if (bufferRx[3] == ',') {
+		char* token = strtok(bufferRx, ",");
+		token = strtok(NULL, ","); // Obtener canal
+		uint8_t canal = (token != NULL) ? atoi(token) : CAL_NUM_CANALES;
+		if (canal >= CAL_NUM_CANALES) {
+			sendUSARTString_P(PSTR("\r\nCanal no valido (0 base, 1 brazo1, 2 brazo2, 3 pinza)\r\n"));
+			return;
+		}
+		
+		CalibracionServo cal;
+		CAL_get(canal, &cal);
+		int16_t valores[6] = { cal.pulsoMin, cal.pulsoMax, cal.centro, cal.invertido, cal.limiteInf, cal.limiteSup };
+		for (uint8_t i = 0; i < 6; i++) {
+			token = strtok(NULL, ",");
+			if (token == NULL) break;
+			valores[i] = atoi(token);
+		}
+		
+		// Fuera de rango para su tipo: CAL_set lo rechaza
+		cal.pulsoMin = (valores[0] < 0) ? 0 : valores[0];
+		cal.pulsoMax = (valores[1] < 0) ? 0 : valores[1];
+		cal.centro = (valores[2] < -128 || valores[2] > 127) ? 0 : (int8_t)valores[2];
+		cal.invertido = (valores[3] < 0 || valores[3] > 1) ? 0xFF : valores[3];
+		cal.limiteInf = (valores[4] < 0 || valores[4] > 180) ? 0xFF : valores[4];
+		cal.limiteSup = (valores[5] < 0 || valores[5] > 180) ? 0xFF : valores[5];
+		if (valores[2] < -128 || valores[2] > 127 || !CAL_set(canal, &cal)) {
+			sendUSARTString_P(PSTR("\r\nCalibracion no valida: min<max (us), centro -128..127, inv 0/1, inf<=sup<=180\r\n"));
+			return;
+		}
+		refreshServoOutputs();
+	}
+	
+	// Mostrar la calibracin activa
+	sendUSARTString_P(PSTR("\r\nCanal: min max centro inv inf sup (us, grados)\r\n"));
+	for (uint8_t canal = 0; canal < CAL_NUM_CANALES; canal++) {
+		CalibracionServo cal;
+		CAL_get(canal, &cal);
+		char linea[FMT_MAX_LINEA];
+		uint8_t largo = FMT_unsigned(linea, canal);
+		largo += FMT_text_P(linea + largo, PSTR(": "));
+		largo += FMT_unsigned(linea + largo, cal.pulsoMin);
+		linea[largo++] = ' ';
+		largo += FMT_unsigned(linea + largo, cal.pulsoMax);
+		linea[largo++] = ' ';
+		largo += FMT_signed(linea + largo, cal.centro);
+		linea[largo++] = ' ';
+		largo += FMT_unsigned(linea + largo, cal.invertido);
+		linea[largo++] = ' ';
+		largo += FMT_unsigned(linea + largo, cal.limiteInf);
+		linea[largo++] = ' ';
+		largo += FMT_unsigned(linea + largo, cal.limiteSup);
+		largo += FMT_text_P(linea + largo, PSTR("\r\n"));
+		FMT_sendLine(linea, largo);
+	}
+	if (CAL_isStored()) {
+		sendUSARTString_P(PSTR("(guardada en EEPROM)\r\n"));
+		} else {
+		sendUSARTString_P(PSTR("(sin guardar: CAL,G)\r\n"));
+	}
 }
 
 // INTERRUPCIONES
 ISR(USART_RX_vect) {
+	BENCH_BEGIN(BENCH_ISR_RX);
 	char datoRx = UDR0;
 	
+	// Los bytes de una trama binaria van al protocolo binario
+	if (PROTO_rxByte((uint8_t)datoRx)) {
+		BENCH_END(BENCH_ISR_RX);
+		return;
+	}
+	
 	// Si es un enter, marcar como comando completo
 	if (datoRx == '\r' || datoRx == '\n') {
 		if (indiceBuffer > 0) {
@@ -685,8 +1417,10 @@ ISR(USART_RX_vect) {
 		}
 	}
 	// Si no, agregar al buffer
-	else if (indiceBuffer < 19) {
+	else if (indiceBuffer < TAMANO_BUFFER_RX - 1) {
 		bufferRx[indiceBuffer++] = datoRx;
-		sendUSARTData(datoRx); // Echo
+		sendUSARTData(datoRx); // Echo (se encola, no espera al transmisor)
 	}
+	
+	BENCH_END(BENCH_ISR_RX);
 }
\ No newline at end of file